@@ -0,0 +1,78 @@
+#ifndef AGGREGATOR_H
+#define AGGREGATOR_H
+
+#include <vector>
+#include <array>
+#include <string>
+#include <istream>
+#include <ostream>
+
+#include "Statistics.hpp"
+#include "Strategies.hpp"
+
+/*Quantiles of the per-generation metrics across replicates*/
+#define AGGREGATE_QUANTILES {0.1, 0.5, 0.9}
+#define AGGREGATE_QUANTILE_COUNT 3
+
+
+/*Cross-replicate statistics of one generation*/
+struct GenerationAggregate
+{
+	RunningStats intelligence; //mean inner nodes of the population
+	RunningStats fitness; //mean fitness of the population
+	RunningStats cooperation; //cooperation frequency
+	RunningStats selection; //selection for intelligence: cov(intelligence, fitness) / mean fitness
+	std::vector<P2Quantile> intelligence_quantiles;
+	std::vector<P2Quantile> cooperation_quantiles;
+	std::vector<RunningStats> strategies; //strategy counts, tit for two tats pooled with tit for tat (as in out/analyse.m)
+	
+	GenerationAggregate();
+};
+
+/*
+Computes the statistics of out/analyse.m over any number of replicates in a single pass, without
+keeping their outputs: per-generation means, variances and quantiles across replicates, selection
+for intelligence (covariance between intelligence and fitness over mean fitness), pooled strategy
+counts, and the overall correlation between mean intelligence and cooperation.
+Replicates are either fed directly by the simulation (see addPopulation, addCooperation and
+addStrategies) or read from the text output of 'Cooperation run' (see readOutput).*/
+class Aggregator
+{
+	private:
+		std::vector<GenerationAggregate> generations; //indexed by generation
+		RunningCovariance intelligence_cooperation; //over all generations of all replicates
+		RunningStats overall_intelligence;
+		RunningStats overall_cooperation;
+		std::vector<double> replicate_intelligence; //mean intelligence per generation of the current replicate
+		unsigned long replicates = 0;
+		int pooled_strategy_count = 0; //columns of the pooled strategy counts
+		
+		GenerationAggregate& generation(std::size_t index); //grows the table as needed
+		
+		//reads the rows of an octave matrix of the output and feeds them to the aggregator
+		void readMatrix(std::istream& input, const std::string& name, std::size_t rows, std::size_t columns,
+			std::vector<double>& intelligence_rows);
+	
+	public:
+		void beginReplicate(); //starts a new replicate
+		
+		//adds the population of a generation of the current replicate
+		void addPopulation(std::size_t generation_index, const int* intelligence, const double* fitness, int population_size);
+		//adds the cooperation frequency of a generation of the current replicate (after its population)
+		void addCooperation(std::size_t generation_index, double cooperation_frequency);
+		//adds the (unpooled) strategy counts of a generation of the current replicate (in registry order)
+		void addStrategies(std::size_t generation_index, const int* strategies_count, int strategy_count);
+		
+		//reads one replicate from the output of a simulation (throws std::runtime_error if malformed)
+		void readOutput(std::istream& input);
+		void readFile(const std::string& file_name);
+		
+		unsigned long getReplicates() const;
+		std::size_t getGenerations() const;
+		const GenerationAggregate& getGeneration(std::size_t index) const;
+		double getIntelligenceCooperationCorrelation() const; //pearson correlation over all generations
+		
+		void write(std::ostream& output) const; //writes the summary as octave variables
+};
+
+#endif // AGGREGATOR_H
@@ -0,0 +1,19 @@
+#ifndef AGGREGATOR_TEST_H
+#define AGGREGATOR_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include "Simulation.hpp"
+#include "Aggregator.hpp"
+#include "Rng.hpp"
+
+#define AGGREGATOR_TEST_GENERATIONS 5
+#define AGGREGATOR_TEST_REPLICATES 3
+
+void testAggregator();
+
+#endif //AGGREGATOR_TEST_H
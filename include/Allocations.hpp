@@ -0,0 +1,32 @@
+#ifndef ALLOCATIONS_H
+#define ALLOCATIONS_H
+
+#include <cstdint>
+
+#define ALLOCATION_HEADER_SIZE 16 //bytes stored before each counted block (keeps the default alignment)
+
+/*Heap usage counted since the start of the program*/
+struct AllocationStats
+{
+	std::uint64_t allocations = 0; //number of allocations
+	std::uint64_t bytes = 0; //total bytes allocated
+	std::int64_t live_bytes = 0; //bytes currently allocated
+	std::int64_t peak_live_bytes = 0; //largest live_bytes since the last resetPeak
+};
+
+/*
+Counts the allocations of the whole program by replacing the global operator new and delete.
+The replacement is only compiled with COUNT_ALLOCATIONS ("make allocations", which links
+bin/Cooperation-allocations), so other builds and programs linking the library keep the standard
+allocator; counting then starts once enabled at run time. Each counted block stores its size in a header, so that freed bytes are known without sized
+deallocation. Counters are shared by every thread.*/
+class AllocationCounter
+{
+	public:
+		static bool isCompiled(); //true if the allocator is replaced (COUNT_ALLOCATIONS)
+		static void enable(); //starts counting (no effect if not compiled)
+		static AllocationStats read(); //current counters
+		static void resetPeak(); //sets the peak to the current live bytes
+};
+
+#endif // ALLOCATIONS_H
@@ -0,0 +1,61 @@
+#ifndef ASSESSMENTPIPELINE_H
+#define ASSESSMENTPIPELINE_H
+
+#include <array>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "NeuralNetwork.hpp"
+#include "Rng.hpp"
+#include "Strategies.hpp"
+
+#define PIPELINE_QUEUE_CAPACITY 4
+
+/*A finished generation waiting to be classified*/
+template<typename Network>
+struct AssessmentJob
+{
+	unsigned long generation = 0; //generation index, also used as the RNG stream
+	std::vector<Network*> population; //networks of the generation (owned by the job)
+	StrategyCounts* strategies = nullptr; //where to write the strategy counts
+};
+
+/*
+Classifies finished generations on background threads while the simulation plays the next ones.
+Generations are handed over with their networks, which are deleted once classified. The queue is bounded,
+so the simulation waits if the workers fall behind. Each generation is classified with its own RNG stream
+and writes to its own output row, so results do not depend on the number of workers or their timing.*/
+template<typename Network>
+class AssessmentPipeline
+{
+	private:
+		const Strategies& strats; //pure strategy evaluator (shared by all workers)
+		
+		std::deque<AssessmentJob<Network>> jobs; //generations waiting to be classified
+		std::vector<std::thread> workers;
+		unsigned long active_jobs = 0; //jobs being classified right now
+		long latest_generation = -1; //most recent generation fully classified
+		bool closing = false; //no more jobs will be pushed
+		
+		std::mutex jobs_mutex;
+		std::condition_variable jobs_available; //signals workers a job was pushed or closing
+		std::condition_variable jobs_changed; //signals the simulation a job was popped or finished
+		
+		void work(); //worker thread loop
+		void assess(AssessmentJob<Network>& job); //classifies one generation
+	
+	public:
+		AssessmentPipeline(const Strategies& strategies, unsigned worker_count);
+		AssessmentPipeline(const AssessmentPipeline&) = delete;
+		AssessmentPipeline& operator=(const AssessmentPipeline&) = delete;
+		~AssessmentPipeline(); //finishes all jobs and stops the workers
+		
+		void push(AssessmentJob<Network>&& job); //queues a generation, waits if the queue is full
+		void finish(); //waits until all queued generations are classified
+		long latestAssessedGeneration(); //most recent classified generation (-1 if none)
+};
+
+#endif // ASSESSMENTPIPELINE_H
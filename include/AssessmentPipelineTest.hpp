@@ -0,0 +1,16 @@
+#ifndef ASSESSMENTPIPELINE_TEST_H
+#define ASSESSMENTPIPELINE_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "AssessmentPipeline.hpp"
+#include "Payoffs.hpp"
+
+#define PIPELINE_TEST_WORKERS 3
+#define PIPELINE_TEST_GENERATIONS 10
+#define PIPELINE_TEST_POPULATION 20
+
+void testAssessmentPipeline();
+
+#endif //ASSESSMENTPIPELINE_TEST_H
@@ -0,0 +1,55 @@
+#ifndef AUTOTUNER_H
+#define AUTOTUNER_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <ostream>
+
+#define AUTOTUNE_ROUNDS 2 //generations timed with each candidate (the fastest round counts)
+#define AUTOTUNE_CACHE_FILE ".coop-autotune" //file of the home directory caching the choices
+
+/*
+Chooses the fastest of several candidate values of a setting that does not change the results (such
+as the number of tournament threads), by timing the first generations of a run with each candidate
+in turn. Candidates are interleaved so that each one is timed on populations of the same age, and
+the fastest round of each candidate is compared to leave out interruptions. The choice is cached in
+a text file, one "host/configuration value" line per key (the last one counts), so that later runs
+with the same key on the same host skip the timing.*/
+class Autotuner
+{
+	private:
+		std::string cache_file; //file caching the choices (empty disables the cache)
+		std::string key; //host name and configuration
+		std::vector<unsigned> candidates;
+		std::vector<double> best_seconds; //fastest round of each candidate
+		unsigned timed_rounds = 0; //rounds timed so far (all candidates)
+		unsigned choice = 0; //chosen candidate once tuned
+		bool tuned = false; //the choice is known
+		bool cached = false; //the choice was read from the cache
+		std::chrono::steady_clock::time_point round_start;
+		
+		bool readCache(); //looks the key up in the cache file
+		void writeCache() const; //appends the choice to the cache file (ignores errors, the cache is optional)
+	
+	public:
+		//looks the configuration up in the cache of this host, or prepares the timing of the candidates
+		Autotuner(const std::string& configuration, const std::vector<unsigned>& candidate_values, 
+			const std::string& cache_file_name);
+		
+		unsigned begin(); //returns the candidate of the next round (the choice once tuned), and starts timing it
+		void end(); //records the round started by begin()
+		void record(double seconds); //records the time of the current round, chooses once every round is timed
+		
+		bool isTuned() const;
+		bool isCached() const;
+		unsigned getChoice() const; //the chosen candidate (only valid once tuned)
+		
+		void write(std::ostream& output) const; //writes the choice and the timings as comments
+		
+		static std::string hostName();
+		static std::string defaultCacheFile(); //AUTOTUNE_CACHE_FILE in $HOME (in the working directory without HOME)
+		static std::vector<unsigned> threadCandidates(unsigned max_threads); //powers of two up to max_threads, and max_threads
+};
+
+#endif // AUTOTUNER_H
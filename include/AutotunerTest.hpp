@@ -0,0 +1,18 @@
+#ifndef AUTOTUNER_TEST_H
+#define AUTOTUNER_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Autotuner.hpp"
+
+#define AUTOTUNER_TEST_CACHE_FILE "/tmp/coop-autotune-test.cache"
+
+void testAutotuner();
+
+#endif //AUTOTUNER_TEST_H
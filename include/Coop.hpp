@@ -0,0 +1,33 @@
+#ifndef COOP_H
+#define COOP_H
+
+/*
+Public header of the coop library (bin/libcoop.a and bin/libcoop.so, built with "make lib"), which
+contains the simulation engine without the command line interface.
+A driver seeds the RNG, creates a simulation and either runs it or steps it generation by generation:
+
+	RNG::setSeed(seed);
+	const Payoffs payoffs = Payoffs::getPayoffsForGameType("IPD"); //must outlive the simulation
+	Simulation simulation(payoffs, settings);
+	simulation.setGenerationCallback([](const GenerationView<NeuralNetwork>& view) { ... });
+	simulation.start(generations);
+	while (simulation.getGeneration() < generations) simulation.step();
+	simulation.finish();
+
+The callback receives views of the simulation's own arrays and genomes, which are only valid during
+the call. The history of every generation remains available from the simulation's getters.
+Collectors added before start (see Metrics.hpp) record only the metrics a driver needs, and replace the
+classic outputs of outputResults.*/
+
+#define COOP_VERSION_MAJOR 1
+#define COOP_VERSION_MINOR 0
+
+#include "Rng.hpp"
+#include "Payoffs.hpp"
+#include "NeuralNetwork.hpp"
+#include "DenseNetwork.hpp"
+#include "Simulation.hpp"
+#include "Aggregator.hpp"
+#include "GenomeArchive.hpp"
+
+#endif // COOP_H
@@ -0,0 +1,81 @@
+#ifndef CROSSEVALUATION_H
+#define CROSSEVALUATION_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <iostream>
+#include <stdexcept>
+
+#include "NeuralNetwork.hpp"
+#include "DenseNetwork.hpp"
+#include "Payoffs.hpp"
+#include "GenomeArchive.hpp"
+#include "Simulation.hpp"
+
+#define CROSS_FIRST_STREAM (1ULL << 48) //RNG streams of the evaluation's blocks (after the tournaments')
+#define CROSS_BLOCK_MATCHES 64 //matches played on the same RNG stream
+
+
+/*Pairs of individuals played by an evaluation*/
+struct PairingPlan
+{
+	unsigned sampled_pairs = 0; //random pairs per pair of sets (0 plays every pair)
+	unsigned matches = 1; //matches played by each pair
+	bool across_sets_only = false; //sets do not play against themselves
+};
+
+/*
+Tournaments between sets of genomes that never met in a simulation, such as archived generations
+(ancestors against descendants). Every pair of sets, including a set with itself, plays the pairs
+of the plan, with the same match semantics as the simulation's tournament (see playMatch) from new
+states. Matches are played on threads in blocks, each block on its own RNG stream, and pairs are
+drawn in order beforehand, so the results only depend on the seed and not on the number of threads.*/
+template<typename Network>
+class CrossEvaluation
+{
+	private:
+		struct Pairing
+		{
+			std::size_t set_a, set_b;
+			unsigned index_a, index_b;
+		};
+		
+		const Payoffs game_payoffs;
+		const unsigned thread_count;
+		std::vector<std::string> set_names;
+		std::vector<std::vector<std::unique_ptr<Network>>> sets;
+		
+		//payoff sums and game iterations of each individual of set a against each of set b,
+		//indexed by set_a*set_count + set_b, then by index_a*size_b + index_b
+		std::vector<std::vector<double>> payoff_sums;
+		std::vector<std::vector<double>> game_counts;
+		unsigned long evaluation_count = 0; //evaluations played, each on its own RNG streams
+		
+		std::vector<Pairing> drawPairings(const PairingPlan& plan) const; //pairs of the plan, in order
+		std::vector<double>& pairMatrix(std::vector<std::vector<double>>& matrices, std::size_t set_a, std::size_t set_b);
+	
+	public:
+		CrossEvaluation(const Payoffs& payoffs, unsigned threads = 1);
+		
+		//adds a set of individuals (the evaluation owns them), returns its index
+		std::size_t addSet(const std::string& name, std::vector<std::unique_ptr<Network>> individuals);
+		//adds the individuals of an archived generation, named "generation <g>" (throws if not archived)
+		std::size_t addArchivedGeneration(const GenomeArchiveReader& reader, unsigned long generation);
+		
+		void evaluate(const PairingPlan& plan); //plays the pairs of the plan, adding to the previous results
+		
+		std::size_t getSetCount() const;
+		const std::string& getSetName(std::size_t set) const;
+		
+		//mean payoff per game iteration of each individual of set a against each of set b (NaN if they never met)
+		std::vector<std::vector<double>> getPayoffs(std::size_t set_a, std::size_t set_b) const;
+		//mean payoff per game iteration of each individual of set a against the whole set b (NaN if it never met it)
+		std::vector<double> getIndividualPayoffs(std::size_t set_a, std::size_t set_b) const;
+		//mean payoff per game iteration of set a's individuals against set b's (NaN if they never met)
+		double getSetPayoff(std::size_t set_a, std::size_t set_b) const;
+		
+		void write(std::ostream& output) const; //writes the set and individual payoff matrices in the octave format
+};
+
+#endif // CROSSEVALUATION_H
@@ -0,0 +1,26 @@
+#ifndef CROSSEVALUATION_TEST_H
+#define CROSSEVALUATION_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <thread>
+
+#include "CrossEvaluation.hpp"
+#include "GenomeArchive.hpp"
+#include "Payoffs.hpp"
+#include "Rng.hpp"
+
+#define CROSSEVALUATION_TEST_FILE "/tmp/coop-cross-test.bin"
+#define CROSSEVALUATION_TEST_POPULATION 12
+#define CROSSEVALUATION_TEST_SAMPLES 7
+#define CROSSEVALUATION_TEST_THREADS 3
+#define CROSSEVALUATION_TEST_SEED 11
+
+void testCrossEvaluation();
+
+#endif //CROSSEVALUATION_TEST_H
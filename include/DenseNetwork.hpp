@@ -0,0 +1,139 @@
+#ifndef DENSENETWORK_H
+#define DENSENETWORK_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cassert>
+
+#include "NeuralNetwork.hpp"
+#include "Rng.hpp"
+#include "Payoffs.hpp"
+
+#define DENSE_MAX_NODES 512 //maximum number of cognitive nodes (and of context nodes)
+#define DENSE_INPUT_COUNT 2 //inputs of each cognitive node: own payoff, opponent's payoff
+#define DENSE_BLOCK_ROWS 8 //evaluations per kernel block
+#define DENSE_BLOCK_NODES 128 //cognitive nodes per kernel block
+#define DENSE_GENOME_HEADER_SIZE 8 //default choice, padding, cognitive and context node counts (16 bits), padding
+
+
+/*
+Neural network for large hidden layers (up to DENSE_MAX_NODES cognitive nodes), with the same
+structure, mutation and state semantics as NeuralNetwork: each cognitive node has its input weights,
+a threshold, an output weight and optionally a context node, whose value belongs to the state.
+Values are floats stored in contiguous arrays (the input weights as a nodes x inputs matrix), so that
+many evaluations of the network (for instance the same iteration of all its matches) are computed
+at once by evaluateBatch, a cache-blocked product of the inputs by the weight matrix with the
+squashing and the output layer fused in.*/
+class DenseNetwork
+{
+	private:
+		///Neural network structure
+		bool cooperate_by_default; //used for decision-making in first round
+		float output_node_threshold; //same use as inner nodes thresholds
+		int context_node_count = 0;
+		
+		///Cognitive nodes (one entry per node, input weights are DENSE_INPUT_COUNT entries per node)
+		std::vector<float> input_weights; //from self payoff and other payoff to nodes
+		std::vector<float> thresholds; //thresholds of the cognitive nodes
+		std::vector<float> output_weights; //from nodes to output
+		std::vector<float> context_weights; //from context nodes to cognitive nodes
+		std::vector<unsigned char> has_context; //does the node have a context node
+		
+		BasicNetworkState<float> carryover_state; //memory shared by evaluations without an explicit state
+		
+		static int initial_node_count; //cognitive nodes of new networks (-1 for the NeuralNetwork distribution)
+		
+		int getRandomCognitiveNode(bool with_context) const;
+		void addCognitiveNode(float threshold); //appends a node with random weights
+	
+	public:
+		typedef float value_type; //precision of network values
+		typedef BasicNetworkState<float> State; //runtime state of the network
+		static const char* precisionName(); //name of the network type, for output
+		
+		//number of cognitive nodes of new networks (-1 restores the NeuralNetwork distribution)
+		static void setInitialNodeCount(int node_count);
+		
+		///Constructors
+		DenseNetwork(); //random structure
+		DenseNetwork(const DenseNetwork&); //copy (context values are not inherited)
+		DenseNetwork(DenseNetwork&&) = default;
+		explicit DenseNetwork(const char* genome); //from a genome written by writeGenome
+		DenseNetwork& operator=(const DenseNetwork&); //copy, reusing storage (context values are not inherited)
+		DenseNetwork& operator=(DenseNetwork&&) = delete;
+		
+		///Structure
+		void addNode(); //adds a node to the structure if possible
+		void addContextNode(); //adds a context node to the structure (place must be available)
+		void addCognitiveNode(); //adds a cognitive node to the structure (place must be available)
+		void removeNode(); //removes a node from the structure if possible
+		void removeContextNode();
+		void removeCognitiveNode();
+		
+		int getInnerNodeCount() const;
+		int getCognitiveNodeCount() const;
+		int getContextNodeCount() const;
+		
+		///Mutation
+		MutationRecord mutate(); //same probabilities and order as NeuralNetwork::mutate
+		int getParameterCount(int parameter_class) const; //number of parameters of a class (see PARAMETER_* macros)
+		int mutateParameter(int parameter_class, int index); //mutates one parameter, returns the change in inner nodes
+		
+		///Decisions
+		//cooperation probabilities of batch evaluations, each with its own inputs (batch x DENSE_INPUT_COUNT)
+		//and context values (batch x cognitive nodes, updated)
+		void evaluateBatch(const float* inputs, float* contexts, int batch, float* probabilities) const;
+		
+		State createState() const; //new state with the network's current context values
+		State& getCarryoverState(); //state used by evaluations without an explicit state
+		
+		float getCooperationProbability(payoff self_payoff, payoff other_payoff, State& state) const; //updates the state
+		bool decide(payoff self_payoff, payoff other_payoff, State& state) const; //cooperate or defect, with the given state
+		
+		float getCooperationProbability(payoff self_payoff, payoff other_payoff); //updates the carryover state
+		bool operator()(payoff self_payoff, payoff other_payoff); //decide whether to cooperate or defect
+		bool operator()() const; //default decision (without input)
+		
+		///Identity and serialization
+		std::uint64_t hash() const;
+		void writeFlatParameters(float* values, float* structure, int node_slots) const; //see NeuralNetwork
+		std::size_t getGenomeSize() const;
+		void writeGenome(char* genome) const;
+		static std::size_t readGenomeSize(const char* genome);
+		static std::size_t genomeHeaderSize();
+		static bool isValidGenome(const char* genome);
+		
+		bool operator==(const DenseNetwork& nn) const;
+		bool operator!=(const DenseNetwork& nn) const;
+};
+
+
+/*
+Plays matches of a generation simultaneously instead of one after the other, for network types
+that support batched evaluations. By default networks do not (supported is false).*/
+template<typename Network>
+struct MatchBatcher
+{
+	static const bool supported = false;
+	
+	static void play(Network* const*, const std::vector<std::pair<int, int>>&, const Payoffs&,
+		double*, double*, double&, double&) {}
+};
+
+/*
+All matches advance one iteration at a time. At each iteration, every network evaluates the
+decisions of all of its running matches with a single evaluateBatch call. Each side of a match has
+its own state, created at the start of the generation, so matches do not share their memory as they
+do when played one after the other.*/
+template<>
+struct MatchBatcher<DenseNetwork>
+{
+	static const bool supported = true;
+	
+	//plays the given pairs of individuals and adds the results to the counters
+	static void play(DenseNetwork* const* population, const std::vector<std::pair<int, int>>& pairs,
+		const Payoffs& payoffs, double* game_counts, double* payoff_sums, double& cooperations, double& defections);
+};
+
+#endif // DENSENETWORK_H
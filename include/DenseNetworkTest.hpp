@@ -0,0 +1,18 @@
+#ifndef DENSENETWORK_TEST_H
+#define DENSENETWORK_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "DenseNetwork.hpp"
+#include "Payoffs.hpp"
+
+#define DENSE_TEST_NODES 300 //more than a kernel block of nodes
+#define DENSE_TEST_BATCH 20 //more than a kernel block of rows
+#define DENSE_TEST_POPULATION 6
+
+void testDenseNetwork();
+
+#endif //DENSENETWORK_TEST_H
@@ -0,0 +1,54 @@
+#ifndef FITNESSESTIMATOR_H
+#define FITNESSESTIMATOR_H
+
+#include <vector>
+#include <array>
+#include <cstddef>
+
+#define ESTIMATOR_UNIT_MATCHES 2 //antithetic matches of a unit (lengths of tail probabilities u and 1 - u)
+
+/*Results of one individual in a unit of antithetic matches against the same opponent*/
+struct AntitheticSample
+{
+	std::array<double, ESTIMATOR_UNIT_MATCHES> payoffs; //sum of the individual's payoffs in each match
+	std::array<double, ESTIMATOR_UNIT_MATCHES> iterations; //game iterations of each match
+};
+
+/*
+Fitness estimates of a population from units of antithetic matches, with their sampling variance.
+Every pair plays the same number of units, and unit k of every pair may share its random numbers
+(common random numbers), so only the units k of a pair are independent replicates: the spread of an
+individual's estimate is measured across its units k, each summed over the individual's pairs (which
+keeps the correlation between the pairs of a unit). Without control variate, an individual's estimate
+is its payoffs per game iteration, as in a tournament. With the control variate (more than 2 units),
+the mean payoffs S of its units are corrected by the deviation of their game iterations L from the
+known mean E[L], with the slope b regressed within its pairs: (S - b (L - E[L])) / E[L].
+Variances are delta method estimates (including the error of b), and the effective sample size is
+the number of independent matches whose payoffs per iteration would have the same variance, a match's
+variance being pooled within the pairs. Both are NaN with a single unit per pair.*/
+class FitnessEstimator
+{
+	private:
+		const std::size_t pair_units; //units of each pair
+		const bool control_variate; //correct the estimates by the game iterations of the units
+		const double unit_iterations; //expected game iterations of a unit
+		std::vector<std::vector<AntitheticSample>> samples; //units of each individual, pair by pair
+		double variance = 0; //mean sampling variance of the last estimates
+		double effective_sample_size = 0; //mean effective sample size of the last estimates
+
+	public:
+		FitnessEstimator(int population_size, unsigned units_per_pair, bool with_control_variate);
+
+		void clear(); //forgets every sample (before the next generation)
+		//adds the next unit of an individual: units 0 to units_per_pair-1 of a pair, then those of its next pair
+		void addSample(int individual, const AntitheticSample& sample);
+
+		//adds each individual's estimate to its sums, as payoffs and game iterations whose ratio is the estimate
+		void estimate(double* payoff_sums, double* game_counts);
+
+		double getVariance() const; //mean over the individuals with samples (0 if none, NaN with 1 unit per pair)
+		double getEffectiveSampleSize() const; //mean over the individuals whose estimate varies (0 if none)
+		std::size_t getSampleCount(int individual) const;
+};
+
+#endif // FITNESSESTIMATOR_H
@@ -0,0 +1,19 @@
+#ifndef FITNESSESTIMATOR_TEST_H
+#define FITNESSESTIMATOR_TEST_H
+
+#include <iostream>
+#include <cmath>
+#include <cassert>
+
+#include "FitnessEstimator.hpp"
+#include "Rng.hpp"
+
+#define ESTIMATOR_TEST_UNITS 50 //units of each pair
+#define ESTIMATOR_TEST_PAIRS 4 //pairs of an individual sharing the random numbers of their units
+#define ESTIMATOR_TEST_RATE 3 //payoff per game iteration
+#define ESTIMATOR_TEST_BONUS 5 //payoff of a match regardless of its length
+#define ESTIMATOR_TEST_SHUFFLE 7 //multiplier pairing unrelated lengths (coprime with ESTIMATOR_TEST_UNITS)
+
+void testFitnessEstimator();
+
+#endif //FITNESSESTIMATOR_TEST_H
@@ -0,0 +1,34 @@
+#ifndef FITNESSTREE_H
+#define FITNESSTREE_H
+
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+/*
+Fenwick tree (binary indexed tree) over the selection weights of a population, so that one weight
+is changed and an individual is sampled proportionally to its weight in O(log n).
+Node i holds the sum of the weights (i - lowbit(i), i] (1-based), and sampling descends from the
+largest power of two to find the first index whose prefix sum exceeds the target.*/
+class FitnessTree
+{
+	private:
+		std::vector<double> weights; //weight of each individual
+		std::vector<double> nodes; //partial sums, 1-based
+		std::size_t top_step; //largest power of two not above the size
+		
+	public:
+		FitnessTree(std::size_t size);
+		
+		void assign(const std::vector<double>& new_weights); //replaces every weight (rebuilds the tree in O(n))
+		void set(std::size_t index, double weight); //changes one weight (negative weights are not selectable)
+		
+		double get(std::size_t index) const;
+		double total() const; //sum of every weight
+		std::size_t size() const;
+		
+		//index whose cumulative weight range contains target, for target in [0, total()[
+		std::size_t find(double target) const;
+};
+
+#endif // FITNESSTREE_H
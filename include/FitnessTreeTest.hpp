@@ -0,0 +1,16 @@
+#ifndef FITNESSTREE_TEST_H
+#define FITNESSTREE_TEST_H
+
+#include <iostream>
+#include <vector>
+#include <cassert>
+
+#include "FitnessTree.hpp"
+#include "Rng.hpp"
+
+#define FITNESSTREE_TEST_SIZE 13 //not a power of two
+#define FITNESSTREE_TEST_TARGETS 1000
+
+void testFitnessTree();
+
+#endif //FITNESSTREE_TEST_H
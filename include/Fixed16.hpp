@@ -0,0 +1,65 @@
+#ifndef FIXED16_H
+#define FIXED16_H
+
+#include <cstdint>
+#include <limits>
+
+#define FIXED16_FRACTION_BITS 8 //Q7.8 format: range [-128, 128[, resolution 1/256
+
+/*
+16-bit signed fixed-point number with saturating arithmetic.
+Values outside of the representable range are clamped instead of wrapping around, which keeps
+large network inputs meaningful (the squashing function is flat there anyway).*/
+class Fixed16
+{
+	private:
+		std::int16_t raw = 0; //value * 2^FIXED16_FRACTION_BITS
+
+		//clamps a wide intermediate result to the 16-bit range
+		static std::int16_t saturate(std::int32_t value) {
+			if (value > std::numeric_limits<std::int16_t>::max()) return std::numeric_limits<std::int16_t>::max();
+			if (value < std::numeric_limits<std::int16_t>::min()) return std::numeric_limits<std::int16_t>::min();
+			return static_cast<std::int16_t>(value);
+		}
+
+	public:
+		///Constructors
+		Fixed16() = default;
+		explicit Fixed16(double value) {
+			double scaled = value * (1 << FIXED16_FRACTION_BITS);
+			if (scaled >= std::numeric_limits<std::int16_t>::max()) raw = std::numeric_limits<std::int16_t>::max();
+			else if (scaled <= std::numeric_limits<std::int16_t>::min()) raw = std::numeric_limits<std::int16_t>::min();
+			else raw = static_cast<std::int16_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5); //round to nearest
+		}
+
+		static Fixed16 fromRaw(std::int16_t raw_value) {
+			Fixed16 value;
+			value.raw = raw_value;
+			return value;
+		}
+		std::int16_t getRaw() const { return raw; }
+
+		///Conversions
+		explicit operator double() const { return static_cast<double>(raw) / (1 << FIXED16_FRACTION_BITS); }
+
+		///Arithmetic
+		Fixed16 operator-() const { return fromRaw(saturate(-static_cast<std::int32_t>(raw))); }
+		Fixed16 operator+(Fixed16 other) const { return fromRaw(saturate(static_cast<std::int32_t>(raw) + other.raw)); }
+		Fixed16 operator-(Fixed16 other) const { return fromRaw(saturate(static_cast<std::int32_t>(raw) - other.raw)); }
+		Fixed16 operator*(Fixed16 other) const {
+			return fromRaw(saturate((static_cast<std::int32_t>(raw) * other.raw) >> FIXED16_FRACTION_BITS));
+		}
+		Fixed16& operator+=(Fixed16 other) { return *this = *this + other; }
+		Fixed16& operator-=(Fixed16 other) { return *this = *this - other; }
+		Fixed16& operator*=(Fixed16 other) { return *this = *this * other; }
+
+		///Comparisons
+		bool operator==(Fixed16 other) const { return raw == other.raw; }
+		bool operator!=(Fixed16 other) const { return raw != other.raw; }
+		bool operator<(Fixed16 other) const { return raw < other.raw; }
+		bool operator<=(Fixed16 other) const { return raw <= other.raw; }
+		bool operator>(Fixed16 other) const { return raw > other.raw; }
+		bool operator>=(Fixed16 other) const { return raw >= other.raw; }
+};
+
+#endif // FIXED16_H
@@ -0,0 +1,126 @@
+#ifndef GENOMEARCHIVE_H
+#define GENOMEARCHIVE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+
+#include "NeuralNetwork.hpp"
+
+#define ARCHIVE_MAGIC "COOPGEN" //first 8 bytes of an archive (with the terminating null)
+#define ARCHIVE_INDEX_MAGIC "COOPIDX" //last 8 bytes of a complete archive
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_BYTE_ORDER 0x01020304 //reads differently on a host of another byte order
+#define ARCHIVE_PRECISION_SIZE 16
+
+/*
+Archive layout (native byte order, all offsets in bytes from the start of the file):
+- ArchiveHeader
+- snapshots, each made of:
+  - SnapshotHeader
+  - individual_count + 1 offsets (uint64, from the start of the snapshot), the last one is the snapshot size
+  - the individuals' genomes (see NeuralNetwork::writeGenome)
+- footer index: one ArchiveIndexEntry per snapshot, by increasing generation
+- ArchiveFooter
+An archive without footer (interrupted run) can still be read by walking the snapshots.*/
+struct ArchiveHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t byte_order; //ARCHIVE_BYTE_ORDER
+	char precision[ARCHIVE_PRECISION_SIZE]; //Network::precisionName of the genomes
+	std::uint64_t seed; //RNG seed of the simulation
+	std::uint32_t population_size;
+	std::uint32_t interval; //generations between snapshots
+};
+
+struct SnapshotHeader
+{
+	std::uint64_t generation;
+	std::uint64_t size; //bytes of the snapshot including this header
+	std::uint32_t individual_count;
+	std::uint32_t reserved;
+};
+
+struct ArchiveIndexEntry
+{
+	std::uint64_t generation;
+	std::uint64_t offset; //position of the snapshot in the file
+};
+
+struct ArchiveFooter
+{
+	std::uint64_t snapshot_count;
+	std::uint64_t index_offset; //position of the first ArchiveIndexEntry
+	char magic[8];
+};
+
+
+/*Appends snapshots of the population to an archive file, the footer index is written by close()*/
+class GenomeArchiveWriter
+{
+	private:
+		std::ofstream output;
+		std::string file_name;
+		std::uint64_t position = 0; //current size of the file
+		std::vector<ArchiveIndexEntry> index;
+		std::vector<char> buffer; //snapshot being written
+		
+		void write(const void* data, std::size_t size);
+	
+	public:
+		//creates (or replaces) the archive, throws std::runtime_error on failure
+		GenomeArchiveWriter(const std::string& archive_file, const char* precision, std::uint64_t seed,
+			std::uint32_t population_size, std::uint32_t interval);
+		~GenomeArchiveWriter(); //closes the archive
+		
+		//appends a snapshot of the population
+		template<typename Network>
+		void append(unsigned long generation, Network* const* population, int population_size);
+		
+		void close(); //writes the footer index and closes the file
+};
+
+
+/*Maps an archive in memory and gives direct access to any snapshot or individual*/
+class GenomeArchiveReader
+{
+	private:
+		const char* data = nullptr; //mapped file
+		std::size_t size = 0;
+		const ArchiveHeader* header = nullptr;
+		std::vector<ArchiveIndexEntry> index;
+		bool complete = false; //the footer index was found
+		
+		void check(bool condition, const std::string& problem) const; //throws std::runtime_error if false
+		void loadIndex(); //reads the footer, or rebuilds the index from the snapshots
+		bool validSnapshot(std::uint64_t offset, std::uint64_t end) const; //a whole snapshot lies at offset, before end
+		const SnapshotHeader& snapshot(std::size_t snapshot_index) const;
+	
+	public:
+		//maps the archive, throws std::runtime_error if it is missing or invalid
+		GenomeArchiveReader(const std::string& archive_file);
+		~GenomeArchiveReader();
+		GenomeArchiveReader(const GenomeArchiveReader&) = delete;
+		GenomeArchiveReader& operator=(const GenomeArchiveReader&) = delete;
+		
+		const ArchiveHeader& getHeader() const;
+		bool isComplete() const; //false if the archive has no footer (interrupted run)
+		
+		std::size_t getSnapshotCount() const;
+		unsigned long getGeneration(std::size_t snapshot_index) const;
+		long findSnapshot(unsigned long generation) const; //snapshot of a generation, -1 if not archived
+		unsigned getIndividualCount(std::size_t snapshot_index) const;
+		
+		//genome of an individual, in place in the mapped file
+		const char* getGenome(std::size_t snapshot_index, unsigned individual) const;
+		
+		//creates a copy of an individual (caller owns it), Network must match the archive's precision
+		template<typename Network>
+		Network* loadIndividual(std::size_t snapshot_index, unsigned individual) const;
+};
+
+#endif // GENOMEARCHIVE_H
@@ -0,0 +1,24 @@
+#ifndef GENOMEARCHIVE_TEST_H
+#define GENOMEARCHIVE_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include "GenomeArchive.hpp"
+#include "NeuralNetwork.hpp"
+
+#define GENOMEARCHIVE_TEST_FILE "/tmp/coop-archive-test.bin"
+#define GENOMEARCHIVE_TEST_TRUNCATED_FILE "/tmp/coop-archive-test-truncated.bin"
+#define GENOMEARCHIVE_TEST_POPULATION 30
+#define GENOMEARCHIVE_TEST_SNAPSHOTS 4
+
+void testGenomeArchive();
+
+#endif //GENOMEARCHIVE_TEST_H
@@ -0,0 +1,61 @@
+#ifndef LINEAGE_H
+#define LINEAGE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cassert>
+#include <ostream>
+
+#include "NeuralNetwork.hpp"
+
+/*An individual of the ancestry tree*/
+struct LineageNode
+{
+	unsigned long id; //unique identifier, increasing with birth order
+	long parent; //position of the parent in the tree (-1 for founders)
+	unsigned long generation; //generation in which the individual was born
+	int population_index; //index of the individual in its population
+	int value_mutations; //value mutations since the parent (including pruned ancestors)
+	int node_change; //change in inner nodes at birth
+	int intelligence; //number of inner nodes
+	std::uint64_t genome_hash; //NeuralNetwork::hash of the individual
+	bool alive; //belongs to the current population
+};
+
+/*
+Records who descended from whom across generations, keeping only what is needed to describe the
+ancestry of the current population. After each generation the tree is pruned:
+- extinct lineages (individuals without living descendants) are removed;
+- dead ancestors with a single remaining child and no structural mutation are merged into that child,
+  whose value mutations then include the merged ancestor's.
+Founders and structural mutations are always kept, so memory is proportional to the surviving tree
+plus the structural mutations on its branches, not to generations x population size.*/
+class Lineage
+{
+	private:
+		std::vector<LineageNode> nodes; //ancestry tree, ordered by birth (parents before children)
+		std::vector<long> population; //position in the tree of each living individual
+		unsigned long next_id = 0; //identifier of the next individual
+		unsigned long generation = 0; //current generation
+
+		void prune(); //removes extinct lineages and merges single-child ancestors
+
+	public:
+		//records the founders of the population
+		template<typename Network>
+		void addFounders(Network* const* networks, int population_size);
+
+		//records the individuals of the next generation, given their parent's index and mutations
+		template<typename Network>
+		void addGeneration(Network* const* networks, const int* parent_indexes,
+			const MutationRecord* mutations, int population_size);
+
+		std::size_t size() const; //number of individuals in the tree
+		const std::vector<LineageNode>& getNodes() const;
+
+		void write(std::ostream& output) const; //writes the tree as an octave matrix
+		void writeFile(const std::string& file_name) const; //overwrites the file with the tree
+};
+
+#endif // LINEAGE_H
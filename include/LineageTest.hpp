@@ -0,0 +1,16 @@
+#ifndef LINEAGE_TEST_H
+#define LINEAGE_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <array>
+
+#include "Lineage.hpp"
+#include "Rng.hpp"
+
+#define LINEAGE_TEST_POPULATION 20
+#define LINEAGE_TEST_GENERATIONS 200
+
+void testLineage();
+
+#endif //LINEAGE_TEST_H
@@ -0,0 +1,62 @@
+#ifndef MARKOVGAME_H
+#define MARKOVGAME_H
+
+#include <array>
+#include <utility>
+#include <cmath>
+#include <cassert>
+
+#include "NeuralNetwork.hpp"
+#include "Rng.hpp"
+#include "Payoffs.hpp"
+
+/*Outcomes of a game iteration, as seen by the first player*/
+#define OUTCOME_BOTH_COOPERATE 0
+#define OUTCOME_SELF_COOPERATES 1
+#define OUTCOME_SELF_DEFECTS 2
+#define OUTCOME_BOTH_DEFECT 3
+#define OUTCOME_COUNT 4
+
+/*Expected results of a complete match between two players*/
+struct MatchExpectation
+{
+	double player_a_payoff_sum = 0; //expected sum of player A's payoffs
+	double player_b_payoff_sum = 0; //expected sum of player B's payoffs
+	double round_iterations = 0; //expected number of game iterations
+	double cooperations = 0; //expected number of cooperations (both players)
+	double defections = 0; //expected number of defections (both players)
+};
+
+/*
+Computes the exact expected results of a match between two NeuralNetworks.
+A network without context nodes only depends on the outcome of the previous iteration, so a match
+between two such networks is a Markov chain over the 4 possible outcomes (see OUTCOME_* macros).
+The number of iterations is geometric with continuation probability p, so the expected sum of any
+per-iteration value r is s0 * (I - pQ)^-1 * r, where s0 is the initial outcome and Q the transition matrix.
+Networks with context nodes have a memory and cannot be evaluated this way.*/
+class MarkovGame
+{
+	private:
+		typedef std::array<std::array<double, OUTCOME_COUNT>, OUTCOME_COUNT> Matrix;
+		typedef std::array<double, OUTCOME_COUNT> Vector;
+
+		//solves the linear system matrix * x = vector (vector is replaced by x)
+		static void solve(Matrix& matrix, Vector& vector);
+
+	public:
+		//probability that a game iteration continues to the next one
+		static double continuationProbability();
+
+		//outcome index corresponding to both players' choices
+		static int outcomeIndex(bool a_cooperates, bool b_cooperates);
+
+		//true if the network's decisions only depend on the previous outcome
+		template<typename Network>
+		static bool isMarkovian(const Network& player);
+
+		//exact expected results of a match between two markovian players
+		template<typename Network>
+		static MatchExpectation expectedMatch(Network& player_a, Network& player_b, const Payoffs& payoffs);
+};
+
+#endif // MARKOVGAME_H
@@ -0,0 +1,18 @@
+#ifndef MARKOVGAME_TEST_H
+#define MARKOVGAME_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <cmath>
+
+#include "MarkovGame.hpp"
+#include "Payoffs.hpp"
+
+#define MARKOV_TEST_NETWORKS 5
+#define MARKOV_TEST_MATCHES 2000
+#define MARKOV_TEST_FREQ_DIFF 0.03
+#define MARKOV_TEST_PAYOFF_DIFF 0.15
+
+void testMarkovGame();
+
+#endif //MARKOVGAME_TEST_H
@@ -0,0 +1,159 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <vector>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "NeuralNetwork.hpp"
+#include "DenseNetwork.hpp"
+#include "Strategies.hpp"
+
+#define METRICS_HISTOGRAM_BINS (2*MAXNODES + 1) //intelligence bins (the last one counts every larger network)
+#define METRICS_SEPARATOR ',' //separates the collectors of a list
+#define METRICS_PARAMETER_SEPARATOR ':' //separates a collector's name from its parameter
+#define DIVERSITY_LANES 8 //independent sums per distance, so that the compiler vectorizes the loops
+
+
+/*
+Read-only view of a generation, passed to the generation callback once the generation has been
+played and assessed, before selection replaces the population. Pointers refer to the simulation's
+own data (no copy) and are only valid during the callback.*/
+template<typename Network>
+struct GenerationView
+{
+	unsigned long generation; //index of the generation (from 0)
+	int population_size; //number of individuals (POPULATION_SIZE)
+	const Network* const* population; //genomes of the individuals
+	const int* intelligence; //number of inner nodes of each individual
+	const double* fitness; //fitness of each individual
+	double cooperation_frequency; //frequency of cooperation in the generation's matches
+	const int* strategies; //individuals per pure strategy (nullptr if not classified by the simulation)
+	int strategy_count; //number of registered pure strategies
+	bool fast_forwarded; //the tournament was skipped (fitness and cooperation are the last evaluated ones)
+};
+
+/*
+Records one metric of every generation and writes it with the simulation's results.
+Collectors are given each generation as a GenerationView, so that new metrics only need a new
+collector (see createCollectors), and a simulation only computes the metrics it was given.*/
+template<typename Network>
+class MetricCollector
+{
+	public:
+		virtual ~MetricCollector() {}
+
+		virtual void collect(const GenerationView<Network>& view) = 0; //records the generation's metric
+		virtual void write(std::ostream& output) const = 0; //writes the recorded values as octave matrices
+};
+
+/*Frequency of cooperation of each generation ("cooperation")*/
+template<typename Network>
+class CooperationCollector: public MetricCollector<Network>
+{
+	private:
+		std::vector<std::array<double, 1>> cooperation_frequency;
+
+	public:
+		void collect(const GenerationView<Network>& view) override;
+		void write(std::ostream& output) const override;
+};
+
+/*Mean intelligence or fitness of each generation ("mean_intelligence", "mean_fitness")*/
+template<typename Network>
+class MeanCollector: public MetricCollector<Network>
+{
+	private:
+		const bool of_fitness; //mean fitness rather than mean intelligence
+		std::vector<std::array<double, 1>> means;
+
+	public:
+		MeanCollector(bool fitness);
+
+		void collect(const GenerationView<Network>& view) override;
+		void write(std::ostream& output) const override;
+};
+
+/*Intelligence or fitness of every individual of each generation ("intelligence", "fitness")*/
+template<typename Network>
+class IndividualCollector: public MetricCollector<Network>
+{
+	private:
+		const bool of_fitness; //fitness rather than intelligence
+		std::vector<std::vector<double>> values; //one row per generation
+
+	public:
+		IndividualCollector(bool fitness);
+
+		void collect(const GenerationView<Network>& view) override;
+		void write(std::ostream& output) const override;
+};
+
+/*Number of individuals per intelligence of each generation ("intelligence_histogram")*/
+template<typename Network>
+class HistogramCollector: public MetricCollector<Network>
+{
+	private:
+		std::vector<std::array<int, METRICS_HISTOGRAM_BINS>> histograms;
+
+	public:
+		void collect(const GenerationView<Network>& view) override;
+		void write(std::ostream& output) const override;
+};
+
+/*
+Closest pure strategies of the population, every interval generations ("strategies:interval"), or
+of sample_size evenly spaced individuals of every generation ("strategies_sample:sample_size").
+Individuals are classified from a copy of their state, as the simulation itself would.*/
+template<typename Network>
+class StrategyCollector: public MetricCollector<Network>
+{
+	private:
+		const Strategies& strats; //pure strategy evaluator (must outlive the collector)
+		const unsigned interval; //generations between classifications
+		const int sample_size; //individuals classified (0 classifies the whole population)
+		std::vector<std::array<int, STRATEGIES_MAX + 1>> counts; //generation followed by the strategy counts
+
+	public:
+		StrategyCollector(const Strategies& strategies, unsigned classification_interval, int classified_sample = 0);
+
+		void collect(const GenerationView<Network>& view) override;
+		void write(std::ostream& output) const override;
+};
+
+/*Genetic diversity of a population*/
+struct Diversity
+{
+	int distinct_genotypes = 0; //individuals with different genomes (by hash)
+	double parameter_distance = 0; //mean Euclidean distance between the flat values of two individuals
+	double structural_distance = 0; //mean number of node and context node slots in which two individuals differ
+};
+
+/*
+Measures the diversity of a population. Individuals are flattened (see writeFlatParameters) into
+rows of a matrix padded to DIVERSITY_LANES floats, so that the distances of every pair are computed
+over contiguous floats with DIVERSITY_LANES independent sums, which the compiler vectorizes.*/
+template<typename Network>
+Diversity measureDiversity(const Network* const* population, int population_size);
+
+/*Distinct genotypes, mean parameter distance and mean structural distance of each generation ("diversity")*/
+template<typename Network>
+class DiversityCollector: public MetricCollector<Network>
+{
+	private:
+		std::vector<std::array<double, 3>> diversity;
+	
+	public:
+		void collect(const GenerationView<Network>& view) override;
+		void write(std::ostream& output) const override;
+};
+
+//creates the collectors of a comma-separated list of "name" or "name:parameter" (throws if a name is unknown)
+template<typename Network>
+std::vector<std::unique_ptr<MetricCollector<Network>>> createCollectors(const std::string& list, const Strategies& strats);
+
+std::string metricNames(); //names of the available collectors
+
+#endif // METRICS_H
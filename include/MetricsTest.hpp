@@ -0,0 +1,24 @@
+#ifndef METRICS_TEST_H
+#define METRICS_TEST_H
+
+#include <iostream>
+#include <sstream>
+#include <cassert>
+#include <stdexcept>
+#include <cmath>
+#include <vector>
+
+#include "Metrics.hpp"
+#include "Simulation.hpp"
+#include "Payoffs.hpp"
+#include "Rng.hpp"
+
+#define METRICS_TEST_GENERATIONS 6
+#define METRICS_TEST_SEED 11
+#define METRICS_TEST_INTERVAL 2
+#define METRICS_TEST_DIVERSITY_SIZE 9 //not a multiple of DIVERSITY_LANES
+#define METRICS_TEST_DENSE_NODES 37
+
+void testMetrics();
+
+#endif //METRICS_TEST_H
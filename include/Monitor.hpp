@@ -0,0 +1,78 @@
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <stdexcept>
+
+#define MONITOR_MAGIC 0x504F4F43 //"COOP"
+#define MONITOR_VERSION 1
+#define MONITOR_MAX_STRATEGIES 32
+#define MONITOR_READ_ATTEMPTS 1000
+
+/*Snapshot of a running simulation (fixed layout, shared between processes)*/
+struct MonitorStats
+{
+	std::uint64_t generation; //number of completed generations
+	std::uint64_t total_generations; //number of generations to run
+	std::uint32_t finished; //1 once the simulation has ended
+	std::int32_t strategy_count; //number of used entries in strategies
+	double mean_intelligence; //average number of inner nodes
+	double mean_fitness; //average fitness
+	double cooperation_frequency; //frequency of cooperation during the generation's games
+	double generations_per_second; //average throughput since the start of the run
+	std::int64_t strategies_generation; //generation the strategy counts belong to (-1 if none yet)
+	std::int32_t strategies[MONITOR_MAX_STRATEGIES]; //number of individuals per pure strategy
+};
+
+/*Header and data of the shared memory segment*/
+struct MonitorSegment
+{
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::atomic<std::uint64_t> sequence; //seqlock: odd while the stats are being written
+	MonitorStats stats;
+};
+
+/*Reads snapshots of a named segment, the mapping stays readable after the segment is removed*/
+class MonitorReader
+{
+	private:
+		const MonitorSegment* segment = nullptr; //mapped segment (read only)
+	
+	public:
+		MonitorReader(const std::string& name); //opens the segment if it exists
+		MonitorReader(const MonitorReader&) = delete;
+		MonitorReader& operator=(const MonitorReader&) = delete;
+		~MonitorReader();
+		
+		bool isOpen() const; //true if the segment was found
+		bool read(MonitorStats& stats) const; //copies a consistent snapshot, false if none could be read
+};
+
+/*
+Publishes the statistics of a running simulation to a named POSIX shared memory segment.
+Updates are protected by a seqlock: the simulation never waits for readers, readers retry
+if they observed a partial update. The segment is removed when the Monitor is destroyed,
+readers that already opened it can still read the final statistics.*/
+class Monitor
+{
+	private:
+		std::string segment_name; //name of the shared memory object
+		MonitorSegment* segment = nullptr; //mapped segment
+		std::chrono::steady_clock::time_point start_time; //used to compute throughput
+	
+	public:
+		static std::string segmentName(const std::string& name); //shared memory object name
+		
+		Monitor(const std::string& name); //creates the segment (throws on failure or if it already exists)
+		Monitor(const Monitor&) = delete;
+		Monitor& operator=(const Monitor&) = delete;
+		~Monitor(); //unmaps and removes the segment
+		
+		void publish(MonitorStats stats); //writes new stats (throughput is filled in)
+};
+
+#endif // MONITOR_H
@@ -0,0 +1,17 @@
+#ifndef MONITOR_TEST_H
+#define MONITOR_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <unistd.h>
+
+#include "Monitor.hpp"
+
+#define MONITOR_TEST_UPDATES 20000
+
+void testMonitor();
+
+#endif //MONITOR_TEST_H
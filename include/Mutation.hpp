@@ -0,0 +1,53 @@
+#ifndef MUTATION_H
+#define MUTATION_H
+
+#include <array>
+#include <string>
+#include <cassert>
+
+#include "NeuralNetwork.hpp"
+#include "Rng.hpp"
+
+/*Probability of mutating each parameter of a class (see PARAMETER_* macros)*/
+struct MutationRates
+{
+	std::array<double, PARAMETER_CLASS_COUNT> rates;
+	
+	MutationRates(); //NETWORK_VALUE_MUTATION_PROB for values, NETWORK_STRUCTURE_MUTATION_PROB for the structure
+	
+	//sets the rate of a class given its name ("values" sets every value class), returns false if unknown
+	bool set(const std::string& class_name, double rate);
+	
+	//parses a list of "class:rate" separated by commas, returns false if malformed
+	bool parse(const std::string& rate_list);
+	
+	static const char* className(int parameter_class);
+};
+
+/*
+Mutates a whole population in one pass, generating only the mutations that actually happen.
+The parameters of each class are laid out one network after the other as a single flattened vector;
+instead of one random trial per parameter, the engine draws the geometric distance to the next
+mutated parameter and jumps there directly. With the default rates this draws about one random
+number per mutation instead of one per parameter, and the cost no longer grows with network size.
+Each parameter is still mutated independently with its class' probability, as with Network::mutate.
+Value mutations of a network are applied before its structural mutation, as with Network::mutate.*/
+template<typename Network>
+class MutationEngine
+{
+	private:
+		MutationRates mutation_rates;
+		
+		//mutates the parameters of one class in all networks
+		void mutateClass(int parameter_class, Network* const* population, int population_size, MutationRecord* records);
+	
+	public:
+		MutationEngine(const MutationRates& rates = MutationRates());
+		
+		//mutates every network of the population, records[i] receives network i's mutations
+		void mutatePopulation(Network* const* population, int population_size, MutationRecord* records);
+		
+		const MutationRates& getRates() const;
+};
+
+#endif // MUTATION_H
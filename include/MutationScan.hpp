@@ -0,0 +1,72 @@
+#ifndef MUTATIONSCAN_H
+#define MUTATIONSCAN_H
+
+#include <vector>
+#include <memory>
+#include <iostream>
+#include <stdexcept>
+
+#include "NeuralNetwork.hpp"
+#include "DenseNetwork.hpp"
+#include "Payoffs.hpp"
+#include "Mutation.hpp"
+#include "CrossEvaluation.hpp"
+
+/*Mutation types of a scan: one per class of values (see PARAMETER_* macros), then structural and whole mutations*/
+#define SCAN_TYPE_ADD_NODE PARAMETER_STRUCTURE //Network::addNode
+#define SCAN_TYPE_REMOVE_NODE (PARAMETER_STRUCTURE + 1) //Network::removeNode
+#define SCAN_TYPE_MUTATE (PARAMETER_STRUCTURE + 2) //MutationEngine (every parameter with its rate, as in the simulation)
+#define SCAN_TYPE_COUNT (PARAMETER_STRUCTURE + 3)
+#define SCAN_DEFAULT_MUTANTS 200 //mutants per type of the scan command
+
+/*One mutant of a scan*/
+struct ScanMutant
+{
+	int type; //SCAN_TYPE_* or the class of the mutated value
+	int node_change; //change in the number of inner nodes
+	double fitness_effect; //fitness of the mutant minus the focal network's mean fitness
+};
+
+/*
+Samples the mutational neighbourhood of a focal network: mutants of each type are generated from the
+focal network, then copies of the focal network and every mutant play against a fixed resident
+population in a single CrossEvaluation (residents are shared, mutants do not play each other).
+Fitness is computed as in the simulation (mean payoff per game iteration minus the penalty of the
+inner nodes), so that each mutant's fitness effect is its fitness minus the focal network's. The
+focal fitness is the mean over as many copies as there are mutants of a type, so that its noise
+does not shift every effect by the same draw. The residents are the caller's: in the simulation a
+newcomer meets every other individual, so they should not include the focal network itself.*/
+template<typename Network>
+class MutationScan
+{
+	private:
+		const Payoffs game_payoffs;
+		const unsigned thread_count;
+		MutationEngine<Network> mutation_engine; //whole mutations
+		unsigned focal_copies = 0; //copies of the focal network evaluated with the mutants
+		double focal_fitness = 0; //mean over the focal copies
+		double focal_error = 0; //standard error of the mean
+		std::vector<ScanMutant> mutants;
+		
+		static bool applies(const Network& focal, int type); //the type can change the focal network
+		int mutate(Network& mutant, int type); //applies a mutation of the type, returns the node change
+	
+	public:
+		MutationScan(const Payoffs& payoffs, unsigned threads = 1, const MutationRates& rates = MutationRates());
+		
+		//generates mutants_per_type mutants of each type that applies to the focal network, and evaluates them
+		//against every resident (the plan cannot sample pairs)
+		void scan(const Network& focal, std::vector<std::unique_ptr<Network>> residents, unsigned mutants_per_type, 
+			const PairingPlan& plan);
+		
+		double getFocalFitness() const;
+		double getFocalError() const;
+		const std::vector<ScanMutant>& getMutants() const; //in order of type
+		
+		//writes the fitness effect of every mutant and their distribution per type, in the octave format
+		void write(std::ostream& output) const;
+		
+		static const char* typeName(int type);
+};
+
+#endif // MUTATIONSCAN_H
@@ -0,0 +1,24 @@
+#ifndef MUTATIONSCAN_TEST_H
+#define MUTATIONSCAN_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+
+#include "MutationScan.hpp"
+#include "Statistics.hpp"
+#include "Payoffs.hpp"
+#include "Rng.hpp"
+
+#define MUTATIONSCAN_TEST_RESIDENTS 8
+#define MUTATIONSCAN_TEST_MUTANTS 5 //per type
+#define MUTATIONSCAN_TEST_THREADS 3
+#define MUTATIONSCAN_TEST_SEED 13
+
+void testMutationScan();
+
+#endif //MUTATIONSCAN_TEST_H
@@ -0,0 +1,17 @@
+#ifndef MUTATION_TEST_H
+#define MUTATION_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "Mutation.hpp"
+#include "NeuralNetwork.hpp"
+
+#define MUTATION_TEST_POPULATION 200
+#define MUTATION_TEST_ROUNDS 100
+
+void testMutation();
+
+#endif //MUTATION_TEST_H
@@ -5,77 +5,134 @@
 #include <iostream>
 #include <cassert>
 #include <vector>
+#include <cstdint>
+#include <cstring>
 
 #include "Rng.hpp"
 #include "Payoffs.hpp"
+#include "Fixed16.hpp"
 
 #define MAXNODES 10
 #define NETWORK_VALUE_MUTATION_PROB 0.1
 #define NETWORK_STRUCTURE_MUTATION_PROB 0.02
+#define GENOME_HEADER_SIZE 4 //default choice, cognitive and context node counts, padding
+#define GENOME_NODE_VALUES 6 //values stored per cognitive node
+#define FLAT_NETWORK_VALUES 2 //flat values of the network itself: default choice, output threshold
+#define FLAT_NODE_VALUES 5 //flat values per node slot: threshold, self payoff, other payoff, output and context weights
+#define FLAT_NODE_STRUCTURE 2 //flat structure per node slot: the node exists, its context node exists
 
-typedef double numval;
+/*Classes of mutable parameters, each mutated with its own probability (see MutationEngine)*/
+#define PARAMETER_DEFAULT_CHOICE 0 //one per network
+#define PARAMETER_SELF_PAYOFF_WEIGHT 1 //one per cognitive node
+#define PARAMETER_OTHER_PAYOFF_WEIGHT 2 //one per cognitive node
+#define PARAMETER_OUTPUT_WEIGHT 3 //one per cognitive node
+#define PARAMETER_CONTEXT_WEIGHT 4 //one per cognitive node, even without a context node
+#define PARAMETER_NODE_THRESHOLD 5 //one per cognitive node
+#define PARAMETER_OUTPUT_THRESHOLD 6 //one per network
+#define PARAMETER_STRUCTURE 7 //one per network (adds or removes a node)
+#define PARAMETER_CLASS_COUNT 8
 
-/*Squashing function used by cognitive and output nodes*/
-numval sigmoidalSquash(numval value, numval threshold);
+typedef double numval; //default precision of network values
+
+/*Summary of the mutations applied to a network by NeuralNetwork::mutate*/
+struct MutationRecord
+{
+	int value_mutations = 0; //number of mutated numeric values (and default choice)
+	int node_change = 0; //change in the number of inner nodes
+};
+
+/*Squashing function used by cognitive and output nodes (T is the precision of network values)*/
+template<typename T>
+T sigmoidalSquash(T value, T threshold);
+
+//fixed-point values are squashed with a lookup table
+template<>
+Fixed16 sigmoidalSquash<Fixed16>(Fixed16 value, Fixed16 threshold);
+
+
+/*
+Runtime state of a network: the values of its context nodes, which act as a memory.
+Networks are not modified when they are evaluated on a state, so one network can play several
+matches at once, each with its own state.*/
+template<typename T>
+struct BasicNetworkState
+{
+	std::vector<T> context_values; //one per cognitive node (0 for nodes without a context node)
+};
 
 
-/*Represents a cognitive node that may or may not be attached to a context node*/
-class InnerNode
+/*Represents a cognitive node that may or may not be attached to a context node.
+The context value itself belongs to the network's state (see BasicNetworkState).
+Values are stored with precision T (double, float or Fixed16).*/
+template<typename T>
+class BasicInnerNode
 {
-	friend class NeuralNetwork;
+	template<typename U> friend class BasicNeuralNetwork;
 	
 	private:
-		numval threshold_value;	//used by the squashing function of the cognitive node	
+		T threshold_value;	//used by the squashing function of the cognitive node	
 		
 		bool has_context_node = false; //is a context node attached ?
-		numval context_value = 0; //the context value acts as a memory
-		numval context_link_weight = 0; //multiplicator for input from context node
+		T context_link_weight = T(0); //multiplicator for input from context node
 	
 	public:
 		///Constructors
-		InnerNode() = delete; //threshold needs to be provided
-		InnerNode(numval threshold); //creates a cognitive node without a context node
-		InnerNode(const InnerNode& in); //copy constructor
+		BasicInnerNode() = delete; //threshold needs to be provided
+		BasicInnerNode(T threshold); //creates a cognitive node without a context node
+		BasicInnerNode(const BasicInnerNode& in); //copy constructor
+		BasicInnerNode& operator=(const BasicInnerNode& in) = default;
 		
 		//set values for associated context node (creates context node if needed)
-		bool hasContextNode(); //does the cognitive node has associated context node
-		void addContextNode(numval value, numval link_weight); 
+		bool hasContextNode() const; //does the cognitive node has associated context node
+		void addContextNode(T link_weight); 
 		void removeContextNode(); //remove associated context node
 		
-		numval operator()(numval input); //get output value given the provided input
+		//get output value given the provided input (updates the context value if there is a context node)
+		T operator()(T input, T& context_value) const;
 		
-		bool operator==(const InnerNode& in);
+		bool operator==(const BasicInnerNode& in) const;
 };
 
 
-/* Represents a complete neural network with up to 10 cognitive and 10 context nodes*/
-class NeuralNetwork
+/* Represents a complete neural network with up to 10 cognitive and 10 context nodes.
+The network's structure and values form its genome; the values of its context nodes form its state.
+The network keeps a carryover state, used by evaluations without an explicit state, so that
+sequential matches share its memory. Values are stored with precision T (double, float or Fixed16).*/
+template<typename T>
+class BasicNeuralNetwork
 {	
 	private:
 		///Neural network structure
 		bool cooperate_by_default; //used for decision-making in first round
-		numval output_node_threshold; //same use as inner nodes thresholds
+		T output_node_threshold; //same use as inner nodes thresholds
 		
 		int context_node_count = 0; //number of context nodes
-		std::vector<InnerNode*> inner_nodes; //Neural network's hidden layer nodes
-		std::vector<numval> link_weights_from_self_payoff; //link weights between first input and nodes
-		std::vector<numval> link_weights_from_other_payoff; //...between second input and nodes
-		std::vector<numval> link_weights_from_inner_nodes; //...between nodes and output
+		std::vector<BasicInnerNode<T>> inner_nodes; //Neural network's hidden layer nodes
+		std::vector<T> link_weights_from_self_payoff; //link weights between first input and nodes
+		std::vector<T> link_weights_from_other_payoff; //...between second input and nodes
+		std::vector<T> link_weights_from_inner_nodes; //...between nodes and output
+		
+		BasicNetworkState<T> carryover_state; //memory shared by evaluations without an explicit state
 		
 		int getRandomCognitiveNode(bool withContext);
 	
 	public:
+		typedef T value_type; //precision of network values
+		typedef BasicNetworkState<T> State; //runtime state of the network
+		static const char* precisionName(); //name of the precision, for output
+		
 		///Constructors
-        NeuralNetwork(); //trivial ctr
-        NeuralNetwork(const NeuralNetwork&); //copy
-		NeuralNetwork(NeuralNetwork&&) = default; //move
+		BasicNeuralNetwork(); //trivial ctr
+		BasicNeuralNetwork(const BasicNeuralNetwork&); //copy
+		BasicNeuralNetwork(BasicNeuralNetwork&&) = default; //move
+		explicit BasicNeuralNetwork(const char* genome); //from a genome written by writeGenome
 		
 		///Assignments
-		NeuralNetwork& operator=(const NeuralNetwork&) = delete; 
-		NeuralNetwork& operator=(NeuralNetwork&&) = delete; 
+		BasicNeuralNetwork& operator=(const BasicNeuralNetwork&); //copy, reusing storage
+		BasicNeuralNetwork& operator=(BasicNeuralNetwork&&) = delete; 
 
-        ///Destructors
-        ~NeuralNetwork(); //deletes InnerNode objects
+		///Destructors
+		~BasicNeuralNetwork() = default;
 
 		/**Methods & Operators**/
 		void addNode(); //adds a node to the structure if possible
@@ -86,17 +143,49 @@ class NeuralNetwork
 		void removeContextNode();
 		void removeCognitiveNode();
 		
-		void mutate(); //implements all specified mutations with given random probabilities
+		MutationRecord mutate(); //implements all specified mutations with given random probabilities
+		
+		int getParameterCount(int parameter_class) const; //number of parameters of a class (see PARAMETER_* macros)
+		int mutateParameter(int parameter_class, int index); //mutates one parameter, returns the change in inner nodes
 		
 		int getInnerNodeCount()const;
 		int getCognitiveNodeCount() const;
 		int getContextNodeCount() const;
 		
+		///Decisions
+		State createState() const; //new state with the network's current context values
+		State& getCarryoverState(); //state used by evaluations without an explicit state
+		
+		//probability of cooperating given the input, with the given state (updated)
+		T getCooperationProbability(payoff self_payoff, payoff other_payoff, State& state) const;
+		bool decide(payoff self_payoff, payoff other_payoff, State& state) const; //cooperate or defect, with the given state
+		
+		T getCooperationProbability(payoff self_payoff, payoff other_payoff); //probability of cooperating given the input
 		bool operator()(payoff self_payoff, payoff other_payoff); //decide whether to cooperate or defect
-		bool operator()(); //default decision (without input)
+		bool operator()() const; //default decision (without input)
 		
-		bool operator==(const NeuralNetwork& nn);
-		bool operator!=(const NeuralNetwork& nn);
+		std::uint64_t hash() const; //hash of the network's structure and values
+		
+		//writes the values (FLAT_NETWORK_VALUES + node_slots*FLAT_NODE_VALUES) and the structure 
+		//(node_slots*FLAT_NODE_STRUCTURE) as floats, with zeros for the slots past the cognitive nodes
+		void writeFlatParameters(float* values, float* structure, int node_slots) const;
+		
+		///Serialization
+		std::size_t getGenomeSize() const; //size in bytes of the network's genome
+		void writeGenome(char* genome) const; //writes the structure and values (getGenomeSize bytes)
+		static std::size_t readGenomeSize(const char* genome); //size of a genome written by writeGenome
+		static std::size_t genomeHeaderSize(); //bytes of a genome read by readGenomeSize
+		//true if the node counts of a genome (of readGenomeSize bytes) are those the genome constructor expects
+		static bool isValidGenome(const char* genome);
+		
+		bool operator==(const BasicNeuralNetwork& nn);
+		bool operator!=(const BasicNeuralNetwork& nn);
 };
 
+///Available precisions
+typedef BasicInnerNode<numval> InnerNode;
+typedef BasicNeuralNetwork<numval> NeuralNetwork;
+typedef BasicNeuralNetwork<float> FloatNeuralNetwork;
+typedef BasicNeuralNetwork<Fixed16> FixedNeuralNetwork;
+
 #endif // NEURALNETWORK_H
@@ -0,0 +1,99 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <ostream>
+
+#include "Allocations.hpp"
+
+/*Phases of a generation (see BasicSimulation::step)*/
+#define PROFILE_PHASE_TOURNAMENT 0 //playGeneration
+#define PROFILE_PHASE_ASSESSMENT 1 //assessPopulation
+#define PROFILE_PHASE_SELECTION 2 //nextGeneration
+#define PROFILE_PHASE_OUTPUT 3 //archive, callback, monitor, lineage and the final results
+#define PROFILE_PHASE_COUNT 4
+
+/*Hardware counters read around each phase*/
+#define PROFILE_COUNTER_CYCLES 0
+#define PROFILE_COUNTER_INSTRUCTIONS 1
+#define PROFILE_COUNTER_CACHE_MISSES 2
+#define PROFILE_COUNTER_BRANCH_MISSES 3
+#define PROFILE_COUNTER_COUNT 4
+
+#define PROFILE_COLUMNS_PER_PHASE 6 //columns of each phase in the per-generation matrix
+
+/*Counters accumulated by a phase*/
+struct PhaseCounters
+{
+	std::array<double, PROFILE_COUNTER_COUNT> counters = {}; //hardware events (scaled if multiplexed)
+	double seconds = 0; //wall clock time
+	double allocations = 0; //number of heap allocations (see AllocationCounter)
+	double allocated_bytes = 0; //bytes allocated
+	double peak_live_bytes = 0; //largest heap usage during the phase
+	
+	void add(const PhaseCounters& other);
+	double instructionsPerCycle() const;
+	double missesPerKiloInstruction(int counter) const; //cache or branch misses per 1000 instructions
+};
+
+/*
+Measures the hardware counters and wall clock time of each phase of the simulation with Linux
+perf_event_open, counting user space events of the calling thread and of the threads it creates
+(tournament threads are included since they end within their phase, long-lived pipeline workers are not).
+When the counters cannot be opened (no PMU, restricted perf_event_paranoid, containers) only the wall
+clock time is measured, and the reason is reported with the results.
+Heap allocations are counted as well when the allocator is replaced (see AllocationCounter).*/
+class PhaseProfiler
+{
+	private:
+		std::array<int, PROFILE_COUNTER_COUNT> descriptors; //perf event file descriptors (-1 if not open)
+		bool counters_available = false; //every counter was opened
+		std::string unavailable_reason; //why the counters are not available
+		
+		int current_phase = -1; //phase being measured (-1 if none)
+		std::array<double, PROFILE_COUNTER_COUNT> phase_start_counters; //counter values at the start of the phase
+		std::chrono::steady_clock::time_point phase_start_time;
+		AllocationStats phase_start_allocations; //allocation counters at the start of the phase
+		
+		std::array<PhaseCounters, PROFILE_PHASE_COUNT> generation_phases; //phases of the current generation
+		std::vector<std::array<PhaseCounters, PROFILE_PHASE_COUNT>> generations; //phases of every generation
+		std::array<PhaseCounters, PROFILE_PHASE_COUNT> totals; //phases of the whole run
+		
+		void readCounters(std::array<double, PROFILE_COUNTER_COUNT>& values) const; //scaled counter values
+	
+	public:
+		PhaseProfiler(); //opens the counters if possible
+		PhaseProfiler(const PhaseProfiler&) = delete;
+		PhaseProfiler& operator=(const PhaseProfiler&) = delete;
+		~PhaseProfiler();
+		
+		void begin(int phase); //starts measuring a phase
+		void end(); //stops measuring the current phase
+		void endGeneration(); //stores the phases of the current generation
+		
+		bool countersAvailable() const;
+		const std::vector<std::array<PhaseCounters, PROFILE_PHASE_COUNT>>& getGenerations() const;
+		const std::array<PhaseCounters, PROFILE_PHASE_COUNT>& getTotals() const;
+		
+		void write(std::ostream& output) const; //writes the per-generation matrix and the aggregate summary
+		static const char* phaseName(int phase);
+};
+
+/*Measures a phase for the lifetime of the object (nothing if the profiler is null)*/
+class ProfiledPhase
+{
+	private:
+		PhaseProfiler* profiler;
+	
+	public:
+		ProfiledPhase(PhaseProfiler* phase_profiler, int phase);
+		ProfiledPhase(const ProfiledPhase&) = delete;
+		ProfiledPhase& operator=(const ProfiledPhase&) = delete;
+		~ProfiledPhase();
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,15 @@
+#ifndef PROFILER_TEST_H
+#define PROFILER_TEST_H
+
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+#include "Profiler.hpp"
+
+#define PROFILER_TEST_GENERATIONS 3
+#define PROFILER_TEST_ALLOCATION_SIZE 1000
+
+void testProfiler();
+
+#endif //PROFILER_TEST_H
@@ -4,6 +4,9 @@
 #include <random>
 #include <array>
 #include <iostream>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 
 #define ROUND_ITERATIONS_STOP_COUNT 1
 #define ROUND_ITERATIONS_MEAN_PROB 0.98
@@ -11,34 +14,44 @@
 #define NUMVAL_MEAN 0
 #define NUMVAL_STDDEV 0.5
 
+/*
+Global random number generator. Each thread has its own generator and distributions,
+all threads start from the same seed unless they select a different stream.*/
 class RNG 
 {
 	private:
-		static unsigned seed;
+		static unsigned long long seed;
 		static bool seed_is_random;
-		static std::mt19937_64 generator;
+		static thread_local std::mt19937_64 generator;
 		
 		//random boolean
-		static std::uniform_int_distribution<int> distribution_bool;
+		static thread_local std::uniform_int_distribution<int> distribution_bool;
 		
 		//random probability
-		static std::uniform_real_distribution<double> distribution_probabilities;
+		static thread_local std::uniform_real_distribution<double> distribution_probabilities;
 		
 		//random real value
-		static std::normal_distribution<double> distribution_numvals; 
+		static thread_local std::normal_distribution<double> distribution_numvals; 
 		
 		//random number of initial nodes
-		static std::uniform_int_distribution<int> distribution_initial_nodes;
+		static thread_local std::uniform_int_distribution<int> distribution_initial_nodes;
 		
 		//random number of game iterations between two players
-		static std::negative_binomial_distribution<int> distribution_iterations;
+		static thread_local std::negative_binomial_distribution<int> distribution_iterations;
 
 	public:
-		static void setSeed(unsigned new_seed);
+		static void setSeed(unsigned long long new_seed);
+		
+		//reseeds the calling thread's generator with a stream derived from the seed
+		static void setStream(unsigned long long stream);
+		
+		//state of the calling thread's generator, which setGenerator restores without reseeding
+		static const std::mt19937_64& getGenerator();
+		static void setGenerator(const std::mt19937_64& state);
 		
 		static void setRandomSeed();
 	
-		static long long int getSeed();
+		static unsigned long long getSeed();
 		
 		static bool seedIsRandom();
 		
@@ -48,12 +61,22 @@ class RNG
 		
 		static int getRandomInt(int rangeStart, int rangeStop);
 		
+		static double getRandomProbability(); //uniform value in [0, 1[
+		
 		static double getRandomNumval();
 		
 		static int getInitialNodeCount();
 		
 		static int getIterationCount();
 		
+		//number of iterations whose upper tail probability is the given value in ]0, 1] (inverts getIterationCount)
+		static int getIterationCountAt(double tail_probability);
+		
+		static double getMeanIterationCount(); //expected value of getIterationCount
+		
+		//number of failures before the next success of independent trials with the given probability
+		static long getGeometricSkip(double probability);
+		
 		//selects random individuals from population based on their fitness
 		template<std::size_t SIZE>
 		static void selectPopulation(std::array<double, SIZE>& population_fitness, std::array<int, SIZE>& new_population_indexes) {
@@ -0,0 +1,135 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <semaphore.h>
+#include <sys/types.h>
+
+#define SHARD_TILE_SIZE 16 //individuals per side of a tile of the pair matrix
+#define SHARD_SHM_CAPACITY 65536 //bytes of a shared memory mailbox (longer messages are sent in chunks)
+#define SHARD_SHM_PEER_CHECK_MS 100 //a process waiting on a mailbox checks the other one this often
+
+/*Commands sent by the coordinator to its workers*/
+#define SHARD_COMMAND_STOP 0 //the worker exits
+#define SHARD_COMMAND_PLAY 1 //the worker plays its tiles of a generation
+
+/*
+Tile of the pair matrix: the pairs (a, b) with a < b, a in [row_begin, row_end[ and b in [col_begin, col_end[.
+Tiles do not depend on the number of workers, so that each tile draws from its own RNG stream and
+the results of a generation are the same whatever the number of workers.*/
+struct ShardTile
+{
+	int row_begin, row_end;
+	int col_begin, col_end;
+};
+
+//tiles covering every pair of the population, in row major order of the upper triangle
+std::vector<ShardTile> shardTiles(int population_size);
+
+/*
+Bidirectional byte stream between the coordinator and one of its worker processes.
+The channel is created before the worker is forked, then each process selects its side.*/
+class ShardChannel
+{
+	public:
+		virtual ~ShardChannel() {}
+
+		virtual void selectSide(bool worker, pid_t peer) = 0; //called once in each process after the fork, with the other process
+		virtual void send(const void* data, std::size_t size) = 0; //throws if the other side is gone
+		virtual void receive(void* data, std::size_t size) = 0; //blocks until size bytes are received
+
+		//creates a channel of the given transport ("socket" or "shm"), throws if unknown
+		static std::unique_ptr<ShardChannel> create(const std::string& transport);
+
+		template<typename T>
+		void sendValue(const T& value) { send(&value, sizeof(T)); }
+		template<typename T>
+		T receiveValue() { T value; receive(&value, sizeof(T)); return value; }
+};
+
+/*Channel over a pair of connected UNIX sockets (detects a worker that exited)*/
+class SocketChannel: public ShardChannel
+{
+	private:
+		int sockets[2]; //coordinator's end, worker's end
+		int own_socket = -1; //end used by this process once the side is selected
+
+	public:
+		SocketChannel();
+		~SocketChannel();
+		SocketChannel(const SocketChannel&) = delete;
+		SocketChannel& operator=(const SocketChannel&) = delete;
+
+		void selectSide(bool worker, pid_t peer) override;
+		void send(const void* data, std::size_t size) override;
+		void receive(void* data, std::size_t size) override;
+};
+
+/*
+Channel over an anonymous shared memory mapping with one mailbox per direction. Each mailbox holds
+one chunk at a time, guarded by two process-shared semaphores (filled and emptied). Semaphores do not
+notice a process that exited, so waits time out regularly to check the other process: the worker
+(a child of the coordinator) with waitpid, the coordinator through the worker's parent.*/
+class SharedMemoryChannel: public ShardChannel
+{
+	private:
+		struct Mailbox
+		{
+			sem_t filled; //posted when a chunk is written
+			sem_t emptied; //posted when the chunk has been read
+			std::size_t size; //bytes of the current chunk
+			char data[SHARD_SHM_CAPACITY];
+		};
+
+		Mailbox* mailboxes; //to the worker, to the coordinator
+		Mailbox* outbox = nullptr;
+		Mailbox* inbox = nullptr;
+		std::size_t read_offset = 0; //bytes of the inbox' current chunk already received
+		bool reading = false; //a chunk of the inbox is being received
+		bool worker_side = false; //this process is the worker
+		pid_t peer = 0; //the other process
+		
+		void waitSemaphore(sem_t* semaphore); //throws if the other process exited meanwhile
+		bool peerExited(); //the other process is gone
+
+	public:
+		SharedMemoryChannel();
+		~SharedMemoryChannel();
+		SharedMemoryChannel(const SharedMemoryChannel&) = delete;
+		SharedMemoryChannel& operator=(const SharedMemoryChannel&) = delete;
+
+		void selectSide(bool worker, pid_t peer) override;
+		void send(const void* data, std::size_t size) override;
+		void receive(void* data, std::size_t size) override;
+};
+
+/*Worker processes forked from the coordinator, each connected to it by its own channel*/
+class ShardPool
+{
+	private:
+		std::vector<std::unique_ptr<ShardChannel>> channels;
+		std::vector<pid_t> workers;
+
+		void startWorkers(unsigned shard_count, const std::string& transport,
+			const std::function<void(unsigned, ShardChannel&)>& worker);
+		void stopWorkers();
+
+	public:
+		//forks the workers, which call worker(shard_index, channel) then exit
+		ShardPool(unsigned shard_count, const std::string& transport,
+			const std::function<void(unsigned, ShardChannel&)>& worker);
+		~ShardPool(); //stops the workers and waits for them
+		ShardPool(const ShardPool&) = delete;
+		ShardPool& operator=(const ShardPool&) = delete;
+
+		unsigned size() const;
+		ShardChannel& getChannel(unsigned shard);
+};
+
+#endif // SHARD_H
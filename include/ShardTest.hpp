@@ -0,0 +1,19 @@
+#ifndef SHARD_TEST_H
+#define SHARD_TEST_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cassert>
+#include <unistd.h>
+
+#include "Shard.hpp"
+
+#define SHARD_TEST_POPULATION 37 //not a multiple of SHARD_TILE_SIZE
+#define SHARD_TEST_WORKERS 2
+#define SHARD_TEST_LARGE_MESSAGE (2*SHARD_SHM_CAPACITY + 7) //sent in several shared memory chunks
+
+void testShard();
+
+#endif //SHARD_TEST_H
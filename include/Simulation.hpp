@@ -4,40 +4,176 @@
 #include <array>
 #include <vector>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <functional>
 
 #include "NeuralNetwork.hpp"
+#include "DenseNetwork.hpp"
 #include "Rng.hpp"
 #include "Strategies.hpp"
 #include "Payoffs.hpp"
+#include "MarkovGame.hpp"
+#include "AssessmentPipeline.hpp"
+#include "Lineage.hpp"
+#include "Monitor.hpp"
+#include "Aggregator.hpp"
+#include "Mutation.hpp"
+#include "GenomeArchive.hpp"
+#include "SteadyState.hpp"
+#include "Profiler.hpp"
+#include "Metrics.hpp"
+#include "FitnessTree.hpp"
+#include "Shard.hpp"
+#include "Autotuner.hpp"
+#include "FitnessEstimator.hpp"
 
 #define POPULATION_SIZE 50
 #define NODE_FITNESS_PENALTY 0.01
+#define TOURNAMENT_STREAM_OFFSET (1ULL << 32) //RNG streams of parallel matches start after the pipeline's
+#define TOURNAMENT_BLOCK_MATCHES 64 //matches played on the same RNG stream by parallel tournaments
 
 
-/*Creates a population of individuals and runs the simulation steps as defined in the paper*/
-class Simulation
+/*Optional simulation modes (all disabled by default)*/
+struct SimulationSettings
+{
+	bool exact_payoffs = false; //use expected match results for pairs without context nodes
+	unsigned pipeline_workers = 0; //classify strategies on background threads (0 classifies in the main loop)
+	std::string lineage_file = ""; //file where the ancestry tree is written (empty disables tracking)
+	unsigned lineage_interval = 0; //generations between ancestry checkpoints (0 writes at the end only)
+	std::string monitor_name = ""; //name of the shared memory stats segment (empty disables monitoring)
+	std::string archive_file = ""; //file where population snapshots are written (empty disables the archive)
+	unsigned archive_interval = 1; //generations between population snapshots
+	bool extended_strategies = false; //classify into the extended registry instead of the classic strategies
+	bool exact_strategies = false; //classify networks without context nodes from their expected moves
+	MutationRates mutation_rates; //probability of mutating each class of network parameters
+	unsigned tournament_threads = 0; //play independent matches on threads (0 plays them in order, sharing memory)
+	bool autotune = false; //time up to tournament_threads threads on the first generations, then keep the fastest
+	std::string autotune_cache = ""; //file caching the autotuned choices (empty uses Autotuner::defaultCacheFile)
+	unsigned shards = 0; //play independent matches in worker processes (0 plays them in this process)
+	std::string shard_transport = "socket"; //channel between this process and its workers ("socket" or "shm")
+	unsigned steady_window = 0; //generations over which a steady state is detected (0 disables detection)
+	int steady_action = STEADY_ACTION_STOP; //what to do once steady (see STEADY_ACTION_* macros)
+	bool profile = false; //measure hardware counters around each phase of a generation
+	std::string metrics = ""; //metric collectors recorded instead of the classic outputs (see createCollectors)
+	bool moran = false; //replace one individual at a time (birth-death Moran process) instead of whole generations
+	bool variance_reduction = false; //play units of antithetic matches with common random numbers (see playReduced)
+	unsigned pair_matches = 1; //units per pair with variance reduction (2 give the fitness variance, more add a control variate)
+};
+
+/*Results of a sampled match between two players*/
+struct MatchResult
+{
+	int round_iterations = 0; //number of game iterations
+	unsigned long player_a_payoff_sum = 0; //sum of player A's payoffs
+	unsigned long player_b_payoff_sum = 0; //sum of player B's payoffs
+	int cooperations = 0; //number of cooperations (both players)
+	int defections = 0; //number of defections (both players)
+};
+
+//plays a match between two players with the given states, for a random number of game iterations
+template<typename Network>
+MatchResult playMatch(const Payoffs& game_payoffs, const Network& player_a, typename Network::State& state_a, 
+	const Network& player_b, typename Network::State& state_b);
+
+/*Results of every match between the current individuals, kept by the Moran process*/
+struct PairwiseResults
+{
+	typedef std::array<std::array<double, POPULATION_SIZE>, POPULATION_SIZE> Matrix;
+	
+	Matrix games; //game iterations of each pair (symmetric)
+	Matrix payoffs; //payoffs[a][b] is the sum of a's payoffs against b
+	Matrix cooperations; //cooperations of both players (symmetric)
+	Matrix defections; //defections of both players (symmetric)
+};
+
+
+
+/*Creates a population of individuals and runs the simulation steps as defined in the paper.
+Network is the type of individuals, usually a BasicNeuralNetwork of a given precision.
+By default matches are played one after the other and each network carries its state (the values
+of its context nodes) over from one match to the next. With tournament threads, every match starts
+from new states and draws from its own RNG stream, so matches are independent and the results do
+not depend on the number of threads, which autotuning picks from the timings of the first generations.
+With shards, worker processes play the tiles of the pair matrix (see ShardTile) from the genomes they
+are sent every generation, each tile on its own RNG stream, and only send back the sums of payoffs
+and game iterations of each individual, so the results do not depend on the number of workers either.
+A simulation is either run at once or stepped one generation at a time (start, step, finish), with
+an optional callback called after every generation.
+By default every generation's intelligence, fitness, cooperation and strategies are written. With
+metric collectors (settings.metrics, or added before start), strategies are only classified by the
+collectors that need them, and the collectors' outputs replace the classic ones.
+With steady state detection, the simulation either stops early once the population no longer changes,
+or fast-forwards: it skips the tournament and lets the population drift under mutation alone (uniform
+selection) until its structure diversifies again, or for at most one window before a new evaluation.
+In the Moran process, a generation is POPULATION_SIZE birth-death events: a parent is selected with
+probability proportional to its fitness (see FitnessTree), and its mutated offspring replaces a random
+individual. Every match starts from new states and its results are kept, so that each event only
+replays the newcomer's matches, after which every fitness has changed and the tree is rebuilt.
+Generations are assessed before their events, as without Moran process.
+With variance reduction, every pair plays units of two matches from new states, whose lengths have the
+tail probabilities u and 1 - u (antithetic), and every pair draws the same u and decisions in a unit
+(common random numbers), so that fitness differences come from the strategies rather than the draws.
+The fitness estimates (see FitnessEstimator) and their sampling variance are then independent of the
+number of tournament threads.*/
+template<typename Network>
+class BasicSimulation
 {
 	private:
 		///Game
 		const Payoffs& game_payoffs; //payoffs to use depending on game outcomes
+		const SimulationSettings settings; //optional simulation modes
 		
 		///Strategy evaluation
 		Strategies strats; //pure strategy evaluator
+		std::unique_ptr<AssessmentPipeline<Network>> pipeline; //background strategy classification (if enabled)
+		std::unique_ptr<Lineage> lineage; //ancestry tree of the population (if enabled)
+		std::unique_ptr<Monitor> monitor; //live stats for external readers (if enabled)
+		std::unique_ptr<GenomeArchiveWriter> archive; //population snapshots (if enabled)
+		std::unique_ptr<PhaseProfiler> profiler; //hardware counters of each phase (if enabled)
+		std::unique_ptr<PairwiseResults> pair_results; //results of the current matches (Moran process only)
+		std::unique_ptr<FitnessTree> fitness_tree; //selection weights of the individuals (Moran process only)
+		std::unique_ptr<ShardPool> shard_pool; //worker processes playing the tournament (if enabled)
+		std::vector<ShardTile> shard_tiles; //tiles of the pair matrix, dealt to the workers in turn
+		std::unique_ptr<Autotuner> autotuner; //chooses the number of tournament threads (if enabled)
+		std::unique_ptr<FitnessEstimator> fitness_estimator; //variance reduced fitness estimates (if enabled)
+		std::vector<std::unique_ptr<MetricCollector<Network>>> collectors; //metrics recorded every generation
 		
 		///Neural Networks
-		NeuralNetwork* nn_population[POPULATION_SIZE]; //dynamically allocated NNs
+		Network* nn_population[POPULATION_SIZE]; //dynamically allocated NNs
+		Network* spare_population[POPULATION_SIZE]; //previous generation, overwritten by the next one (without pipeline)
+		MutationEngine<Network> mutation_engine; //mutates the whole population at once
+		unsigned tournament_threads; //threads of the current tournament (see settings.tournament_threads)
+		
+		///Progress
+		unsigned long total_generations = 0; //number of generations the simulation was started for
+		std::function<void(const GenerationView<Network>&)> generation_callback; //called after every generation
+		
+		bool classic_outputs = true; //the population is classified every generation (no collector)
+		
+		///Steady state
+		std::unique_ptr<SteadyStateDetector> steady_detector; //steady state detection (if enabled)
+		std::string steady_reason; //why the simulation stopped early (empty if it did not)
+		bool fast_forwarding = false; //the tournament is skipped
+		unsigned fast_forward_length = 0; //generations skipped since the last evaluated one
 		
 		///NN counters
-		unsigned long int nn_game_counts[POPULATION_SIZE]; //number of games played
-		unsigned long int nn_payoff_sums[POPULATION_SIZE]; //sum of all game payoffs
-		unsigned long int total_defections; //number of defections
-		unsigned long int total_cooperations; //number of cooperations
+		double nn_game_counts[POPULATION_SIZE]; //number of games played (expected number in exact mode)
+		double nn_payoff_sums[POPULATION_SIZE]; //sum of all game payoffs
+		double total_defections; //number of defections
+		double total_cooperations; //number of cooperations
 		
 		///Population history (output data)
 		std::vector<std::array<int, POPULATION_SIZE>> population_intelligence;
 		std::vector<std::array<double, POPULATION_SIZE>> population_fitness;
 		std::vector<std::array<double, 1>> cooperation_frequency;
-		std::vector<std::array<int, STRATEGIES_COUNT>> strategies_count;
+		std::vector<StrategyCounts> strategies_count;
+		std::vector<std::array<int, 1>> fast_forwarded; //1 for generations whose tournament was skipped
+		std::vector<std::array<double, 1>> fitness_variance; //mean sampling variance of the fitness (variance reduction only)
+		std::vector<std::array<double, 1>> effective_sample_size; //mean matches worth of each estimate (variance reduction only)
 		
 		///Game (re)initialization
 		void presetCounters(); //resets all neural network counters
@@ -45,20 +181,69 @@ class Simulation
 		///Game development
 		void playGeneration(); //play all games for the entire generation
 		void playEachOther(int playerAIndex, int playerBIndex); //play a number of rounds between two players
+		void playExpected(int playerAIndex, int playerBIndex); //add the expected results of a match between two players
+		void playIndependently(const std::vector<std::pair<int, int>>& pairs); //play matches on the tournament threads
+		void playReduced(const std::vector<std::pair<int, int>>& pairs); //play units of antithetic matches on the tournament threads
+		void playSharded(); //play the matches in the worker processes and add up their sums
+		void runShardWorker(unsigned shard, ShardChannel& channel); //loop of a worker process
+		
+		void addMatchResult(int playerAIndex, int playerBIndex, const MatchResult& result); //adds a match to the counters
+		
+		///Moran process
+		void playPairs(); //plays every pair once, keeping the results
+		MatchExpectation playNewMatch(int playerAIndex, int playerBIndex); //match with new states (or its expectation)
+		void setPairResult(int playerAIndex, int playerBIndex, const MatchExpectation& result); //replaces a pair's match
+		void moranGeneration(); //replaces POPULATION_SIZE individuals one at a time
 		
 		///Population assessment
+		double individualFitness(int index) const; //fitness from the current counters
 		void assessPopulation(); //generates all required output data from population
+		void classifyPopulation(); //counts the closest pure strategies of the population
+		void assessFastForward(); //assesses a generation whose tournament was skipped
+		void updateSteadyState(double structure_share); //detects steady states, stops or fast-forwards
 		
 		///Selection
 		void nextGeneration(); //replaces the current generation by the next one
 		
 		///Simulation output
-		void outputResults(); //prints the simulation results
+		void publishStats(unsigned long total_generations, bool finished); //updates the live stats
 	
 	public:
-		Simulation(const Payoffs& payoffs);
+		BasicSimulation(const Payoffs& payoffs, const SimulationSettings& sim_settings = SimulationSettings());
+		BasicSimulation(const BasicSimulation&) = delete;
+		BasicSimulation& operator=(const BasicSimulation&) = delete;
+		~BasicSimulation(); //deletes the population
 		
 		void run(unsigned int generations); //run the simulation for n generations
+		
+		///Stepping
+		void start(unsigned int generations); //prepares the simulation for at most n generations
+		void step(); //runs the next generation
+		void finish(); //completes the simulation's outputs (lineage, archive, classification)
+		unsigned long getGeneration() const; //number of generations run so far
+		bool isStopped() const; //true once a steady state stopped the simulation
+		const std::string& getSteadyReason() const; //why the simulation stopped (empty if it did not)
+		void setGenerationCallback(std::function<void(const GenerationView<Network>&)> callback);
+		void addCollector(std::unique_ptr<MetricCollector<Network>> collector); //records a metric (before start)
+		
+		void outputResults(); //prints the simulation results
+		void aggregateResults(Aggregator& aggregator) const; //adds the simulation results as a new replicate
+		
+		///Population history
+		const std::vector<std::array<int, POPULATION_SIZE>>& getPopulationIntelligence() const;
+		const std::vector<std::array<double, POPULATION_SIZE>>& getPopulationFitness() const;
+		const std::vector<std::array<double, 1>>& getCooperationFrequency() const;
+		const std::vector<StrategyCounts>& getStrategiesCount() const;
+		const std::vector<std::array<int, 1>>& getFastForwarded() const;
+		const std::vector<std::array<double, 1>>& getFitnessVariance() const; //empty without variance reduction
+		const std::vector<std::array<double, 1>>& getEffectiveSampleSize() const;
+		const Strategies& getStrategies() const; //registered pure strategies
 };
 
+///Available precisions
+typedef BasicSimulation<NeuralNetwork> Simulation;
+typedef BasicSimulation<FloatNeuralNetwork> FloatSimulation;
+typedef BasicSimulation<FixedNeuralNetwork> FixedSimulation;
+typedef BasicSimulation<DenseNetwork> DenseSimulation;
+
 #endif // SIMULATION_H
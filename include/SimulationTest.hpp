@@ -0,0 +1,32 @@
+#ifndef SIMULATION_TEST_H
+#define SIMULATION_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+#include "Simulation.hpp"
+#include "Payoffs.hpp"
+#include "Rng.hpp"
+#include "Statistics.hpp"
+
+#define SIMULATION_TEST_GENERATIONS 5
+#define SIMULATION_TEST_SEED 7
+#define SIMULATION_TEST_STEADY_SEED 4 //fast-forwards several times within SIMULATION_TEST_STEADY_GENERATIONS
+#define SIMULATION_TEST_STEADY_WINDOW 4
+#define SIMULATION_TEST_STEADY_GENERATIONS 60
+#define SIMULATION_TEST_SHARDS 3 //worker processes compared with a single one
+#define SIMULATION_TEST_AUTOTUNE_THREADS 4 //autotuned between 1, 2 and 4 threads
+#define SIMULATION_TEST_AUTOTUNE_CACHE "/tmp/coop-simulation-autotune-test.cache"
+#define SIMULATION_TEST_PAIR_MATCHES 3 //units of antithetic matches per pair with variance reduction
+#define SIMULATION_TEST_REDUCED_THREADS 3 //compared with a single thread with variance reduction
+#define SIMULATION_TEST_VARIANCE_UNITS 6 //units per pair whose reported variance is compared across seeds
+#define SIMULATION_TEST_VARIANCE_REPLICATES 40 //tournaments of the same population
+#define SIMULATION_TEST_VARIANCE_TOLERANCE 0.35 //largest relative difference of the reported and empirical variances
+
+void testSimulation();
+
+#endif //SIMULATION_TEST_H
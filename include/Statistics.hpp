@@ -0,0 +1,106 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include <array>
+
+#define KS_SERIES_TERMS 100
+#define GAMMA_MAX_ITERATIONS 500 //iterations of the incomplete gamma series and continued fraction
+#define GAMMA_EPSILON 1e-14 //relative accuracy of the incomplete gamma function
+#define P2_MARKERS 5 //number of markers of the P-square quantile estimator
+
+/*Descriptive statistics and hypothesis tests used to compare simulation outputs*/
+class Statistics
+{
+	public:
+		static double mean(const std::vector<double>& sample);
+		
+		//unbiased sample variance (0 for samples smaller than 2)
+		static double variance(const std::vector<double>& sample);
+		
+		//largest distance between the empirical distribution functions of both samples
+		static double ksStatistic(std::vector<double> sample_a, std::vector<double> sample_b);
+		
+		//asymptotic p-value of the two-sample Kolmogorov-Smirnov test
+		static double ksPValue(const std::vector<double>& sample_a, const std::vector<double>& sample_b);
+		
+		//chi-squared statistic of the homogeneity test between two rows of category counts
+		//(categories empty in both rows are ignored), the degrees of freedom are written to degrees
+		static double chiSquaredStatistic(const std::vector<double>& counts_a, const std::vector<double>& counts_b, int& degrees);
+		
+		//probability that a chi-squared variable with the given degrees of freedom exceeds the statistic
+		static double chiSquaredPValue(double statistic, int degrees);
+		
+		//p-value of the chi-squared homogeneity test between two rows of category counts
+		static double chiSquaredPValue(const std::vector<double>& counts_a, const std::vector<double>& counts_b);
+		
+		//regularized upper incomplete gamma function Q(a, x)
+		static double upperIncompleteGamma(double a, double x);
+};
+
+
+/*Streaming mean and variance (Welford's algorithm), numerically stable in one pass*/
+class RunningStats
+{
+	private:
+		unsigned long count = 0;
+		double running_mean = 0;
+		double squares = 0; //sum of squared differences from the mean
+	
+	public:
+		void add(double value);
+		
+		unsigned long getCount() const;
+		double mean() const; //0 if empty
+		double variance() const; //unbiased sample variance (0 for less than 2 values)
+};
+
+/*Streaming covariance of two paired variables, also in one pass*/
+class RunningCovariance
+{
+	private:
+		unsigned long count = 0;
+		double mean_x = 0;
+		double mean_y = 0;
+		double co_moment = 0; //sum of products of differences from the means
+	
+	public:
+		void add(double x, double y);
+		
+		unsigned long getCount() const;
+		double meanX() const;
+		double meanY() const;
+		double covariance() const; //unbiased sample covariance (0 for less than 2 pairs)
+};
+
+/*
+Streaming estimate of a quantile with constant memory (P-square algorithm, Jain & Chlamtac 1985).
+Five markers track the minimum, the maximum, the quantile and two intermediate quantiles; their
+heights are adjusted with a piecewise-parabolic interpolation as values arrive.
+The quantile is exact until P2_MARKERS values have been added.*/
+class P2Quantile
+{
+	private:
+		double probability; //quantile to estimate, in [0, 1]
+		unsigned long count = 0;
+		std::array<double, P2_MARKERS> heights; //marker heights (the first values while count < P2_MARKERS)
+		std::array<double, P2_MARKERS> positions; //actual marker positions (1-based)
+		std::array<double, P2_MARKERS> desired; //desired marker positions
+		std::array<double, P2_MARKERS> increments; //increments of the desired positions per value
+		
+		double parabolic(int marker, double direction) const;
+		double linear(int marker, double direction) const;
+	
+	public:
+		P2Quantile(double quantile_probability);
+		
+		void add(double value);
+		
+		unsigned long getCount() const;
+		double quantile() const; //0 if empty
+};
+
+#endif // STATISTICS_H
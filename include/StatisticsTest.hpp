@@ -0,0 +1,17 @@
+#ifndef STATISTICS_TEST_H
+#define STATISTICS_TEST_H
+
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "Statistics.hpp"
+#include "Rng.hpp"
+
+#define STATISTICS_TEST_SAMPLE_SIZE 500
+
+void testStatistics();
+
+#endif //STATISTICS_TEST_H
@@ -0,0 +1,55 @@
+#ifndef STEADYSTATE_H
+#define STEADYSTATE_H
+
+#include <deque>
+#include <map>
+#include <utility>
+#include <string>
+#include <cassert>
+
+#include "NeuralNetwork.hpp"
+
+/*Limits within which the population is considered steady*/
+#define STEADY_COOPERATION_TOLERANCE 0.02 //largest drift of cooperation frequency over the window
+#define STEADY_INTELLIGENCE_TOLERANCE 0.2 //largest drift of mean inner nodes over the window
+#define STEADY_STRUCTURE_SHARE 0.8 //smallest share of the population with the most common structure
+
+/*What a simulation does once its population is steady*/
+#define STEADY_ACTION_STOP 0 //stop the simulation, recording the reason
+#define STEADY_ACTION_FAST_FORWARD 1 //skip the tournament until diversity reappears
+
+/*
+Detects when a population no longer changes, from a sliding window over the last evaluated generations.
+Value mutations alter nearly every genome at each generation, so the genomes are never all identical:
+diversity is measured on the structure instead (the share of the most common pair of cognitive and
+context node counts). Sampled matches make the cooperation frequency noisy, so metrics are compared
+between the two halves of the window: the population is steady when the share averages at least
+STEADY_STRUCTURE_SHARE and the means of cooperation frequency and intelligence drift by less than
+their tolerances.*/
+class SteadyStateDetector
+{
+	private:
+		unsigned window; //number of generations considered
+		std::deque<double> cooperation_window; //cooperation frequency of the last generations
+		std::deque<double> intelligence_window; //mean inner nodes of the last generations
+		std::deque<double> structure_window; //share of the most common structure in the last generations
+		
+		static double drift(const std::deque<double>& values); //difference between the means of both halves
+		static double mean(const std::deque<double>& values);
+	
+	public:
+		SteadyStateDetector(unsigned window_size);
+		
+		//share of the population whose structure is the most common one
+		template<typename Network>
+		static double structureShare(Network* const* population, int population_size);
+		
+		//adds an evaluated generation, returns true if the population is steady
+		bool update(double cooperation_frequency, double mean_intelligence, double structure_share);
+		
+		bool isSteady() const;
+		void reset(); //forgets the previous generations (after the population has changed)
+		std::string describe() const; //why the population is considered steady
+};
+
+#endif // STEADYSTATE_H
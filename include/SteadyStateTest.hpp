@@ -0,0 +1,14 @@
+#ifndef STEADYSTATE_TEST_H
+#define STEADYSTATE_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "SteadyState.hpp"
+
+#define STEADY_TEST_WINDOW 20
+#define STEADY_TEST_POPULATION 10
+
+void testSteadyState();
+
+#endif //STEADYSTATE_TEST_H
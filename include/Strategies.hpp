@@ -2,6 +2,9 @@
 #define STRATEGIES_H
 
 #include <array>
+#include <vector>
+#include <string>
+#include <bitset>
 
 #include "NeuralNetwork.hpp"
 #include "Rng.hpp"
@@ -10,53 +13,124 @@
 /*Assessments are games against a virtual opponent*/
 #define ASSESSMENT_SIZE 20
 #define ASSESSMENT_COUNT 5
-#define ASSESSMENT_PREV_CHOICES 2
 #define ASSESSMENT_PROB_STEP 0.25
 
-/*List of pure strategies and their unique index*/
+/*Index of the classic pure strategies (the first ones of every registry)*/
 #define STRATEGIES_ALWAYS_DEFECT 0
 #define STRATEGIES_ALWAYS_COOPERATE 1
 #define STRATEGIES_TIT_FOR_TAT 2
 #define STRATEGIES_TIT_FOR_TWO_TATS 3
 #define STRATEGIES_PAVLOV_LIKE 4
-#define STRATEGIES_COUNT 5
+#define STRATEGIES_CLASSIC_COUNT 5
+#define STRATEGIES_MAX 32 //largest number of registered strategies
+
+/*Weights of both distances between a player and a pure strategy (each distance is in [0, 1])*/
+#define STRATEGIES_HAMMING_WEIGHT 1.0 //fraction of different moves
+#define STRATEGIES_RATE_WEIGHT 1.0 //mean squared difference of the cooperation rate per assessment
+#define STRATEGIES_GENEROSITY (1.0/3.0) //cooperation probability of generous tit for tat after a defection
+
+/*Number of individuals per pure strategy (only the first getStrategyCount() entries are used)*/
+typedef std::array<int, STRATEGIES_MAX> StrategyCounts;
+
+/*Moves of a player against every virtual opponent, one bit per move (set for cooperation)*/
+typedef std::bitset<ASSESSMENT_COUNT * ASSESSMENT_SIZE> MoveSequence;
+
+/*Probability that a player cooperates at each move against every virtual opponent*/
+typedef std::array<double, ASSESSMENT_COUNT * ASSESSMENT_SIZE> ExpectedMoves;
+
+/*
+A pure strategy as a small state machine: each state cooperates with a given probability 
+(0 or 1 for deterministic strategies), and the next state depends on the opponent's move.*/
+struct StrategyMachine
+{
+	std::string name;
+	int initial_state;
+	std::vector<double> cooperation; //cooperation probability of each state
+	std::vector<std::array<int, 2>> transitions; //next state after the opponent defects [0] or cooperates [1]
+};
 
 /*
 Defines multiple decision patterns called "strategies", which allow us to categorize NeuralNetworks.
 To assess a NeuralNetwork's strategy, the class defines a fixed sequence of randomly chosen choices
 that will be used as a "virtual opponent" for the NeuralNetwork.
 It then defines what "pure strategies" would choose (in terms of collaborations/defections) 
-if they faced this exact "virtual opponent". These strategies are the following:
+if they faced this exact "virtual opponent". The classic strategies are the following:
 - "always cooperate" always cooperates
 - "always defect" always defects
-- "tit for tat" imitates the opponent's previous decision (first choice is random)
+- "tit for tat" imitates the opponent's previous decision (first choice is cooperation)
 - "tit for two tats" responds to two sequential defections with a defection, otherwise cooperates
 - "pavlov-like" cooperates when two players previously made the same choice, defects otherwise
+More strategies can be registered, up to STRATEGIES_MAX (see extendedStrategies).
 
 To assess a NeuralNetwork, it makes it play against the same "virtual opponent" and stores its
-move sequence, then compares it to the pure strategie's move sequences to find which one is closest.*/
+move sequence, then compares it to the pure strategie's move sequences to find which one is closest.
+Move sequences are bitsets, so that the distance to each deterministic strategy is a few popcounts.
+Stochastic strategies (such as "generous tit for tat") are not sampled: their cooperation probability
+at each move is stored, and a player is compared to them with the expected distance.
+With exact classification, networks without context nodes are not sampled: the probability of each
+of their moves only depends on their previous move and the opponent's, so their expected moves are
+computed exactly from the 4 possible outcomes, and compared to the strategies' expected distances.
+Their classification is then deterministic and draws no random value.*/
 class Strategies
 {
 	private:
 		const Payoffs& game_payoffs; //payoffs to use depending on game outcomes
-	
+		const bool exact_classification; //networks without context nodes are classified from their expected moves
+		
 		//random choices used for assessment
-		bool opponent_choices[ASSESSMENT_COUNT][ASSESSMENT_SIZE + ASSESSMENT_PREV_CHOICES];
+		bool opponent_choices[ASSESSMENT_COUNT][ASSESSMENT_SIZE];
+		
+		//bits of each assessment in a move sequence
+		std::array<MoveSequence, ASSESSMENT_COUNT> assessment_masks;
 		
-		///Pure strategies and player's average cooperation per assessment
-		std::array<std::array<double, ASSESSMENT_COUNT>, STRATEGIES_COUNT> strats_avg_coop;
-		std::array<double, ASSESSMENT_COUNT> player_avg_coop;
+		///Pure strategies
+		std::vector<StrategyMachine> machines;
+		std::vector<MoveSequence> strats_moves; //most likely moves against the virtual opponent
+		std::vector<ExpectedMoves> strats_expected; //cooperation probability of each move
+		std::vector<bool> strats_stochastic; //some moves are neither certain cooperations nor defections
+		std::vector<std::array<double, ASSESSMENT_COUNT>> strats_avg_coop; //average cooperation per assessment
 		
-		void initStrategies(); //initialize choice sequences and pure strategies
+		void initOpponent(); //initialize the virtual opponent's choices
+		void initStrategy(const StrategyMachine& machine); //compute a pure strategy's moves (draws no random value)
 		
-		int compareChoices(); //compares the player's choices to each pure strategy
+		//returns the index of the strategy closest to the player's moves
+		int compareChoices(const MoveSequence& player_moves) const;
+		int compareExpectedChoices(const ExpectedMoves& player_moves) const;
+		
+		//distance to a strategy given the fraction of different moves and the player's cooperation rates
+		double strategyDistance(std::size_t strat_index, double hamming, 
+			const std::array<double, ASSESSMENT_COUNT>& player_avg_coop) const;
 		
 	public:
-		Strategies(const Payoffs& payoffs);
+		Strategies(const Payoffs& payoffs, const std::vector<StrategyMachine>& strategies = classicStrategies(), 
+			bool exact = false);
+		
+		static std::vector<StrategyMachine> classicStrategies(); //the strategies of the original paper
+		static std::vector<StrategyMachine> extendedStrategies(); //classic strategies followed by well-known others
+		
+		int getStrategyCount() const;
+		const std::string& getStrategyName(int strat_index) const;
+		const MoveSequence& getStrategyMoves(int strat_index) const; //most likely moves (cooperation on ties)
+		const ExpectedMoves& getStrategyExpectedMoves(int strat_index) const;
+		bool isExact() const; //networks without context nodes are classified exactly
+		
+		//returns the player's closest pure strategy (can be called from multiple threads)
+		template<typename Network>
+		int closestPureStrategy(Network& player) const;
+		
+		//same with the given state, without modifying the player (can be called from multiple threads)
+		template<typename Network>
+		int closestPureStrategy(const Network& player, typename Network::State& state) const;
 		
-		//returns the player's closest pure strategy
-		int closestPureStrategy(NeuralNetwork& player);
+		//moves of the player against the virtual opponent
+		template<typename Network>
+		MoveSequence playAssessments(Network& player) const;
+		template<typename Network>
+		MoveSequence playAssessments(const Network& player, typename Network::State& state) const;
 		
+		//cooperation probabilities of a player without context nodes against the virtual opponent
+		template<typename Network>
+		ExpectedMoves expectAssessments(const Network& player) const;
 };
 
 #endif //STRATEGIES_H
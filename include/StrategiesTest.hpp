@@ -3,11 +3,17 @@
 
 #include <iostream>
 #include <cassert>
+#include <cmath>
+#include <limits>
 
 #include "Strategies.hpp"
 #include "Payoffs.hpp"
+#include "MarkovGame.hpp"
 
 #define STRATEGIES_TEST_SAMPLE_SIZE 100
+#define STRATEGIES_TEST_EXACT_NETWORKS 10 //networks without context nodes compared to their sampled moves
+#define STRATEGIES_TEST_EXACT_PLAYS 2000 //sampled assessments per network
+#define STRATEGIES_TEST_EXACT_TOLERANCE 0.06 //largest difference between sampled and expected cooperation
 
 void testStrategies();
 
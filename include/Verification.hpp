@@ -0,0 +1,96 @@
+#ifndef VERIFICATION_H
+#define VERIFICATION_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include "Simulation.hpp"
+#include "Statistics.hpp"
+#include "Payoffs.hpp"
+#include "Rng.hpp"
+
+/*Equivalence criteria on the per-replicate averages of each metric*/
+#define VERIFICATION_ALPHA 0.01 //KS and chi-squared tests fail below this p-value
+#define VERIFICATION_Z 2.326 //one-sided normal quantile for 1 - VERIFICATION_ALPHA
+#define VERIFICATION_COOPERATION_MARGIN 0.05 //largest accepted difference in cooperation frequency
+#define VERIFICATION_INTELLIGENCE_MARGIN 0.5 //largest accepted difference in mean inner nodes
+
+/*Settings of the configurations checked by the verify command*/
+#define VERIFICATION_PIPELINE_WORKERS 4 //compared with a single worker
+#define VERIFICATION_TOURNAMENT_THREADS 4 //compared with a single thread
+#define VERIFICATION_SHARDS 3 //worker processes compared with a single one (over shared memory)
+#define VERIFICATION_PAIR_MATCHES 3 //units per pair of the variance reduced tournaments
+#define VERIFICATION_LINEAGE_PREFIX "/tmp/coop-verify-lineage-" //followed by the process id, so that runs do not collide
+#define VERIFICATION_ARCHIVE_PREFIX "/tmp/coop-verify-archive-"
+
+/*Per-generation population averages of one simulation run*/
+struct Trajectory
+{
+	std::vector<double> cooperation; //cooperation frequency
+	std::vector<double> intelligence; //mean number of inner nodes
+	std::vector<StrategyCounts> strategies; //closest pure strategy counts
+};
+
+/*Comparison of one metric between a reference and a candidate configuration*/
+struct ComparisonResult
+{
+	std::string metric;
+	std::string test; //"KS" for time averages, "chi-squared" for strategies
+	double reference_mean = 0; //mean over replicates of the metric's time average (KS only)
+	double candidate_mean = 0;
+	double difference_bound = 0; //upper confidence bound of |candidate - reference| (KS only)
+	double margin = 0; //equivalence margin for the metric (KS only)
+	double p_value; //p-value of the test
+	bool equivalent; //test passes and, for KS, the difference bound is within the margin
+};
+
+/*
+Runs replicated simulations of different configurations (such as network precisions) and checks
+whether their population trajectories are statistically equivalent. Each replicate is summarized by
+the time average of each metric; the replicates of both configurations are then compared with a
+Kolmogorov-Smirnov test and a bound on the difference of their means. Strategies are compared by
+the dominant strategy of each replicate, with a chi-squared homogeneity test.
+Configurations that must not change the results (same seeds) are instead checked for identity.*/
+class Verification
+{
+	public:
+		//runs one simulation with the given seed and returns its trajectory
+		template<typename Network>
+		static Trajectory runTrajectory(const Payoffs& payoffs, const SimulationSettings& settings, 
+			unsigned generations, unsigned seed);
+		
+		//runs replicates with consecutive seeds starting at first_seed
+		template<typename Network>
+		static std::vector<Trajectory> runReplicates(const Payoffs& payoffs, const SimulationSettings& settings,
+			unsigned generations, unsigned replicates, unsigned first_seed);
+		
+		//compares the time averages of a metric between two sets of replicates
+		static ComparisonResult compare(const std::string& metric, const std::vector<double>& reference,
+			const std::vector<double>& candidate, double margin);
+		
+		//compares the dominant strategies of two sets of replicates
+		static ComparisonResult compareStrategies(const std::vector<Trajectory>& reference,
+			const std::vector<Trajectory>& candidate);
+		
+		//compares every metric of two sets of replicates
+		static std::vector<ComparisonResult> compareTrajectories(const std::vector<Trajectory>& reference,
+			const std::vector<Trajectory>& candidate);
+		
+		//strategy with the largest count over the whole trajectory
+		static int dominantStrategy(const Trajectory& trajectory);
+		
+		//first generation where the trajectories differ (-1 if they are identical)
+		static long firstDifference(const Trajectory& reference, const Trajectory& candidate);
+		
+		//prints the comparison results, returns true if all metrics are equivalent
+		static bool printComparison(const std::string& title, const std::vector<ComparisonResult>& results);
+		
+		//prints whether each candidate replicate is identical to its reference, returns true if all are
+		static bool printIdentity(const std::string& title, const std::vector<Trajectory>& reference,
+			const std::vector<Trajectory>& candidate);
+};
+
+#endif // VERIFICATION_H
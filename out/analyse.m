@@ -25,8 +25,8 @@ function analyse(file_base, file_count)
     generations = size(pop_intelligence);
     generations = generations(1);
     
-    %Pool together tit-for-tat and tit-for-two tats strategies
-    strategies_count = [strategies_count(:,1:2) (strategies_count(:,3) + strategies_count(:,4)) strategies_count(:,5)];
+    %Pool together tit-for-tat and tit-for-two tats strategies (other registered strategies follow)
+    strategies_count = [strategies_count(:,1:2) (strategies_count(:,3) + strategies_count(:,4)) strategies_count(:,5:end)];
     
     %Calculate average population intelligence and fitness
     avg_intelligence = mean(pop_intelligence, 2);
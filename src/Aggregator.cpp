@@ -0,0 +1,225 @@
+#include "Aggregator.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+
+GenerationAggregate::GenerationAggregate()
+{
+	for (double probability : AGGREGATE_QUANTILES) {
+		intelligence_quantiles.emplace_back(probability);
+		cooperation_quantiles.emplace_back(probability);
+	}
+}
+
+
+/**---------- Feeding ----------**/
+
+GenerationAggregate& Aggregator::generation(std::size_t index)
+{
+	if (index >= generations.size()) generations.resize(index + 1);
+	return generations[index];
+}
+
+void Aggregator::beginReplicate()
+{
+	replicates++;
+	replicate_intelligence.clear();
+}
+
+/*Averages the population and computes its selection for intelligence in one pass (skipped if the mean fitness is 0)*/
+void Aggregator::addPopulation(std::size_t generation_index, const int* intelligence, const double* fitness, int population_size)
+{
+	RunningCovariance population;
+	for (int i=0; i<population_size; ++i) {
+		population.add(intelligence[i], fitness[i]);
+	}
+	
+	GenerationAggregate& current = generation(generation_index);
+	current.intelligence.add(population.meanX());
+	current.fitness.add(population.meanY());
+	if (population.meanY() != 0) //undefined without mean fitness (possible with negative payoffs or node penalties)
+		current.selection.add(population.covariance() / population.meanY());
+	for (P2Quantile& quantile : current.intelligence_quantiles) quantile.add(population.meanX());
+	
+	//kept until the cooperation of the generation is added
+	overall_intelligence.add(population.meanX());
+	if (generation_index >= replicate_intelligence.size()) replicate_intelligence.resize(generation_index + 1);
+	replicate_intelligence[generation_index] = population.meanX();
+}
+
+void Aggregator::addCooperation(std::size_t generation_index, double cooperation_frequency)
+{
+	GenerationAggregate& current = generation(generation_index);
+	current.cooperation.add(cooperation_frequency);
+	for (P2Quantile& quantile : current.cooperation_quantiles) quantile.add(cooperation_frequency);
+	
+	overall_cooperation.add(cooperation_frequency);
+	if (generation_index < replicate_intelligence.size())
+		intelligence_cooperation.add(replicate_intelligence[generation_index], cooperation_frequency);
+}
+
+/*Pools tit for two tats with tit for tat, following strategies keep their order*/
+void Aggregator::addStrategies(std::size_t generation_index, const int* strategies_count, int strategy_count)
+{
+	std::vector<int> pooled;
+	for (int strat_index=0; strat_index<strategy_count; ++strat_index) {
+		if (strat_index == STRATEGIES_TIT_FOR_TWO_TATS) pooled[STRATEGIES_TIT_FOR_TAT] += strategies_count[strat_index];
+		else pooled.push_back(strategies_count[strat_index]);
+	}
+	
+	GenerationAggregate& current = generation(generation_index);
+	if (current.strategies.size() < pooled.size()) current.strategies.resize(pooled.size());
+	for (std::size_t pooled_index=0; pooled_index<pooled.size(); ++pooled_index) {
+		current.strategies[pooled_index].add(pooled[pooled_index]);
+	}
+	pooled_strategy_count = std::max(pooled_strategy_count, static_cast<int>(pooled.size()));
+}
+
+
+/**---------- Simulation output ----------**/
+
+/*Reads the matrices written by Simulation::outputResults line by line.
+Only the intelligence matrix is buffered, until the fitness of the same generations is read.*/
+void Aggregator::readOutput(std::istream& input)
+{
+	beginReplicate();
+	
+	std::string line, name;
+	std::size_t rows = 0;
+	std::vector<double> intelligence_rows;
+	
+	while (std::getline(input, line)) {
+		if (line.compare(0, 8, "# name: ") == 0) {
+			name = line.substr(8);
+		}
+		else if (line.compare(0, 8, "# rows: ") == 0) {
+			rows = std::stoul(line.substr(8));
+		}
+		else if (line.compare(0, 11, "# columns: ") == 0) {
+			readMatrix(input, name, rows, std::stoul(line.substr(11)), intelligence_rows);
+		}
+	}
+}
+
+void Aggregator::readMatrix(std::istream& input, const std::string& name, std::size_t rows, std::size_t columns,
+	std::vector<double>& intelligence_rows)
+{
+	std::vector<double> row(columns);
+	std::vector<int> int_row(columns);
+	
+	for (std::size_t row_index=0; row_index<rows; ++row_index) {
+		for (std::size_t col=0; col<columns; ++col) {
+			if (not (input >> row[col]))
+				throw std::runtime_error("Aggregator: truncated matrix " + name);
+		}
+		
+		if (name == "pop_intelligence") {
+			intelligence_rows.insert(intelligence_rows.end(), row.begin(), row.end());
+		}
+		else if (name == "pop_fitness") {
+			if (intelligence_rows.size() < (row_index + 1) * columns)
+				throw std::runtime_error("Aggregator: pop_fitness does not match pop_intelligence");
+			for (std::size_t col=0; col<columns; ++col) {
+				int_row[col] = static_cast<int>(intelligence_rows[row_index * columns + col]);
+			}
+			addPopulation(row_index, int_row.data(), row.data(), static_cast<int>(columns));
+		}
+		else if (name == "cooperation_freq") {
+			addCooperation(row_index, row[0]);
+		}
+		else if (name == "strategies_count") {
+			for (std::size_t col=0; col<columns; ++col) int_row[col] = static_cast<int>(row[col]);
+			addStrategies(row_index, int_row.data(), static_cast<int>(columns));
+		}
+	}
+	
+	//the intelligence matrix is no longer needed once the fitness is read
+	if (name == "pop_fitness") std::vector<double>().swap(intelligence_rows);
+}
+
+void Aggregator::readFile(const std::string& file_name)
+{
+	std::ifstream input(file_name.c_str());
+	if (not input)
+		throw std::runtime_error("Aggregator: cannot open file " + file_name);
+	
+	readOutput(input);
+}
+
+
+/**---------- Summary ----------**/
+
+unsigned long Aggregator::getReplicates() const
+{
+	return replicates;
+}
+
+std::size_t Aggregator::getGenerations() const
+{
+	return generations.size();
+}
+
+const GenerationAggregate& Aggregator::getGeneration(std::size_t index) const
+{
+	return generations.at(index);
+}
+
+double Aggregator::getIntelligenceCooperationCorrelation() const
+{
+	double deviations = std::sqrt(overall_intelligence.variance() * overall_cooperation.variance());
+	return (deviations > 0) ? intelligence_cooperation.covariance() / deviations : 0;
+}
+
+/*Writes one row per generation, in the same octave text format as the simulation output*/
+void Aggregator::write(std::ostream& output) const
+{
+	std::ostringstream quantile_names;
+	for (double probability : AGGREGATE_QUANTILES) quantile_names << ", q" << probability;
+	
+	output << "# name: replicates\n";
+	output << "# type: scalar\n";
+	output << replicates << "\n\n";
+	
+	output << "# SUMMARY columns are [generation, replicates, "
+		<< "intelligence mean, variance" << quantile_names.str() << ", "
+		<< "cooperation mean, variance" << quantile_names.str() << ", "
+		<< "fitness mean, variance, selection for intelligence mean, variance]\n";
+	output << "# name: summary\n";
+	output << "# type: matrix\n";
+	output << "# rows: " << generations.size() << "\n";
+	output << "# columns: " << 10 + 2 * AGGREGATE_QUANTILE_COUNT << "\n";
+	for (std::size_t index=0; index<generations.size(); ++index) {
+		const GenerationAggregate& current = generations[index];
+		output << index + 1 << " " << current.intelligence.getCount() << " ";
+		output << current.intelligence.mean() << " " << current.intelligence.variance() << " ";
+		for (const P2Quantile& quantile : current.intelligence_quantiles) output << quantile.quantile() << " ";
+		output << current.cooperation.mean() << " " << current.cooperation.variance() << " ";
+		for (const P2Quantile& quantile : current.cooperation_quantiles) output << quantile.quantile() << " ";
+		output << current.fitness.mean() << " " << current.fitness.variance() << " ";
+		if (current.selection.getCount() > 0) output << current.selection.mean() << " " << current.selection.variance() << "\n";
+		else output << "NaN NaN\n"; //no replicate with a mean fitness
+	}
+	output << "\n";
+	
+	output << "# STRATEGIES are the simulation's strategies with tit for two tats counted as tit for tat, mean count per replicate\n";
+	output << "# name: strategies_mean\n";
+	output << "# type: matrix\n";
+	output << "# rows: " << generations.size() << "\n";
+	output << "# columns: " << pooled_strategy_count << "\n";
+	for (const GenerationAggregate& current : generations) {
+		for (int pooled_index=0; pooled_index<pooled_strategy_count; ++pooled_index) {
+			bool counted = pooled_index < static_cast<int>(current.strategies.size());
+			output << (counted ? current.strategies[pooled_index].mean() : 0) << " ";
+		}
+		output << "\n";
+	}
+	output << "\n";
+	
+	output << "# name: intelligence_cooperation_correlation\n";
+	output << "# type: scalar\n";
+	output << getIntelligenceCooperationCorrelation() << "\n\n";
+}
@@ -0,0 +1,75 @@
+#include "AggregatorTest.hpp"
+
+
+void testAggregator()
+{
+	std::cout << "Testing Aggregator...";
+	
+	///Selection for intelligence of a known population
+	Aggregator single;
+	single.beginReplicate();
+	int intelligence[4] = {0, 1, 2, 3};
+	double fitness[4] = {1, 2, 3, 4};
+	int strategies[STRATEGIES_CLASSIC_COUNT] = {1, 0, 1, 1, 1};
+	single.addPopulation(0, intelligence, fitness, 4);
+	single.addCooperation(0, 0.5);
+	single.addStrategies(0, strategies, STRATEGIES_CLASSIC_COUNT);
+	
+	const GenerationAggregate& first = single.getGeneration(0);
+	assert(first.intelligence.mean() == 1.5);
+	assert(first.fitness.mean() == 2.5);
+	assert(std::fabs(first.selection.mean() - (5.0/3.0) / 2.5) < 1e-12);
+	assert(first.strategies[STRATEGIES_TIT_FOR_TAT].mean() == 2); //both tit for tat variants are pooled
+	assert(first.strategies.size() == STRATEGIES_CLASSIC_COUNT - 1);
+	assert(first.strategies.back().mean() == 1);
+	
+	//selection is undefined without mean fitness, and written as NaN
+	double no_fitness[4] = {-1, 1, -2, 2};
+	single.addPopulation(1, intelligence, no_fitness, 4);
+	single.addCooperation(1, 0.5);
+	assert(single.getGeneration(1).selection.getCount() == 0 and single.getGeneration(1).fitness.mean() == 0);
+	std::ostringstream single_output;
+	single.write(single_output);
+	assert(single_output.str().find("NaN NaN\n") != std::string::npos);
+	
+	///Live results and text output give the same summary
+	const Payoffs payoffs = Payoffs::getPayoffsForGameType("IPD");
+	Aggregator live, parsed;
+	for (int replicate=0; replicate<AGGREGATOR_TEST_REPLICATES; ++replicate) {
+		Simulation sim(payoffs);
+		sim.run(AGGREGATOR_TEST_GENERATIONS);
+		sim.aggregateResults(live);
+		
+		//the output is written with std::cout
+		std::stringstream output;
+		std::streambuf* cout_buffer = std::cout.rdbuf(output.rdbuf());
+		sim.outputResults();
+		std::cout.rdbuf(cout_buffer);
+		parsed.readOutput(output);
+	}
+	
+	assert(live.getReplicates() == AGGREGATOR_TEST_REPLICATES and parsed.getReplicates() == AGGREGATOR_TEST_REPLICATES);
+	assert(live.getGenerations() == AGGREGATOR_TEST_GENERATIONS and parsed.getGenerations() == AGGREGATOR_TEST_GENERATIONS);
+	for (int generation=0; generation<AGGREGATOR_TEST_GENERATIONS; ++generation) {
+		const GenerationAggregate& live_generation = live.getGeneration(generation);
+		const GenerationAggregate& parsed_generation = parsed.getGeneration(generation);
+		assert(live_generation.intelligence.mean() == parsed_generation.intelligence.mean());
+		assert(std::fabs(live_generation.cooperation.mean() - parsed_generation.cooperation.mean()) < 1e-5);
+		assert(std::fabs(live_generation.fitness.mean() - parsed_generation.fitness.mean()) < 1e-5);
+		assert(live_generation.strategies[0].mean() == parsed_generation.strategies[0].mean());
+	}
+	assert(std::fabs(live.getIntelligenceCooperationCorrelation() - parsed.getIntelligenceCooperationCorrelation()) < 1e-3);
+	
+	///Malformed outputs are rejected
+	std::istringstream truncated("# name: cooperation_freq\n# type: matrix\n# rows: 2\n# columns: 1\n0.5\n");
+	bool rejected = false;
+	try {
+		parsed.readOutput(truncated);
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	assert(rejected);
+	
+	std::cout << " done!" << std::endl;
+}
@@ -0,0 +1,120 @@
+#include "Allocations.hpp"
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+static std::atomic<bool> counting(false);
+static std::atomic<std::uint64_t> allocation_count(0);
+static std::atomic<std::uint64_t> allocated_bytes(0);
+static std::atomic<std::int64_t> live_bytes(0);
+static std::atomic<std::int64_t> peak_live_bytes(0);
+
+
+bool AllocationCounter::isCompiled()
+{
+#ifdef COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+void AllocationCounter::enable()
+{
+	counting.store(isCompiled(), std::memory_order_relaxed);
+}
+
+AllocationStats AllocationCounter::read()
+{
+	AllocationStats stats;
+	stats.allocations = allocation_count.load(std::memory_order_relaxed);
+	stats.bytes = allocated_bytes.load(std::memory_order_relaxed);
+	stats.live_bytes = live_bytes.load(std::memory_order_relaxed);
+	stats.peak_live_bytes = peak_live_bytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void AllocationCounter::resetPeak()
+{
+	peak_live_bytes.store(live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+
+#ifdef COUNT_ALLOCATIONS
+
+/*Allocates a block with its size in a header, counting it if enabled*/
+static void* countedAllocation(std::size_t size)
+{
+	char* block = static_cast<char*>(std::malloc(size + ALLOCATION_HEADER_SIZE));
+	if (block == nullptr) return nullptr;
+	*reinterpret_cast<std::size_t*>(block) = size;
+	
+	if (counting.load(std::memory_order_relaxed)) {
+		allocation_count.fetch_add(1, std::memory_order_relaxed);
+		allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+		std::int64_t live = live_bytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed) 
+			+ static_cast<std::int64_t>(size);
+		std::int64_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+		while (live > peak and not peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+	}
+	return block + ALLOCATION_HEADER_SIZE;
+}
+
+/*Frees a block allocated by countedAllocation (blocks allocated before counting was enabled 
+are subtracted too, so live bytes are relative to the moment counting started)*/
+static void countedDeallocation(void* pointer)
+{
+	if (pointer == nullptr) return;
+	char* block = static_cast<char*>(pointer) - ALLOCATION_HEADER_SIZE;
+	
+	if (counting.load(std::memory_order_relaxed))
+		live_bytes.fetch_sub(static_cast<std::int64_t>(*reinterpret_cast<std::size_t*>(block)), std::memory_order_relaxed);
+	std::free(block);
+}
+
+void* operator new(std::size_t size)
+{
+	void* pointer = countedAllocation(size);
+	if (pointer == nullptr) throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+	void* pointer = countedAllocation(size);
+	if (pointer == nullptr) throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocation(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocation(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	countedDeallocation(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	countedDeallocation(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	countedDeallocation(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	countedDeallocation(pointer);
+}
+
+#endif // COUNT_ALLOCATIONS
@@ -0,0 +1,108 @@
+#include "AssessmentPipeline.hpp"
+#include "DenseNetwork.hpp"
+
+
+/*Constructor, starts the worker threads*/
+template<typename Network>
+AssessmentPipeline<Network>::AssessmentPipeline(const Strategies& strategies, unsigned worker_count):
+	strats(strategies)
+{
+	for (unsigned i=0; i<worker_count; ++i) {
+		workers.emplace_back(&AssessmentPipeline<Network>::work, this);
+	}
+}
+
+/*Destructor, classifies the remaining generations before stopping the workers*/
+template<typename Network>
+AssessmentPipeline<Network>::~AssessmentPipeline()
+{
+	{
+		std::lock_guard<std::mutex> lock(jobs_mutex);
+		closing = true;
+	}
+	jobs_available.notify_all();
+	
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+/*Queues a finished generation, blocks while the queue is full*/
+template<typename Network>
+void AssessmentPipeline<Network>::push(AssessmentJob<Network>&& job)
+{
+	{
+		std::unique_lock<std::mutex> lock(jobs_mutex);
+		jobs_changed.wait(lock, [this]{ return jobs.size() < PIPELINE_QUEUE_CAPACITY; });
+		jobs.push_back(std::move(job));
+	}
+	jobs_available.notify_one();
+}
+
+/*Blocks until every queued generation has been classified*/
+template<typename Network>
+void AssessmentPipeline<Network>::finish()
+{
+	std::unique_lock<std::mutex> lock(jobs_mutex);
+	jobs_changed.wait(lock, [this]{ return jobs.empty() and active_jobs == 0; });
+}
+
+/*Returns the most recent generation whose strategies have been counted.
+Its strategy counts are complete and are no longer written to.*/
+template<typename Network>
+long AssessmentPipeline<Network>::latestAssessedGeneration()
+{
+	std::lock_guard<std::mutex> lock(jobs_mutex);
+	return latest_generation;
+}
+
+/*Worker thread loop: classifies generations until the pipeline closes*/
+template<typename Network>
+void AssessmentPipeline<Network>::work()
+{
+	while (true) {
+		AssessmentJob<Network> job;
+		{
+			std::unique_lock<std::mutex> lock(jobs_mutex);
+			jobs_available.wait(lock, [this]{ return closing or not jobs.empty(); });
+			if (jobs.empty()) return; //closing and nothing left to do
+			
+			job = std::move(jobs.front());
+			jobs.pop_front();
+			active_jobs++;
+		}
+		jobs_changed.notify_all(); //a place is available in the queue
+		
+		assess(job);
+		
+		{
+			std::lock_guard<std::mutex> lock(jobs_mutex);
+			active_jobs--;
+			if (static_cast<long>(job.generation) > latest_generation) 
+				latest_generation = static_cast<long>(job.generation);
+		}
+		jobs_changed.notify_all();
+	}
+}
+
+/*Classifies every network of the generation, then deletes them*/
+template<typename Network>
+void AssessmentPipeline<Network>::assess(AssessmentJob<Network>& job)
+{
+	//each generation has its own random stream so that results do not depend on scheduling
+	RNG::setStream(job.generation);
+	
+	StrategyCounts& current_strategies = *job.strategies;
+	for (Network* network : job.population) {
+		current_strategies[strats.closestPureStrategy(*network)] += 1;
+		delete network;
+	}
+}
+
+
+/**---------- Available precisions ----------**/
+
+template class AssessmentPipeline<NeuralNetwork>;
+template class AssessmentPipeline<FloatNeuralNetwork>;
+template class AssessmentPipeline<FixedNeuralNetwork>;
+template class AssessmentPipeline<DenseNetwork>;
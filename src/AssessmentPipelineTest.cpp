@@ -0,0 +1,42 @@
+#include "AssessmentPipelineTest.hpp"
+
+
+void testAssessmentPipeline()
+{
+	std::cout << "Testing AssessmentPipeline...";
+	
+	Payoffs payoffs = Payoffs::getPayoffsForGameType("IPD");
+	Strategies strats(payoffs);
+	
+	std::array<StrategyCounts, PIPELINE_TEST_GENERATIONS> strategies = {};
+	std::array<int, PIPELINE_TEST_GENERATIONS> default_cooperations = {};
+	
+	{
+		AssessmentPipeline<NeuralNetwork> pipeline(strats, PIPELINE_TEST_WORKERS);
+		
+		//Networks without nodes always play their default choice
+		for (int generation=0; generation<PIPELINE_TEST_GENERATIONS; ++generation) {
+			AssessmentJob<NeuralNetwork> job;
+			job.generation = generation;
+			job.strategies = &strategies[generation];
+			for (int i=0; i<PIPELINE_TEST_POPULATION; ++i) {
+				NeuralNetwork* nn = new NeuralNetwork();
+				for (int j=0; j<MAXNODES; ++j) {
+					nn->removeNode();
+				}
+				if ((*nn)()) default_cooperations[generation]++;
+				job.population.push_back(nn);
+			}
+			pipeline.push(std::move(job));
+		}
+		pipeline.finish();
+	}
+	
+	//Every generation was classified in its own row
+	for (int generation=0; generation<PIPELINE_TEST_GENERATIONS; ++generation) {
+		assert(strategies[generation][STRATEGIES_ALWAYS_COOPERATE] == default_cooperations[generation]);
+		assert(strategies[generation][STRATEGIES_ALWAYS_DEFECT] == PIPELINE_TEST_POPULATION - default_cooperations[generation]);
+	}
+	
+	std::cout << " done!" << std::endl;
+}
@@ -0,0 +1,142 @@
+#include "Autotuner.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+
+Autotuner::Autotuner(const std::string& configuration, const std::vector<unsigned>& candidate_values, 
+	const std::string& cache_file_name):
+	cache_file(cache_file_name),
+	key(hostName() + "/" + configuration),
+	candidates(candidate_values),
+	best_seconds(candidate_values.size(), std::numeric_limits<double>::infinity())
+{
+	if (candidates.empty())
+		throw std::runtime_error("Autotuner: no candidate");
+	if (key.find_first_of(" \t\n") != std::string::npos)
+		throw std::runtime_error("Autotuner: invalid key " + key);
+	
+	if (candidates.size() == 1) {
+		choice = candidates.front();
+		tuned = true;
+	}
+	else if (readCache()) {
+		tuned = true;
+		cached = true;
+	}
+}
+
+/*A cached choice that is no longer a candidate is ignored*/
+bool Autotuner::readCache()
+{
+	if (cache_file.empty()) return false;
+	
+	std::ifstream input(cache_file);
+	std::string line_key;
+	unsigned value;
+	bool found = false;
+	while (input >> line_key >> value) {
+		if (line_key == key and std::find(candidates.begin(), candidates.end(), value) != candidates.end()) {
+			choice = value;
+			found = true;
+		}
+	}
+	return found;
+}
+
+void Autotuner::writeCache() const
+{
+	if (cache_file.empty()) return;
+	
+	std::ofstream output(cache_file, std::ios::app);
+	output << key << " " << choice << "\n";
+}
+
+unsigned Autotuner::begin()
+{
+	round_start = std::chrono::steady_clock::now();
+	return tuned ? choice : candidates[timed_rounds % candidates.size()];
+}
+
+void Autotuner::end()
+{
+	std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - round_start;
+	record(seconds.count());
+}
+
+void Autotuner::record(double seconds)
+{
+	if (tuned) return;
+	
+	std::size_t candidate = timed_rounds % candidates.size();
+	best_seconds[candidate] = std::min(best_seconds[candidate], seconds);
+	timed_rounds += 1;
+	
+	if (timed_rounds == AUTOTUNE_ROUNDS * candidates.size()) {
+		choice = candidates[static_cast<std::size_t>(std::min_element(best_seconds.begin(), best_seconds.end()) - best_seconds.begin())];
+		tuned = true;
+		writeCache();
+	}
+}
+
+bool Autotuner::isTuned() const
+{
+	return tuned;
+}
+
+bool Autotuner::isCached() const
+{
+	return cached;
+}
+
+unsigned Autotuner::getChoice() const
+{
+	return choice;
+}
+
+void Autotuner::write(std::ostream& output) const
+{
+	std::ostringstream text;
+	text << "# Autotune: " << key << " -> ";
+	if (not tuned) text << "not tuned (" << timed_rounds << " of " << AUTOTUNE_ROUNDS * candidates.size() << " rounds timed)";
+	else text << choice << (cached ? " (cached)" : "");
+	text << "\n";
+	
+	if (tuned and not cached and candidates.size() > 1) {
+		text << "# Autotune timings (fastest of " << AUTOTUNE_ROUNDS << " rounds):";
+		for (std::size_t candidate=0; candidate<candidates.size(); ++candidate) {
+			text << " " << candidates[candidate] << " -> " << best_seconds[candidate] << "s";
+		}
+		text << "\n";
+	}
+	output << text.str();
+}
+
+std::string Autotuner::hostName()
+{
+	char name[256] = {};
+	if (gethostname(name, sizeof(name) - 1) != 0 or name[0] == '\0') return "unknown";
+	return std::string(name);
+}
+
+std::string Autotuner::defaultCacheFile()
+{
+	const char* home = std::getenv("HOME");
+	if (home == nullptr or home[0] == '\0') return AUTOTUNE_CACHE_FILE;
+	return std::string(home) + "/" + AUTOTUNE_CACHE_FILE;
+}
+
+std::vector<unsigned> Autotuner::threadCandidates(unsigned max_threads)
+{
+	std::vector<unsigned> threads;
+	for (unsigned count=1; count<max_threads; count*=2) {
+		threads.push_back(count);
+	}
+	threads.push_back(std::max(max_threads, 1u));
+	return threads;
+}
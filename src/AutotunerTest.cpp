@@ -0,0 +1,60 @@
+#include "AutotunerTest.hpp"
+
+
+void testAutotuner()
+{
+	std::cout << "Testing Autotuner...";
+	
+	std::remove(AUTOTUNER_TEST_CACHE_FILE);
+	
+	///Candidates
+	assert(Autotuner::threadCandidates(1) == std::vector<unsigned>({1}));
+	assert(Autotuner::threadCandidates(6) == std::vector<unsigned>({1, 2, 4, 6}));
+	assert(Autotuner::threadCandidates(8) == std::vector<unsigned>({1, 2, 4, 8}));
+	
+	///Candidates are timed in turn, the fastest round of each counts
+	std::vector<unsigned> candidates = {1, 2, 4};
+	std::vector<double> first_rounds = {3.0, 2.0, 0.5}, second_rounds = {1.0, 2.5, 5.0};
+	Autotuner tuner("test", candidates, AUTOTUNER_TEST_CACHE_FILE);
+	assert(not tuner.isTuned() and not tuner.isCached());
+	for (int round=0; round<AUTOTUNE_ROUNDS; ++round) {
+		for (std::size_t candidate=0; candidate<candidates.size(); ++candidate) {
+			assert(tuner.begin() == candidates[candidate]);
+			tuner.record(round == 0 ? first_rounds[candidate] : second_rounds[candidate]);
+		}
+	}
+	assert(tuner.isTuned() and tuner.getChoice() == 4);
+	assert(tuner.begin() == 4);
+	tuner.record(10.0); //ignored once tuned
+	assert(tuner.getChoice() == 4);
+	
+	std::ostringstream output;
+	tuner.write(output);
+	assert(output.str().find("/test -> 4\n") != std::string::npos);
+	
+	///The choice is cached for this host and configuration only
+	Autotuner cached("test", candidates, AUTOTUNER_TEST_CACHE_FILE);
+	assert(cached.isTuned() and cached.isCached() and cached.begin() == 4);
+	
+	Autotuner other("other", candidates, AUTOTUNER_TEST_CACHE_FILE);
+	assert(not other.isTuned() and other.begin() == 1);
+	
+	//a cached choice which is no longer a candidate is timed again
+	Autotuner fewer("test", {1, 2}, AUTOTUNER_TEST_CACHE_FILE);
+	assert(not fewer.isTuned());
+	
+	//the last line of a key counts
+	{
+		std::ofstream cache(AUTOTUNER_TEST_CACHE_FILE, std::ios::app);
+		cache << Autotuner::hostName() << "/test 2\n";
+	}
+	assert(Autotuner("test", candidates, AUTOTUNER_TEST_CACHE_FILE).getChoice() == 2);
+	
+	///A single candidate needs no timing nor cache
+	Autotuner single("single", {3}, "");
+	assert(single.isTuned() and not single.isCached() and single.begin() == 3);
+	
+	std::remove(AUTOTUNER_TEST_CACHE_FILE);
+	
+	std::cout << " done!" << std::endl;
+}
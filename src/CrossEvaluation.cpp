@@ -0,0 +1,271 @@
+#include "CrossEvaluation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+
+template<typename Network>
+CrossEvaluation<Network>::CrossEvaluation(const Payoffs& payoffs, unsigned threads):
+	game_payoffs(payoffs),
+	thread_count(std::max(threads, 1u))
+{
+}
+
+template<typename Network>
+std::size_t CrossEvaluation<Network>::addSet(const std::string& name, std::vector<std::unique_ptr<Network>> individuals)
+{
+	if (individuals.empty())
+		throw std::runtime_error("CrossEvaluation: empty set " + name);
+	
+	set_names.push_back(name);
+	sets.push_back(std::move(individuals));
+	
+	//the matrices are indexed by the number of sets, previous results are moved to their new place
+	std::size_t set_count = sets.size();
+	std::vector<std::vector<double>> new_sums(set_count * set_count), new_counts(set_count * set_count);
+	for (std::size_t set_a=0; set_a<set_count; ++set_a) {
+		for (std::size_t set_b=0; set_b<set_count; ++set_b) {
+			std::size_t index = set_a*set_count + set_b;
+			if (set_a < set_count - 1 and set_b < set_count - 1) {
+				new_sums[index] = std::move(payoff_sums[set_a*(set_count - 1) + set_b]);
+				new_counts[index] = std::move(game_counts[set_a*(set_count - 1) + set_b]);
+			}
+			else {
+				new_sums[index].assign(sets[set_a].size() * sets[set_b].size(), 0);
+				new_counts[index].assign(sets[set_a].size() * sets[set_b].size(), 0);
+			}
+		}
+	}
+	payoff_sums = std::move(new_sums);
+	game_counts = std::move(new_counts);
+	
+	return set_count - 1;
+}
+
+template<typename Network>
+std::size_t CrossEvaluation<Network>::addArchivedGeneration(const GenomeArchiveReader& reader, unsigned long generation)
+{
+	long snapshot = reader.findSnapshot(generation);
+	if (snapshot < 0)
+		throw std::runtime_error("CrossEvaluation: generation " + std::to_string(generation) + " is not archived");
+	
+	std::vector<std::unique_ptr<Network>> individuals;
+	for (unsigned individual=0; individual<reader.getIndividualCount(static_cast<std::size_t>(snapshot)); ++individual) {
+		individuals.emplace_back(reader.loadIndividual<Network>(static_cast<std::size_t>(snapshot), individual));
+	}
+	return addSet("generation " + std::to_string(generation), std::move(individuals));
+}
+
+/*
+Lists the pairs of every pair of sets (a set with itself plays its pairs of distinct individuals, 
+unless the plan only plays across sets),
+or draws sampled_pairs of them without replacement, each pair repeated for its matches.*/
+template<typename Network>
+std::vector<typename CrossEvaluation<Network>::Pairing> CrossEvaluation<Network>::drawPairings(const PairingPlan& plan) const
+{
+	std::vector<Pairing> pairings;
+	std::vector<Pairing> candidates;
+	
+	for (std::size_t set_a=0; set_a<sets.size(); ++set_a) {
+		for (std::size_t set_b=set_a; set_b<sets.size(); ++set_b) {
+			if (plan.across_sets_only and set_a == set_b) continue;
+			
+			candidates.clear();
+			for (unsigned index_a=0; index_a<sets[set_a].size(); ++index_a) {
+				for (unsigned index_b=(set_a == set_b) ? index_a + 1 : 0; index_b<sets[set_b].size(); ++index_b) {
+					candidates.push_back({set_a, set_b, index_a, index_b});
+				}
+			}
+			
+			//partial shuffle, the first sampled_pairs candidates are kept
+			std::size_t kept = candidates.size();
+			if (plan.sampled_pairs > 0 and plan.sampled_pairs < candidates.size()) {
+				kept = plan.sampled_pairs;
+				for (std::size_t pair=0; pair<kept; ++pair) {
+					int last = static_cast<int>(candidates.size()) - 1;
+					std::swap(candidates[pair], candidates[static_cast<std::size_t>(RNG::getRandomInt(static_cast<int>(pair), last))]);
+				}
+			}
+			
+			for (std::size_t pair=0; pair<kept; ++pair) {
+				pairings.insert(pairings.end(), plan.matches, candidates[pair]);
+			}
+		}
+	}
+	return pairings;
+}
+
+template<typename Network>
+std::vector<double>& CrossEvaluation<Network>::pairMatrix(std::vector<std::vector<double>>& matrices, std::size_t set_a, std::size_t set_b)
+{
+	return matrices[set_a*sets.size() + set_b];
+}
+
+/*
+Plays the matches on the threads, which take the next block of matches until none is left, then adds
+the results in the order of the pairings (see playIndependently in Simulation.cpp).*/
+template<typename Network>
+void CrossEvaluation<Network>::evaluate(const PairingPlan& plan)
+{
+	if (plan.matches == 0)
+		throw std::runtime_error("CrossEvaluation: a pair must play at least one match");
+	
+	std::vector<Pairing> pairings = drawPairings(plan);
+	std::vector<MatchResult> results(pairings.size());
+	unsigned long long first_stream = CROSS_FIRST_STREAM + (static_cast<unsigned long long>(evaluation_count++) << 32);
+	std::size_t block_count = (pairings.size() + CROSS_BLOCK_MATCHES - 1) / CROSS_BLOCK_MATCHES;
+	std::atomic<std::size_t> next_block(0);
+	
+	auto play_matches = [&]() {
+		for (std::size_t block=next_block++; block<block_count; block=next_block++) {
+			RNG::setStream(first_stream + block);
+			
+			std::size_t block_end = std::min(pairings.size(), (block + 1) * CROSS_BLOCK_MATCHES);
+			for (std::size_t match=block*CROSS_BLOCK_MATCHES; match<block_end; ++match) {
+				const Network& player_a(*sets[pairings[match].set_a][pairings[match].index_a]);
+				const Network& player_b(*sets[pairings[match].set_b][pairings[match].index_b]);
+				typename Network::State state_a = player_a.createState();
+				typename Network::State state_b = player_b.createState();
+				results[match] = playMatch(game_payoffs, player_a, state_a, player_b, state_b);
+			}
+		}
+	};
+	
+	//the calling thread's own stream is left untouched
+	std::vector<std::thread> threads;
+	for (unsigned thread_index=0; thread_index<thread_count; ++thread_index) {
+		threads.emplace_back(play_matches);
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	
+	for (std::size_t match=0; match<pairings.size(); ++match) {
+		const Pairing& pairing = pairings[match];
+		std::size_t size_a = sets[pairing.set_a].size(), size_b = sets[pairing.set_b].size();
+		
+		pairMatrix(payoff_sums, pairing.set_a, pairing.set_b)[pairing.index_a*size_b + pairing.index_b] += static_cast<double>(results[match].player_a_payoff_sum);
+		pairMatrix(game_counts, pairing.set_a, pairing.set_b)[pairing.index_a*size_b + pairing.index_b] += results[match].round_iterations;
+		pairMatrix(payoff_sums, pairing.set_b, pairing.set_a)[pairing.index_b*size_a + pairing.index_a] += static_cast<double>(results[match].player_b_payoff_sum);
+		pairMatrix(game_counts, pairing.set_b, pairing.set_a)[pairing.index_b*size_a + pairing.index_a] += results[match].round_iterations;
+	}
+}
+
+template<typename Network>
+std::size_t CrossEvaluation<Network>::getSetCount() const
+{
+	return sets.size();
+}
+
+template<typename Network>
+const std::string& CrossEvaluation<Network>::getSetName(std::size_t set) const
+{
+	return set_names.at(set);
+}
+
+template<typename Network>
+std::vector<std::vector<double>> CrossEvaluation<Network>::getPayoffs(std::size_t set_a, std::size_t set_b) const
+{
+	const std::vector<double>& sums = payoff_sums.at(set_a*sets.size() + set_b);
+	const std::vector<double>& counts = game_counts.at(set_a*sets.size() + set_b);
+	std::size_t size_b = sets[set_b].size();
+	
+	std::vector<std::vector<double>> payoffs(sets[set_a].size(), std::vector<double>(size_b));
+	for (std::size_t index_a=0; index_a<payoffs.size(); ++index_a) {
+		for (std::size_t index_b=0; index_b<size_b; ++index_b) {
+			double count = counts[index_a*size_b + index_b];
+			payoffs[index_a][index_b] = (count > 0) ? sums[index_a*size_b + index_b] / count : std::numeric_limits<double>::quiet_NaN();
+		}
+	}
+	return payoffs;
+}
+
+template<typename Network>
+std::vector<double> CrossEvaluation<Network>::getIndividualPayoffs(std::size_t set_a, std::size_t set_b) const
+{
+	const std::vector<double>& sums = payoff_sums.at(set_a*sets.size() + set_b);
+	const std::vector<double>& counts = game_counts.at(set_a*sets.size() + set_b);
+	std::size_t size_b = sets[set_b].size();
+	
+	std::vector<double> payoffs(sets[set_a].size());
+	for (std::size_t index_a=0; index_a<payoffs.size(); ++index_a) {
+		double sum = 0, count = 0;
+		for (std::size_t index_b=0; index_b<size_b; ++index_b) {
+			sum += sums[index_a*size_b + index_b];
+			count += counts[index_a*size_b + index_b];
+		}
+		payoffs[index_a] = (count > 0) ? sum / count : std::numeric_limits<double>::quiet_NaN();
+	}
+	return payoffs;
+}
+
+template<typename Network>
+double CrossEvaluation<Network>::getSetPayoff(std::size_t set_a, std::size_t set_b) const
+{
+	const std::vector<double>& sums = payoff_sums.at(set_a*sets.size() + set_b);
+	const std::vector<double>& counts = game_counts.at(set_a*sets.size() + set_b);
+	
+	double sum = 0, count = 0;
+	for (std::size_t pair=0; pair<sums.size(); ++pair) {
+		sum += sums[pair];
+		count += counts[pair];
+	}
+	return (count > 0) ? sum / count : std::numeric_limits<double>::quiet_NaN();
+}
+
+/*Formats a value like the simulation's outputs, with pairs that never met as NaN (read by octave)*/
+static std::string formatPayoff(double value)
+{
+	return std::isnan(value) ? "NaN" : std::to_string(value);
+}
+
+/*Writes set_payoffs (rows are the sets receiving the payoffs), then payoffs_a_b for every pair of sets (from 1)*/
+template<typename Network>
+void CrossEvaluation<Network>::write(std::ostream& output) const
+{
+	std::string text = "# SETS are [";
+	for (std::size_t set=0; set<sets.size(); ++set) {
+		text += (set > 0 ? ", " : "") + set_names[set];
+	}
+	text += "]\n";
+	
+	text += "# name: set_payoffs\n";
+	text += "# type: matrix\n";
+	text += "# rows: " + std::to_string(sets.size()) + "\n";
+	text += "# columns: " + std::to_string(sets.size()) + "\n";
+	for (std::size_t set_a=0; set_a<sets.size(); ++set_a) {
+		for (std::size_t set_b=0; set_b<sets.size(); ++set_b) {
+			text += formatPayoff(getSetPayoff(set_a, set_b)) + " ";
+		}
+		text += "\n";
+	}
+	text += "\n";
+	
+	for (std::size_t set_a=0; set_a<sets.size(); ++set_a) {
+		for (std::size_t set_b=0; set_b<sets.size(); ++set_b) {
+			text += "# name: payoffs_" + std::to_string(set_a + 1) + "_" + std::to_string(set_b + 1) + "\n";
+			text += "# type: matrix\n";
+			text += "# rows: " + std::to_string(sets[set_a].size()) + "\n";
+			text += "# columns: " + std::to_string(sets[set_b].size()) + "\n";
+			for (const std::vector<double>& row : getPayoffs(set_a, set_b)) {
+				for (double value : row) {
+					text += formatPayoff(value) + " ";
+				}
+				text += "\n";
+			}
+			text += "\n";
+		}
+	}
+	output << text;
+}
+
+
+/**---------- Available precisions ----------**/
+
+template class CrossEvaluation<NeuralNetwork>;
+template class CrossEvaluation<FloatNeuralNetwork>;
+template class CrossEvaluation<FixedNeuralNetwork>;
+template class CrossEvaluation<DenseNetwork>;
@@ -0,0 +1,126 @@
+#include "CrossEvaluationTest.hpp"
+
+
+/*Returns true if both matrices hold the same values, pairs that never met included*/
+static bool samePayoffs(const std::vector<std::vector<double>>& first, const std::vector<std::vector<double>>& second)
+{
+	if (first.size() != second.size()) return false;
+	for (std::size_t row=0; row<first.size(); ++row) {
+		for (std::size_t col=0; col<first[row].size(); ++col) {
+			if (std::isnan(first[row][col]) != std::isnan(second[row][col])) return false;
+			if (not std::isnan(first[row][col]) and first[row][col] != second[row][col]) return false;
+		}
+	}
+	return true;
+}
+
+/*Loads the first and second archived generations in an evaluation with the given threads, and plays them*/
+static void evaluateArchive(CrossEvaluation<NeuralNetwork>& evaluation, const PairingPlan& plan)
+{
+	GenomeArchiveReader reader(CROSSEVALUATION_TEST_FILE);
+	evaluation.addArchivedGeneration(reader, 0);
+	evaluation.addArchivedGeneration(reader, 1);
+	
+	RNG::setSeed(CROSSEVALUATION_TEST_SEED);
+	evaluation.evaluate(plan);
+}
+
+void testCrossEvaluation()
+{
+	std::cout << "Testing CrossEvaluation...";
+	
+	const Payoffs payoffs = Payoffs::getPayoffsForGameType("IPD");
+	
+	///Archive of an ancestor and a descendant generation
+	std::vector<NeuralNetwork*> population;
+	for (int i=0; i<CROSSEVALUATION_TEST_POPULATION; ++i) {
+		population.push_back(new NeuralNetwork());
+	}
+	{
+		GenomeArchiveWriter writer(CROSSEVALUATION_TEST_FILE, NeuralNetwork::precisionName(), CROSSEVALUATION_TEST_SEED, 
+			CROSSEVALUATION_TEST_POPULATION, 1);
+		writer.append(0, population.data(), CROSSEVALUATION_TEST_POPULATION);
+		for (NeuralNetwork* individual : population) {
+			individual->mutate();
+		}
+		writer.append(1, population.data(), CROSSEVALUATION_TEST_POPULATION);
+	}
+	
+	///A match between two sets of one individual is the simulation's match on the first stream
+	CrossEvaluation<NeuralNetwork> single(payoffs);
+	std::vector<std::unique_ptr<NeuralNetwork>> first_set, second_set;
+	first_set.emplace_back(new NeuralNetwork(*population[0]));
+	second_set.emplace_back(new NeuralNetwork(*population[1]));
+	single.addSet("first", std::move(first_set));
+	single.addSet("second", std::move(second_set));
+	single.evaluate(PairingPlan());
+	
+	MatchResult result;
+	std::thread reference([&]() { //on its own thread, like the evaluation's matches
+		RNG::setStream(CROSS_FIRST_STREAM);
+		NeuralNetwork::State state_a = population[0]->createState(), state_b = population[1]->createState();
+		result = playMatch(payoffs, *population[0], state_a, *population[1], state_b);
+	});
+	reference.join();
+	assert(single.getPayoffs(0, 1)[0][0] == static_cast<double>(result.player_a_payoff_sum) / result.round_iterations);
+	assert(single.getPayoffs(1, 0)[0][0] == static_cast<double>(result.player_b_payoff_sum) / result.round_iterations);
+	assert(std::isnan(single.getSetPayoff(0, 0))); //a single individual has no opponent in its own set
+	
+	///Every pair is played, the results do not depend on the number of threads
+	CrossEvaluation<NeuralNetwork> one_thread(payoffs, 1), threads(payoffs, CROSSEVALUATION_TEST_THREADS);
+	evaluateArchive(one_thread, PairingPlan());
+	evaluateArchive(threads, PairingPlan());
+	assert(threads.getSetCount() == 2 and threads.getSetName(1) == "generation 1");
+	for (std::size_t set_a=0; set_a<2; ++set_a) {
+		for (std::size_t set_b=0; set_b<2; ++set_b) {
+			std::vector<std::vector<double>> matrix = threads.getPayoffs(set_a, set_b);
+			assert(samePayoffs(matrix, one_thread.getPayoffs(set_a, set_b)));
+			
+			for (std::size_t index_a=0; index_a<CROSSEVALUATION_TEST_POPULATION; ++index_a) {
+				for (std::size_t index_b=0; index_b<CROSSEVALUATION_TEST_POPULATION; ++index_b) {
+					//individuals only miss themselves
+					assert(std::isnan(matrix[index_a][index_b]) == (set_a == set_b and index_a == index_b));
+				}
+			}
+			double set_payoff = threads.getSetPayoff(set_a, set_b);
+			assert(set_payoff >= IPD_SELF_DEFECTS and set_payoff <= IPD_SELF_COOPERATES); //lowest and highest IPD payoffs
+		}
+	}
+	
+	///Sampled pairs
+	PairingPlan plan;
+	plan.sampled_pairs = CROSSEVALUATION_TEST_SAMPLES;
+	plan.matches = 2;
+	CrossEvaluation<NeuralNetwork> sampled(payoffs, CROSSEVALUATION_TEST_THREADS);
+	evaluateArchive(sampled, plan);
+	int met = 0;
+	for (const std::vector<double>& row : sampled.getPayoffs(1, 0)) {
+		for (double value : row) {
+			if (not std::isnan(value)) met += 1;
+		}
+	}
+	assert(met == CROSSEVALUATION_TEST_SAMPLES);
+	
+	std::ostringstream output;
+	sampled.write(output);
+	assert(output.str().find("# name: payoffs_2_1\n# type: matrix\n# rows: 12\n# columns: 12\n") != std::string::npos);
+	assert(output.str().find("NaN") != std::string::npos);
+	
+	///Generations must be archived
+	bool rejected = false;
+	try {
+		GenomeArchiveReader reader(CROSSEVALUATION_TEST_FILE);
+		sampled.addArchivedGeneration(reader, 2);
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	assert(rejected);
+	
+	for (NeuralNetwork* individual : population) {
+		delete individual;
+	}
+	std::remove(CROSSEVALUATION_TEST_FILE);
+	
+	std::cout << " done!" << std::endl;
+}
@@ -0,0 +1,694 @@
+#include "DenseNetwork.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+int DenseNetwork::initial_node_count = -1;
+
+
+/**---------- DenseNetwork ----------**/
+
+const char* DenseNetwork::precisionName()
+{
+	return "dense (float)";
+}
+
+void DenseNetwork::setInitialNodeCount(int node_count)
+{
+	assert(node_count >= -1 and node_count <= DENSE_MAX_NODES);
+	initial_node_count = node_count;
+}
+
+/*Default constructor: random default choice and output threshold, then random nodes as NeuralNetwork,
+or initial_node_count cognitive nodes if set*/
+DenseNetwork::DenseNetwork():
+	cooperate_by_default(RNG::getRandomBool()),
+	output_node_threshold(static_cast<float>(RNG::getRandomNumval()))
+{
+	if (initial_node_count < 0) {
+		int initial_nodes = RNG::getInitialNodeCount();
+		for (int i=0; i<initial_nodes; ++i) {
+			addNode();
+		}
+		assert(getInnerNodeCount() == initial_nodes);
+	}
+	else {
+		for (int i=0; i<initial_node_count; ++i) {
+			addCognitiveNode();
+		}
+	}
+}
+
+/*Copy constructor*/
+DenseNetwork::DenseNetwork(const DenseNetwork& nn):
+	cooperate_by_default(nn.cooperate_by_default),
+	output_node_threshold(nn.output_node_threshold),
+	context_node_count(nn.context_node_count),
+	input_weights(nn.input_weights),
+	thresholds(nn.thresholds),
+	output_weights(nn.output_weights),
+	context_weights(nn.context_weights),
+	has_context(nn.has_context)
+{
+	//context values (network's memory) are not inherited
+	carryover_state.context_values.assign(nn.carryover_state.context_values.size(), 0.0f);
+}
+
+/*Copy assignment, reusing the storage of the network's vectors*/
+DenseNetwork& DenseNetwork::operator=(const DenseNetwork& nn)
+{
+	if (this == &nn) return *this;
+	
+	cooperate_by_default = nn.cooperate_by_default;
+	output_node_threshold = nn.output_node_threshold;
+	context_node_count = nn.context_node_count;
+	input_weights = nn.input_weights;
+	thresholds = nn.thresholds;
+	output_weights = nn.output_weights;
+	context_weights = nn.context_weights;
+	has_context = nn.has_context;
+	carryover_state.context_values.assign(nn.carryover_state.context_values.size(), 0.0f);
+	return *this;
+}
+
+/*Genome constructor (see writeGenome), does not draw any random value*/
+DenseNetwork::DenseNetwork(const char* genome):
+	cooperate_by_default(genome[0] != 0)
+{
+	std::uint16_t counts[2];
+	std::memcpy(counts, genome + 2, sizeof(counts));
+	int cognitive_nodes = counts[0];
+	assert(cognitive_nodes <= DENSE_MAX_NODES);
+
+	const char* values = genome + DENSE_GENOME_HEADER_SIZE;
+	std::memcpy(&output_node_threshold, values, sizeof(float));
+	values += sizeof(float);
+
+	for (int i=0; i<cognitive_nodes; ++i) {
+		float node_values[DENSE_INPUT_COUNT + 4];
+		std::memcpy(node_values, values, sizeof(node_values));
+		values += sizeof(node_values);
+
+		input_weights.insert(input_weights.end(), node_values, node_values + DENSE_INPUT_COUNT);
+		thresholds.push_back(node_values[DENSE_INPUT_COUNT]);
+		output_weights.push_back(node_values[DENSE_INPUT_COUNT+1]);
+		carryover_state.context_values.push_back(node_values[DENSE_INPUT_COUNT+2]);
+		context_weights.push_back(node_values[DENSE_INPUT_COUNT+3]);
+		has_context.push_back(*values++ != 0 ? 1 : 0);
+		if (has_context.back()) context_node_count++;
+	}
+	assert(context_node_count == counts[1]);
+}
+
+/*Returns a random cognitive node index, with or without a context node depending on with_context.
+The node is chosen by its rank among the matching nodes, without building a list of candidates.*/
+int DenseNetwork::getRandomCognitiveNode(bool with_context) const
+{
+	int candidates = with_context ? getContextNodeCount() : getCognitiveNodeCount() - getContextNodeCount();
+	assert(candidates > 0);
+
+	int rank = RNG::getRandomInt(0, candidates-1);
+	for (int i=0; i<getCognitiveNodeCount(); ++i) {
+		if ((has_context[static_cast<std::size_t>(i)] != 0) == with_context and rank-- == 0)
+			return i;
+	}
+	assert(false);
+	return -1;
+}
+
+/*If possible, adds a node to the network (same choice as NeuralNetwork::addNode)*/
+void DenseNetwork::addNode()
+{
+	if (getInnerNodeCount() == DENSE_MAX_NODES*2) //Cannot add new nodes
+		return;
+
+	bool is_context_node;
+	if (getCognitiveNodeCount() == DENSE_MAX_NODES)
+		is_context_node = true;
+	else if (getContextNodeCount() == getCognitiveNodeCount())
+		is_context_node = false;
+	else
+		is_context_node = RNG::getRandomBool();
+
+	if (is_context_node) addContextNode();
+	else addCognitiveNode();
+}
+
+/*Adds a context node to a random context-free cognitive node*/
+void DenseNetwork::addContextNode()
+{
+	assert(getContextNodeCount() < getCognitiveNodeCount());
+
+	std::size_t node = static_cast<std::size_t>(getRandomCognitiveNode(false));
+	carryover_state.context_values[node] = static_cast<float>(RNG::getRandomNumval());
+	context_weights[node] = static_cast<float>(RNG::getRandomNumval());
+	has_context[node] = 1;
+	context_node_count++;
+}
+
+/*Adds a cognitive node with a random threshold and random weights (drawn in NeuralNetwork's order)*/
+void DenseNetwork::addCognitiveNode()
+{
+	assert(getCognitiveNodeCount() < DENSE_MAX_NODES);
+	addCognitiveNode(static_cast<float>(RNG::getRandomNumval()));
+}
+
+void DenseNetwork::addCognitiveNode(float threshold)
+{
+	thresholds.push_back(threshold);
+	for (int input=0; input<DENSE_INPUT_COUNT; ++input) {
+		input_weights.push_back(static_cast<float>(RNG::getRandomNumval()));
+	}
+	output_weights.push_back(static_cast<float>(RNG::getRandomNumval()));
+	context_weights.push_back(0.0f);
+	carryover_state.context_values.push_back(0.0f);
+	has_context.push_back(0);
+}
+
+/*If possible, removes a random context or cognitive node (same choice as NeuralNetwork::removeNode)*/
+void DenseNetwork::removeNode()
+{
+	if (getCognitiveNodeCount() == 0)
+		return;
+
+	bool is_context_node = false;
+	if (getContextNodeCount() > 0) is_context_node = RNG::getRandomBool();
+
+	if (is_context_node) removeContextNode();
+	else removeCognitiveNode();
+}
+
+void DenseNetwork::removeContextNode()
+{
+	assert(getContextNodeCount() > 0);
+
+	std::size_t node = static_cast<std::size_t>(getRandomCognitiveNode(true));
+	carryover_state.context_values[node] = 0.0f;
+	context_weights[node] = 0.0f;
+	has_context[node] = 0;
+	context_node_count--;
+}
+
+void DenseNetwork::removeCognitiveNode()
+{
+	assert(getCognitiveNodeCount() > 0);
+
+	std::ptrdiff_t node = RNG::getRandomInt(0, getCognitiveNodeCount()-1);
+	if (has_context[static_cast<std::size_t>(node)]) context_node_count--;
+
+	input_weights.erase(input_weights.begin() + node*DENSE_INPUT_COUNT, input_weights.begin() + (node+1)*DENSE_INPUT_COUNT);
+	thresholds.erase(thresholds.begin() + node);
+	output_weights.erase(output_weights.begin() + node);
+	context_weights.erase(context_weights.begin() + node);
+	carryover_state.context_values.erase(carryover_state.context_values.begin() + node);
+	has_context.erase(has_context.begin() + node);
+}
+
+int DenseNetwork::getInnerNodeCount() const
+{
+	return getCognitiveNodeCount() + getContextNodeCount();
+}
+
+int DenseNetwork::getCognitiveNodeCount() const
+{
+	return static_cast<int>(thresholds.size());
+}
+
+int DenseNetwork::getContextNodeCount() const
+{
+	return context_node_count;
+}
+
+/*Mutates values and structure with NeuralNetwork's probabilities and order of random draws*/
+MutationRecord DenseNetwork::mutate()
+{
+	MutationRecord record;
+
+	if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) {
+		mutateParameter(PARAMETER_DEFAULT_CHOICE, 0);
+		record.value_mutations++;
+	}
+
+	for (int i=0; i<getCognitiveNodeCount(); i++) {
+		for (int parameter_class=PARAMETER_SELF_PAYOFF_WEIGHT; parameter_class<=PARAMETER_NODE_THRESHOLD; ++parameter_class) {
+			if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) {
+				mutateParameter(parameter_class, i);
+				record.value_mutations++;
+			}
+		}
+	}
+
+	if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) {
+		mutateParameter(PARAMETER_OUTPUT_THRESHOLD, 0);
+		record.value_mutations++;
+	}
+
+	if (RNG::getTrueWithProbability(NETWORK_STRUCTURE_MUTATION_PROB)) {
+		record.node_change = mutateParameter(PARAMETER_STRUCTURE, 0);
+	}
+
+	return record;
+}
+
+int DenseNetwork::getParameterCount(int parameter_class) const
+{
+	switch (parameter_class) {
+		case PARAMETER_SELF_PAYOFF_WEIGHT:
+		case PARAMETER_OTHER_PAYOFF_WEIGHT:
+		case PARAMETER_OUTPUT_WEIGHT:
+		case PARAMETER_CONTEXT_WEIGHT:
+		case PARAMETER_NODE_THRESHOLD:
+			return getCognitiveNodeCount();
+		default:
+			assert(parameter_class >= 0 and parameter_class < PARAMETER_CLASS_COUNT);
+			return 1;
+	}
+}
+
+/*Applies a single mutation (see NeuralNetwork::mutateParameter)*/
+int DenseNetwork::mutateParameter(int parameter_class, int index)
+{
+	assert(index >= 0 and index < getParameterCount(parameter_class));
+	std::size_t node = static_cast<std::size_t>(index);
+
+	switch (parameter_class) {
+		case PARAMETER_DEFAULT_CHOICE:
+			cooperate_by_default = not (cooperate_by_default);
+			break;
+		case PARAMETER_SELF_PAYOFF_WEIGHT:
+			input_weights[node*DENSE_INPUT_COUNT] += static_cast<float>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_OTHER_PAYOFF_WEIGHT:
+			input_weights[node*DENSE_INPUT_COUNT+1] += static_cast<float>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_OUTPUT_WEIGHT:
+			output_weights[node] += static_cast<float>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_CONTEXT_WEIGHT:
+			context_weights[node] += static_cast<float>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_NODE_THRESHOLD:
+			thresholds[node] += static_cast<float>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_OUTPUT_THRESHOLD:
+			output_node_threshold += static_cast<float>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_STRUCTURE: {
+			int inner_node_count = getInnerNodeCount();
+			if (RNG::getRandomBool()) addNode();
+			else removeNode();
+			return getInnerNodeCount() - inner_node_count;
+		}
+	}
+
+	return 0;
+}
+
+/*
+Computes batch evaluations of the network at once. The cognitive layer is the product of the
+inputs (batch x DENSE_INPUT_COUNT) by the transposed input weights (DENSE_INPUT_COUNT x nodes),
+computed by blocks of DENSE_BLOCK_ROWS evaluations and DENSE_BLOCK_NODES nodes so that the
+weights of a block stay in cache while it is reused by every row. Context values, squashing and
+the output layer are fused into the block: the cognitive outputs are never stored, each one is
+added to its row's output sum as soon as it is computed.*/
+void DenseNetwork::evaluateBatch(const float* inputs, float* contexts, int batch, float* probabilities) const
+{
+	const int nodes = getCognitiveNodeCount();
+	if (nodes == 0) {
+		std::fill(probabilities, probabilities + batch, cooperate_by_default ? 1.0f : 0.0f);
+		return;
+	}
+
+	const float* weights = input_weights.data();
+	const float* node_thresholds = thresholds.data();
+	const float* node_outputs = output_weights.data();
+	const float* node_contexts = context_weights.data();
+	const unsigned char* node_has_context = has_context.data();
+
+	for (int row_block=0; row_block<batch; row_block+=DENSE_BLOCK_ROWS) {
+		const int row_end = std::min(row_block + DENSE_BLOCK_ROWS, batch);
+		float sums[DENSE_BLOCK_ROWS] = {};
+
+		for (int node_block=0; node_block<nodes; node_block+=DENSE_BLOCK_NODES) {
+			const int node_end = std::min(node_block + DENSE_BLOCK_NODES, nodes);
+
+			for (int row=row_block; row<row_end; ++row) {
+				const float* row_inputs = inputs + static_cast<std::ptrdiff_t>(row)*DENSE_INPUT_COUNT;
+				float* row_contexts = contexts + static_cast<std::ptrdiff_t>(row)*nodes;
+				float sum = 0.0f;
+
+				for (int node=node_block; node<node_end; ++node) {
+					const float* node_weights = weights + static_cast<std::ptrdiff_t>(node)*DENSE_INPUT_COUNT;
+					float input = 0.0f;
+					for (int k=0; k<DENSE_INPUT_COUNT; ++k) {
+						input += row_inputs[k] * node_weights[k];
+					}
+
+					float output;
+					if (node_has_context[node]) {
+						input += row_contexts[node] * node_contexts[node];
+						output = sigmoidalSquash(input, node_thresholds[node]);
+						row_contexts[node] = output;
+					}
+					else {
+						output = sigmoidalSquash(input, node_thresholds[node]);
+					}
+					sum += output * node_outputs[node];
+				}
+				sums[row - row_block] += sum;
+			}
+		}
+
+		for (int row=row_block; row<row_end; ++row) {
+			probabilities[row] = sigmoidalSquash(sums[row - row_block], output_node_threshold);
+		}
+	}
+}
+
+/*Returns a state holding the network's current context values*/
+DenseNetwork::State DenseNetwork::createState() const
+{
+	return carryover_state;
+}
+
+DenseNetwork::State& DenseNetwork::getCarryoverState()
+{
+	return carryover_state;
+}
+
+/*Returns the probability that the network cooperates given the input (updates the state's context values)*/
+float DenseNetwork::getCooperationProbability(payoff self_payoff, payoff other_payoff, State& state) const
+{
+	assert(state.context_values.size() == thresholds.size());
+	float inputs[DENSE_INPUT_COUNT] = {static_cast<float>(self_payoff), static_cast<float>(other_payoff)};
+	float probability;
+	evaluateBatch(inputs, state.context_values.data(), 1, &probability);
+	return probability;
+}
+
+/*Returns true if it chooses to cooperate based on the input and the state, false otherwise*/
+bool DenseNetwork::decide(payoff self_payoff, payoff other_payoff, State& state) const
+{
+	if (getCognitiveNodeCount() == 0) return (*this)();
+	return RNG::getTrueWithProbability(static_cast<double>(getCooperationProbability(self_payoff, other_payoff, state)));
+}
+
+float DenseNetwork::getCooperationProbability(payoff self_payoff, payoff other_payoff)
+{
+	return getCooperationProbability(self_payoff, other_payoff, carryover_state);
+}
+
+bool DenseNetwork::operator()(payoff self_payoff, payoff other_payoff)
+{
+	return decide(self_payoff, other_payoff, carryover_state);
+}
+
+/*Returns true if it chooses to cooperate by default, false otherwise*/
+bool DenseNetwork::operator()() const
+{
+	return cooperate_by_default;
+}
+
+/*Mixes values into a FNV-1a hash, byte by byte*/
+static void hashCombine(std::uint64_t& hash, const void* value, std::size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(value);
+	for (std::size_t i=0; i<size; ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL; //FNV prime
+	}
+}
+
+/*Returns a hash of everything compared by operator== (identical networks have equal hashes)*/
+std::uint64_t DenseNetwork::hash() const
+{
+	std::uint64_t hash = 14695981039346656037ULL; //FNV offset basis
+
+	hashCombine(hash, &cooperate_by_default, sizeof(cooperate_by_default));
+	hashCombine(hash, &output_node_threshold, sizeof(output_node_threshold));
+	hashCombine(hash, input_weights.data(), input_weights.size() * sizeof(float));
+	hashCombine(hash, thresholds.data(), thresholds.size() * sizeof(float));
+	hashCombine(hash, output_weights.data(), output_weights.size() * sizeof(float));
+	hashCombine(hash, context_weights.data(), context_weights.size() * sizeof(float));
+	hashCombine(hash, has_context.data(), has_context.size());
+
+	return hash;
+}
+
+void DenseNetwork::writeFlatParameters(float* values, float* structure, int node_slots) const
+{
+	const int nodes = getCognitiveNodeCount();
+	assert(node_slots >= nodes);
+
+	values[0] = cooperate_by_default ? 1.0f : 0.0f;
+	values[1] = output_node_threshold;
+	std::fill(values + FLAT_NETWORK_VALUES, values + FLAT_NETWORK_VALUES + node_slots*FLAT_NODE_VALUES, 0.0f);
+	std::fill(structure, structure + node_slots*FLAT_NODE_STRUCTURE, 0.0f);
+
+	for (int node=0; node<nodes; ++node) {
+		float* node_values = values + FLAT_NETWORK_VALUES + node*FLAT_NODE_VALUES;
+		node_values[0] = thresholds[node];
+		node_values[1] = input_weights[node*DENSE_INPUT_COUNT];
+		node_values[2] = input_weights[node*DENSE_INPUT_COUNT + 1];
+		node_values[3] = output_weights[node];
+		node_values[4] = context_weights[node];
+
+		structure[node*FLAT_NODE_STRUCTURE] = 1.0f;
+		structure[node*FLAT_NODE_STRUCTURE + 1] = has_context[node] ? 1.0f : 0.0f;
+	}
+}
+
+std::size_t DenseNetwork::getGenomeSize() const
+{
+	return DENSE_GENOME_HEADER_SIZE + sizeof(float)
+		+ static_cast<std::size_t>(getCognitiveNodeCount()) * ((DENSE_INPUT_COUNT + 4) * sizeof(float) + 1);
+}
+
+/*
+Genome layout (native byte order, unaligned):
+- 8 bytes: default choice, padding, cognitive and context node counts (16 bits each), padding
+- output node threshold
+- per cognitive node: input weights, threshold, output weight, context value, context link weight,
+  then one byte telling if the context node exists*/
+void DenseNetwork::writeGenome(char* genome) const
+{
+	std::memset(genome, 0, DENSE_GENOME_HEADER_SIZE);
+	genome[0] = cooperate_by_default ? 1 : 0;
+	std::uint16_t counts[2] = {static_cast<std::uint16_t>(getCognitiveNodeCount()), static_cast<std::uint16_t>(getContextNodeCount())};
+	std::memcpy(genome + 2, counts, sizeof(counts));
+
+	char* values = genome + DENSE_GENOME_HEADER_SIZE;
+	std::memcpy(values, &output_node_threshold, sizeof(float));
+	values += sizeof(float);
+
+	for (std::size_t i=0; i<thresholds.size(); ++i) {
+		float node_values[DENSE_INPUT_COUNT + 4];
+		std::copy(input_weights.begin() + static_cast<std::ptrdiff_t>(i*DENSE_INPUT_COUNT),
+			input_weights.begin() + static_cast<std::ptrdiff_t>((i+1)*DENSE_INPUT_COUNT), node_values);
+		node_values[DENSE_INPUT_COUNT] = thresholds[i];
+		node_values[DENSE_INPUT_COUNT+1] = output_weights[i];
+		node_values[DENSE_INPUT_COUNT+2] = carryover_state.context_values[i];
+		node_values[DENSE_INPUT_COUNT+3] = context_weights[i];
+		std::memcpy(values, node_values, sizeof(node_values));
+		values += sizeof(node_values);
+
+		*values++ = static_cast<char>(has_context[i]);
+	}
+}
+
+std::size_t DenseNetwork::readGenomeSize(const char* genome)
+{
+	std::uint16_t counts[2];
+	std::memcpy(counts, genome + 2, sizeof(counts));
+	return DENSE_GENOME_HEADER_SIZE + sizeof(float) + counts[0] * ((DENSE_INPUT_COUNT + 4) * sizeof(float) + 1);
+}
+
+std::size_t DenseNetwork::genomeHeaderSize()
+{
+	return DENSE_GENOME_HEADER_SIZE;
+}
+
+/*At most DENSE_MAX_NODES cognitive nodes, and as many context flags set as the context node count*/
+bool DenseNetwork::isValidGenome(const char* genome)
+{
+	std::uint16_t counts[2];
+	std::memcpy(counts, genome + 2, sizeof(counts));
+	if (counts[0] > DENSE_MAX_NODES) return false;
+
+	int context_nodes = 0;
+	const char* flag = genome + DENSE_GENOME_HEADER_SIZE + sizeof(float) + (DENSE_INPUT_COUNT + 4) * sizeof(float);
+	for (int i=0; i<counts[0]; ++i, flag += (DENSE_INPUT_COUNT + 4) * sizeof(float) + 1) {
+		if (*flag != 0) context_nodes++;
+	}
+	return context_nodes == counts[1];
+}
+
+/*True if both networks have the same structure and values (context values are not compared)*/
+bool DenseNetwork::operator==(const DenseNetwork& nn) const
+{
+	return context_node_count == nn.context_node_count
+		and cooperate_by_default == nn.cooperate_by_default
+		and output_node_threshold == nn.output_node_threshold
+		and input_weights == nn.input_weights
+		and thresholds == nn.thresholds
+		and output_weights == nn.output_weights
+		and context_weights == nn.context_weights
+		and has_context == nn.has_context;
+}
+
+bool DenseNetwork::operator!=(const DenseNetwork& nn) const
+{
+	return not operator==(nn);
+}
+
+
+/**---------- MatchBatcher ----------**/
+
+/*
+Each side of a match is a slot of its network. Slots of a network are kept contiguous and ordered
+so that the running ones come first: the running slots' inputs and context values are then the
+first rows of the network's buffers, and a single evaluateBatch call computes all of its decisions.*/
+struct BatchSlot
+{
+	int match; //index of the match in pairs
+	int side; //0 for the first player, 1 for the second
+};
+
+/*Buffers of MatchBatcher::play, kept from one generation to the next so that it does not allocate*/
+struct BatchBuffers
+{
+	std::vector<std::vector<BatchSlot>> slots; //slots of each network
+	std::vector<int> iterations; //iterations of each match
+	std::vector<std::array<bool, 2>> cooperates; //current choices of both sides
+	std::vector<std::array<payoff, 2>> last_payoffs; //last payoffs of both sides
+	std::vector<std::array<unsigned long, 2>> match_payoff_sums; //payoff sums of both sides
+	std::vector<std::vector<float>> contexts; //context values of each network's slots
+	std::vector<int> running; //running slots of each network
+	std::vector<float> inputs, probabilities; //batch of the network being evaluated
+};
+
+void MatchBatcher<DenseNetwork>::play(DenseNetwork* const* population, const std::vector<std::pair<int, int>>& pairs,
+	const Payoffs& payoffs, double* game_counts, double* payoff_sums, double& cooperations, double& defections)
+{
+	static thread_local BatchBuffers buffers;
+
+	//Number of slots of each network
+	int population_size = 0;
+	for (const std::pair<int, int>& pair : pairs) {
+		population_size = std::max(population_size, std::max(pair.first, pair.second) + 1);
+	}
+	std::vector<std::vector<BatchSlot>>& slots = buffers.slots;
+	slots.resize(static_cast<std::size_t>(population_size));
+	for (std::vector<BatchSlot>& player_slots : slots) {
+		player_slots.clear();
+	}
+
+	//Match state: iterations to play, current choices and payoff sums of both sides
+	std::size_t match_count = pairs.size();
+	std::vector<int>& iterations = buffers.iterations;
+	std::vector<std::array<bool, 2>>& cooperates = buffers.cooperates;
+	std::vector<std::array<payoff, 2>>& last_payoffs = buffers.last_payoffs;
+	std::vector<std::array<unsigned long, 2>>& match_payoff_sums = buffers.match_payoff_sums;
+	iterations.assign(match_count, 0);
+	cooperates.assign(match_count, std::array<bool, 2>());
+	last_payoffs.assign(match_count, std::array<payoff, 2>());
+	match_payoff_sums.assign(match_count, std::array<unsigned long, 2>());
+
+	//Same draws as Simulation::playEachOther: default choices, then the number of iterations
+	int longest_match = 0;
+	for (std::size_t m=0; m<match_count; ++m) {
+		int players[2] = {pairs[m].first, pairs[m].second};
+		for (int side=0; side<2; ++side) {
+			std::vector<BatchSlot>& player_slots = slots[static_cast<std::size_t>(players[side])];
+			player_slots.push_back(BatchSlot{static_cast<int>(m), side});
+			cooperates[m][static_cast<std::size_t>(side)] = (*population[players[side]])();
+		}
+		iterations[m] = RNG::getIterationCount();
+		match_payoff_sums[m] = {{0, 0}};
+		longest_match = std::max(longest_match, iterations[m]);
+	}
+
+	//Context values of every slot, from a new state of the network (a copy of its carryover state)
+	std::vector<std::vector<float>>& contexts = buffers.contexts;
+	std::vector<int>& running = buffers.running; //running slots of each network
+	contexts.resize(static_cast<std::size_t>(population_size));
+	running.resize(static_cast<std::size_t>(population_size));
+	for (std::size_t player=0; player<slots.size(); ++player) {
+		const DenseNetwork::State& state = population[player]->getCarryoverState();
+		std::size_t nodes = state.context_values.size();
+		contexts[player].resize(slots[player].size() * nodes);
+		for (std::size_t slot=0; slot<slots[player].size(); ++slot) {
+			std::copy(state.context_values.begin(), state.context_values.end(), contexts[player].begin() + static_cast<std::ptrdiff_t>(slot*nodes));
+		}
+		running[player] = static_cast<int>(slots[player].size());
+	}
+
+	std::vector<float>& inputs = buffers.inputs;
+	std::vector<float>& probabilities = buffers.probabilities;
+	for (int iteration=0; iteration<longest_match; ++iteration) {
+		//Results of this iteration for every running match
+		for (std::size_t m=0; m<match_count; ++m) {
+			if (iteration >= iterations[m]) continue;
+
+			for (int side=0; side<2; ++side) {
+				if (cooperates[m][static_cast<std::size_t>(side)]) cooperations += 1;
+				else defections += 1;
+			}
+			payoffs.payoffsFromChoices(cooperates[m][0], cooperates[m][1], last_payoffs[m][0], last_payoffs[m][1]);
+			match_payoff_sums[m][0] += last_payoffs[m][0];
+			match_payoff_sums[m][1] += last_payoffs[m][1];
+		}
+
+		//Decisions for the next iteration, one batch per network
+		for (std::size_t player=0; player<slots.size(); ++player) {
+			std::vector<BatchSlot>& player_slots = slots[player];
+			std::size_t nodes = static_cast<std::size_t>(population[player]->getCognitiveNodeCount());
+
+			//Move the slots of finished matches after the running ones
+			int& running_count = running[player];
+			for (int slot=running_count-1; slot>=0; --slot) {
+				const BatchSlot& current = player_slots[static_cast<std::size_t>(slot)];
+				if (iteration+1 < iterations[static_cast<std::size_t>(current.match)]) continue;
+
+				int last = --running_count;
+				if (slot != last) {
+					std::swap(player_slots[static_cast<std::size_t>(slot)], player_slots[static_cast<std::size_t>(last)]);
+					std::swap_ranges(contexts[player].begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(slot)*nodes),
+						contexts[player].begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(slot+1)*nodes),
+						contexts[player].begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(last)*nodes));
+				}
+			}
+			if (running_count == 0) continue;
+
+			//Inputs of the running slots: own payoff, then the opponent's
+			std::size_t batch = static_cast<std::size_t>(running_count);
+			inputs.resize(batch * DENSE_INPUT_COUNT);
+			probabilities.resize(batch);
+			for (std::size_t slot=0; slot<batch; ++slot) {
+				const BatchSlot& current = player_slots[slot];
+				const std::array<payoff, 2>& match_payoffs = last_payoffs[static_cast<std::size_t>(current.match)];
+				inputs[slot*DENSE_INPUT_COUNT] = static_cast<float>(match_payoffs[static_cast<std::size_t>(current.side)]);
+				inputs[slot*DENSE_INPUT_COUNT+1] = static_cast<float>(match_payoffs[static_cast<std::size_t>(1 - current.side)]);
+			}
+
+			population[player]->evaluateBatch(inputs.data(), contexts[player].data(), running_count, probabilities.data());
+
+			for (std::size_t slot=0; slot<batch; ++slot) {
+				const BatchSlot& current = player_slots[slot];
+				bool decision = (nodes == 0) ? (*population[player])()
+					: RNG::getTrueWithProbability(static_cast<double>(probabilities[slot]));
+				cooperates[static_cast<std::size_t>(current.match)][static_cast<std::size_t>(current.side)] = decision;
+			}
+		}
+	}
+
+	//Add the results to the counters
+	for (std::size_t m=0; m<match_count; ++m) {
+		int players[2] = {pairs[m].first, pairs[m].second};
+		for (std::size_t side=0; side<2; ++side) {
+			game_counts[players[side]] += iterations[m];
+			payoff_sums[players[side]] += static_cast<double>(match_payoff_sums[m][side]);
+		}
+	}
+}
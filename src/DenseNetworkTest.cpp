@@ -0,0 +1,131 @@
+#include "DenseNetworkTest.hpp"
+
+void testDenseStructure();
+void testDenseEvaluation();
+void testDenseMatches();
+
+void testDenseNetwork()
+{
+	std::cout << "Testing DenseNetwork...";
+	
+	testDenseStructure();
+	testDenseEvaluation();
+	testDenseMatches();
+	
+	std::cout << " done!" << std::endl;
+}
+
+void testDenseStructure()
+{
+	///Default construction follows NeuralNetwork
+	DenseNetwork small;
+	assert(small.getInnerNodeCount() >= 0 and small.getInnerNodeCount() <= MAXINITIALNODES);
+	
+	///Large networks
+	DenseNetwork::setInitialNodeCount(DENSE_TEST_NODES);
+	DenseNetwork network;
+	DenseNetwork::setInitialNodeCount(-1);
+	assert(network.getCognitiveNodeCount() == DENSE_TEST_NODES and network.getContextNodeCount() == 0);
+	
+	///Node addition and removal
+	network.addContextNode();
+	network.addContextNode();
+	assert(network.getContextNodeCount() == 2 and network.getInnerNodeCount() == DENSE_TEST_NODES + 2);
+	network.removeContextNode();
+	assert(network.getContextNodeCount() == 1);
+	network.addCognitiveNode();
+	assert(network.getCognitiveNodeCount() == DENSE_TEST_NODES + 1);
+	while (network.getCognitiveNodeCount() > 1) network.removeCognitiveNode();
+	assert(network.getContextNodeCount() <= 1);
+	for (int i=0; i<DENSE_MAX_NODES*2 + 1; ++i) network.addNode();
+	assert(network.getInnerNodeCount() == DENSE_MAX_NODES*2);
+	
+	///Mutation parameters
+	assert(network.getParameterCount(PARAMETER_NODE_THRESHOLD) == DENSE_MAX_NODES);
+	assert(network.getParameterCount(PARAMETER_OUTPUT_THRESHOLD) == 1);
+	DenseNetwork mutated(network);
+	assert(mutated == network and mutated.hash() == network.hash());
+	mutated.mutateParameter(PARAMETER_OTHER_PAYOFF_WEIGHT, DENSE_MAX_NODES-1);
+	assert(mutated != network);
+	
+	///Genome round trip
+	std::vector<char> genome(network.getGenomeSize());
+	network.writeGenome(genome.data());
+	assert(DenseNetwork::readGenomeSize(genome.data()) == genome.size());
+	DenseNetwork loaded(genome.data());
+	assert(loaded == network and loaded.hash() == network.hash());
+}
+
+void testDenseEvaluation()
+{
+	DenseNetwork::setInitialNodeCount(DENSE_TEST_NODES);
+	DenseNetwork network;
+	DenseNetwork::setInitialNodeCount(-1);
+	for (int i=0; i<DENSE_TEST_NODES/2; ++i) network.addContextNode();
+	
+	///Batches give the same results as evaluations one at a time
+	std::vector<float> inputs, contexts(DENSE_TEST_BATCH * DENSE_TEST_NODES, 0.0f);
+	std::vector<DenseNetwork*> copies; //copies have zero context values, as the batch contexts
+	for (int row=0; row<DENSE_TEST_BATCH; ++row) {
+		inputs.push_back(static_cast<float>(row % 6));
+		inputs.push_back(static_cast<float>(row / 6));
+		copies.push_back(new DenseNetwork(network));
+	}
+	std::vector<float> probabilities(DENSE_TEST_BATCH);
+	
+	for (int iteration=0; iteration<3; ++iteration) {
+		network.evaluateBatch(inputs.data(), contexts.data(), DENSE_TEST_BATCH, probabilities.data());
+		for (int row=0; row<DENSE_TEST_BATCH; ++row) {
+			float probability = copies[static_cast<std::size_t>(row)]->getCooperationProbability(
+				static_cast<payoff>(inputs[static_cast<std::size_t>(2*row)]), static_cast<payoff>(inputs[static_cast<std::size_t>(2*row+1)]));
+			assert(probability == probabilities[static_cast<std::size_t>(row)]);
+			assert(probability >= 0 and probability <= 1);
+		}
+	}
+	for (DenseNetwork* copy : copies) {
+		delete copy;
+	}
+	
+	///Networks without cognitive nodes use their default choice
+	DenseNetwork empty;
+	while (empty.getCognitiveNodeCount() > 0) empty.removeCognitiveNode();
+	assert(empty.getCooperationProbability(1, 2) == (empty() ? 1.0f : 0.0f));
+}
+
+void testDenseMatches()
+{
+	Payoffs payoffs = Payoffs::getPayoffsForGameType("IPD");
+	
+	DenseNetwork::setInitialNodeCount(DENSE_TEST_NODES / 10);
+	std::vector<DenseNetwork*> population;
+	for (int i=0; i<DENSE_TEST_POPULATION; ++i) {
+		population.push_back(new DenseNetwork());
+		population.back()->addContextNode();
+	}
+	DenseNetwork::setInitialNodeCount(-1);
+	
+	std::vector<std::pair<int, int>> pairs;
+	for (int a=0; a<DENSE_TEST_POPULATION-1; ++a) {
+		for (int b=a+1; b<DENSE_TEST_POPULATION; ++b) {
+			pairs.emplace_back(a, b);
+		}
+	}
+	
+	///Every iteration counts two choices and each player's game count
+	double game_counts[DENSE_TEST_POPULATION] = {}, payoff_sums[DENSE_TEST_POPULATION] = {};
+	double cooperations = 0, defections = 0;
+	assert(MatchBatcher<DenseNetwork>::supported and not MatchBatcher<NeuralNetwork>::supported);
+	MatchBatcher<DenseNetwork>::play(population.data(), pairs, payoffs, game_counts, payoff_sums, cooperations, defections);
+	
+	double total_games = 0;
+	for (int i=0; i<DENSE_TEST_POPULATION; ++i) {
+		assert(game_counts[i] >= DENSE_TEST_POPULATION-1); //at least one iteration per match
+		assert(payoff_sums[i] >= 0);
+		total_games += game_counts[i];
+	}
+	assert(cooperations + defections == total_games);
+	
+	for (DenseNetwork* network : population) {
+		delete network;
+	}
+}
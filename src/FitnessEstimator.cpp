@@ -0,0 +1,156 @@
+#include "FitnessEstimator.hpp"
+
+#include "Rng.hpp"
+
+#include <limits>
+#include <cassert>
+
+
+FitnessEstimator::FitnessEstimator(int population_size, unsigned units_per_pair, bool with_control_variate):
+	pair_units(units_per_pair),
+	control_variate(with_control_variate),
+	unit_iterations(ESTIMATOR_UNIT_MATCHES * RNG::getMeanIterationCount()),
+	samples(static_cast<std::size_t>(population_size))
+{
+	assert(pair_units > 0);
+}
+
+void FitnessEstimator::clear()
+{
+	for (std::vector<AntitheticSample>& individual_samples : samples) {
+		individual_samples.clear();
+	}
+}
+
+void FitnessEstimator::addSample(int individual, const AntitheticSample& sample)
+{
+	samples[static_cast<std::size_t>(individual)].push_back(sample);
+}
+
+/*
+Estimates each individual from its replicates k (its units k summed over its pairs), with payoffs S_k
+and game iterations L_k. With the control variate (and more than 2 units per pair), the slope b is
+regressed on the deviations of the units of each pair from the pair's means, residuals are
+S_k - mean(S) - b (L_k - mean(L)) with n - 2 degrees of freedom, and the error of b adds
+(mean(L) - E[L])^2 / sum((L_k - mean(L))^2) to the 1 / n of a mean. Without it, residuals are S_k - R L_k
+with n - 1. The variance of a single match uses the residuals of every match around the ratio of its pair.*/
+void FitnessEstimator::estimate(double* payoff_sums, double* game_counts)
+{
+	double variance_sum = 0, size_sum = 0;
+	int variance_count = 0, size_count = 0;
+	bool corrected = control_variate and pair_units > 2;
+	double n = static_cast<double>(pair_units);
+	
+	for (std::size_t individual=0; individual<samples.size(); ++individual) {
+		const std::vector<AntitheticSample>& units = samples[individual];
+		if (units.empty()) continue;
+		assert(units.size() % pair_units == 0);
+		std::size_t pair_count = units.size() / pair_units;
+		
+		//sums of each unit, of each replicate (units k over the pairs) and of each pair
+		std::vector<double> payoffs(units.size()), iterations(units.size());
+		std::vector<double> replicate_payoffs(pair_units, 0), replicate_iterations(pair_units, 0);
+		std::vector<double> pair_payoffs(pair_count, 0), pair_iterations(pair_count, 0);
+		for (std::size_t index=0; index<units.size(); ++index) {
+			payoffs[index] = iterations[index] = 0;
+			for (int match=0; match<ESTIMATOR_UNIT_MATCHES; ++match) {
+				payoffs[index] += units[index].payoffs[match];
+				iterations[index] += units[index].iterations[match];
+			}
+			replicate_payoffs[index % pair_units] += payoffs[index];
+			replicate_iterations[index % pair_units] += iterations[index];
+			pair_payoffs[index / pair_units] += payoffs[index];
+			pair_iterations[index / pair_units] += iterations[index];
+		}
+		double payoff_total = 0, iteration_total = 0;
+		for (std::size_t unit=0; unit<pair_units; ++unit) {
+			payoff_total += replicate_payoffs[unit];
+			iteration_total += replicate_iterations[unit];
+		}
+		double mean_payoffs = payoff_total / n;
+		double mean_iterations = iteration_total / n;
+		double expected_iterations = static_cast<double>(pair_count) * unit_iterations;
+		double ratio = payoff_total / iteration_total;
+		
+		//estimate, with the slope regressed within the pairs
+		double slope = 0;
+		if (corrected) {
+			double covariance = 0, pair_iteration_variance = 0;
+			for (std::size_t index=0; index<units.size(); ++index) {
+				std::size_t pair = index / pair_units;
+				double iteration_deviation = iterations[index] - pair_iterations[pair] / n;
+				covariance += (payoffs[index] - pair_payoffs[pair] / n) * iteration_deviation;
+				pair_iteration_variance += iteration_deviation * iteration_deviation;
+			}
+			if (pair_iteration_variance > 0) slope = covariance / pair_iteration_variance;
+			
+			double corrected_payoffs = mean_payoffs - slope * (mean_iterations - expected_iterations);
+			payoff_sums[individual] += n * corrected_payoffs;
+			game_counts[individual] += n * expected_iterations;
+		}
+		else {
+			payoff_sums[individual] += payoff_total;
+			game_counts[individual] += iteration_total;
+		}
+		
+		//residuals of the replicates and their scale
+		if (pair_units < 2) continue;
+		double degrees = n - (corrected ? 2 : 1);
+		double squared_residuals = 0, iteration_squares = 0;
+		for (std::size_t unit=0; unit<pair_units; ++unit) {
+			double residual = corrected
+				? replicate_payoffs[unit] - mean_payoffs - slope * (replicate_iterations[unit] - mean_iterations)
+				: replicate_payoffs[unit] - ratio * replicate_iterations[unit];
+			squared_residuals += residual * residual;
+			iteration_squares += (replicate_iterations[unit] - mean_iterations) * (replicate_iterations[unit] - mean_iterations);
+		}
+		double mean_factor = 1 / n;
+		if (corrected and iteration_squares > 0)
+			mean_factor += (mean_iterations - expected_iterations) * (mean_iterations - expected_iterations) / iteration_squares;
+		double scale = corrected ? expected_iterations : mean_iterations;
+		double estimate_variance = squared_residuals / degrees * mean_factor / (scale * scale);
+		variance_sum += estimate_variance;
+		variance_count += 1;
+		
+		//variance of the payoffs per iteration of a single match, within the pairs
+		double match_residuals = 0;
+		for (std::size_t index=0; index<units.size(); ++index) {
+			std::size_t pair = index / pair_units;
+			double pair_ratio = pair_payoffs[pair] / pair_iterations[pair];
+			for (int match=0; match<ESTIMATOR_UNIT_MATCHES; ++match) {
+				double residual = units[index].payoffs[match] - pair_ratio * units[index].iterations[match];
+				match_residuals += residual * residual;
+			}
+		}
+		double match_count = static_cast<double>(units.size() * ESTIMATOR_UNIT_MATCHES);
+		double match_iterations = iteration_total / match_count;
+		double match_variance = match_residuals / (match_count - static_cast<double>(pair_count)) 
+			/ (match_iterations * match_iterations);
+		if (estimate_variance > 0) {
+			size_sum += match_variance / estimate_variance;
+			size_count += 1;
+		}
+	}
+	
+	if (pair_units < 2) {
+		variance = effective_sample_size = std::numeric_limits<double>::quiet_NaN();
+		return;
+	}
+	variance = (variance_count > 0) ? variance_sum / variance_count : 0;
+	effective_sample_size = (size_count > 0) ? size_sum / size_count : 0;
+}
+
+double FitnessEstimator::getVariance() const
+{
+	return variance;
+}
+
+double FitnessEstimator::getEffectiveSampleSize() const
+{
+	return effective_sample_size;
+}
+
+std::size_t FitnessEstimator::getSampleCount(int individual) const
+{
+	return samples[static_cast<std::size_t>(individual)].size();
+}
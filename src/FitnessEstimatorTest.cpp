@@ -0,0 +1,105 @@
+#include "FitnessEstimatorTest.hpp"
+
+
+/*Unit whose matches last the given iterations, with payoffs rate * iterations + bonus*/
+static AntitheticSample unitSample(int first_iterations, int second_iterations, double rate, double bonus)
+{
+	AntitheticSample sample;
+	sample.iterations = {{static_cast<double>(first_iterations), static_cast<double>(second_iterations)}};
+	for (int match=0; match<ESTIMATOR_UNIT_MATCHES; ++match) {
+		sample.payoffs[match] = rate * sample.iterations[match] + bonus;
+	}
+	return sample;
+}
+
+/*Tail probability of the unit's first match, evenly spaced*/
+static double unitTail(int unit)
+{
+	return (unit + 0.5) / ESTIMATOR_TEST_UNITS;
+}
+
+void testFitnessEstimator()
+{
+	std::cout << "Testing FitnessEstimator...";
+	
+	///Payoffs proportional to the iterations are estimated exactly, without variance
+	FitnessEstimator proportional(2, ESTIMATOR_TEST_UNITS, false);
+	for (int unit=0; unit<ESTIMATOR_TEST_UNITS; ++unit) {
+		double tail = unitTail(unit);
+		proportional.addSample(0, unitSample(RNG::getIterationCountAt(tail), RNG::getIterationCountAt(1 - tail), ESTIMATOR_TEST_RATE, 0));
+	}
+	double payoff_sums[2] = {0, 0}, game_counts[2] = {0, 0};
+	proportional.estimate(payoff_sums, game_counts);
+	assert(std::fabs(payoff_sums[0] / game_counts[0] - ESTIMATOR_TEST_RATE) < 1e-12);
+	assert(payoff_sums[1] == 0 and game_counts[1] == 0); //no sample
+	assert(proportional.getVariance() == 0 and proportional.getEffectiveSampleSize() == 0);
+	assert(proportional.getSampleCount(0) == ESTIMATOR_TEST_UNITS);
+	
+	proportional.clear();
+	assert(proportional.getSampleCount(0) == 0);
+	
+	///Antithetic lengths estimate payoffs per iteration with less variance than unrelated lengths
+	FitnessEstimator antithetic(1, ESTIMATOR_TEST_UNITS, false), unrelated(1, ESTIMATOR_TEST_UNITS, false);
+	for (int unit=0; unit<ESTIMATOR_TEST_UNITS; ++unit) {
+		double tail = unitTail(unit);
+		double other_tail = unitTail((unit * ESTIMATOR_TEST_SHUFFLE + 1) % ESTIMATOR_TEST_UNITS);
+		antithetic.addSample(0, unitSample(RNG::getIterationCountAt(tail), RNG::getIterationCountAt(1 - tail), 
+			ESTIMATOR_TEST_RATE, ESTIMATOR_TEST_BONUS));
+		unrelated.addSample(0, unitSample(RNG::getIterationCountAt(tail), RNG::getIterationCountAt(other_tail), 
+			ESTIMATOR_TEST_RATE, ESTIMATOR_TEST_BONUS));
+	}
+	double antithetic_sums[1] = {0}, antithetic_counts[1] = {0}, unrelated_sums[1] = {0}, unrelated_counts[1] = {0};
+	antithetic.estimate(antithetic_sums, antithetic_counts);
+	unrelated.estimate(unrelated_sums, unrelated_counts);
+	assert(antithetic.getVariance() > 0 and antithetic.getVariance() < unrelated.getVariance());
+	assert(antithetic.getEffectiveSampleSize() > unrelated.getEffectiveSampleSize());
+	assert(antithetic.getEffectiveSampleSize() > ESTIMATOR_UNIT_MATCHES * ESTIMATOR_TEST_UNITS);
+	
+	///The control variate removes the payoffs explained by the deviation of the iterations from their mean
+	FitnessEstimator corrected(1, ESTIMATOR_TEST_UNITS, true), uncorrected(1, ESTIMATOR_TEST_UNITS, false);
+	for (int unit=0; unit<ESTIMATOR_TEST_UNITS; ++unit) {
+		double tail = unitTail(unit);
+		AntitheticSample sample = unitSample(RNG::getIterationCountAt(tail), RNG::getIterationCountAt(tail), 
+			ESTIMATOR_TEST_RATE, ESTIMATOR_TEST_BONUS);
+		corrected.addSample(0, sample);
+		uncorrected.addSample(0, sample);
+	}
+	double corrected_sums[1] = {0}, corrected_counts[1] = {0}, uncorrected_sums[1] = {0}, uncorrected_counts[1] = {0};
+	corrected.estimate(corrected_sums, corrected_counts);
+	uncorrected.estimate(uncorrected_sums, uncorrected_counts);
+	
+	//a unit's payoffs are exactly linear in its iterations: the estimate is that of the mean iterations
+	double expected = ESTIMATOR_TEST_RATE + ESTIMATOR_TEST_BONUS / RNG::getMeanIterationCount();
+	assert(std::fabs(corrected_sums[0] / corrected_counts[0] - expected) < 1e-9);
+	assert(std::fabs(corrected_counts[0] - ESTIMATOR_TEST_UNITS * ESTIMATOR_UNIT_MATCHES * RNG::getMeanIterationCount()) < 1e-6);
+	assert(corrected.getVariance() < 1e-20 and uncorrected.getVariance() > 0);
+	
+	///Units k of different pairs share their random numbers, so they are not independent of each other
+	FitnessEstimator one_pair(1, ESTIMATOR_TEST_UNITS, false), same_pairs(1, ESTIMATOR_TEST_UNITS, false);
+	for (int pair=0; pair<ESTIMATOR_TEST_PAIRS; ++pair) {
+		for (int unit=0; unit<ESTIMATOR_TEST_UNITS; ++unit) {
+			double tail = unitTail(unit);
+			AntitheticSample sample = unitSample(RNG::getIterationCountAt(tail), RNG::getIterationCountAt(tail), 
+				ESTIMATOR_TEST_RATE, ESTIMATOR_TEST_BONUS);
+			if (pair == 0) one_pair.addSample(0, sample);
+			same_pairs.addSample(0, sample);
+		}
+	}
+	double one_pair_sums[1] = {0}, one_pair_counts[1] = {0}, same_pairs_sums[1] = {0}, same_pairs_counts[1] = {0};
+	one_pair.estimate(one_pair_sums, one_pair_counts);
+	same_pairs.estimate(same_pairs_sums, same_pairs_counts);
+	assert(std::fabs(same_pairs.getVariance() / one_pair.getVariance() - 1) < 1e-9);
+	
+	///A single unit per pair has no variance
+	FitnessEstimator single_unit(1, 1, true);
+	for (int pair=0; pair<ESTIMATOR_TEST_PAIRS; ++pair) {
+		single_unit.addSample(0, unitSample(RNG::getIterationCountAt(0.3), RNG::getIterationCountAt(0.7), 
+			ESTIMATOR_TEST_RATE, ESTIMATOR_TEST_BONUS));
+	}
+	double single_sums[1] = {0}, single_counts[1] = {0};
+	single_unit.estimate(single_sums, single_counts);
+	assert(single_counts[0] > 0);
+	assert(std::isnan(single_unit.getVariance()) and std::isnan(single_unit.getEffectiveSampleSize()));
+	
+	std::cout << " done!" << std::endl;
+}
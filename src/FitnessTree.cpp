@@ -0,0 +1,82 @@
+#include "FitnessTree.hpp"
+
+
+/*Constructor, every weight is 0*/
+FitnessTree::FitnessTree(std::size_t size):
+	weights(size, 0),
+	nodes(size + 1, 0),
+	top_step(1)
+{
+	assert(size > 0);
+	while (top_step * 2 <= size) top_step *= 2;
+}
+
+/*Builds the partial sums in one pass: each node adds its sum to its parent*/
+void FitnessTree::assign(const std::vector<double>& new_weights)
+{
+	assert(new_weights.size() == weights.size());
+	
+	for (std::size_t i=0; i<weights.size(); ++i) {
+		weights[i] = (new_weights[i] > 0) ? new_weights[i] : 0;
+		nodes[i + 1] = weights[i];
+	}
+	nodes[0] = 0;
+	for (std::size_t node=1; node<nodes.size(); ++node) {
+		std::size_t parent = node + (node & (~node + 1));
+		if (parent < nodes.size()) nodes[parent] += nodes[node];
+	}
+}
+
+void FitnessTree::set(std::size_t index, double weight)
+{
+	assert(index < weights.size());
+	
+	if (weight < 0) weight = 0;
+	double difference = weight - weights[index];
+	weights[index] = weight;
+	
+	for (std::size_t node=index+1; node<nodes.size(); node += node & (~node + 1)) {
+		nodes[node] += difference;
+	}
+}
+
+double FitnessTree::get(std::size_t index) const
+{
+	return weights.at(index);
+}
+
+double FitnessTree::total() const
+{
+	double sum = 0;
+	for (std::size_t node=weights.size(); node>0; node -= node & (~node + 1)) {
+		sum += nodes[node];
+	}
+	return sum;
+}
+
+std::size_t FitnessTree::size() const
+{
+	return weights.size();
+}
+
+/*
+Descends the implicit tree, skipping every node whose partial sum is not above the remaining target.
+Rounding in the partial sums may leave the target at the end of the range: the last index with a
+positive weight is returned then, so that an individual without weight is never selected.*/
+std::size_t FitnessTree::find(double target) const
+{
+	std::size_t position = 0; //number of weights known to be at most the target
+	for (std::size_t step=top_step; step>0; step /= 2) {
+		std::size_t node = position + step;
+		if (node < nodes.size() and nodes[node] <= target) {
+			position = node;
+			target -= nodes[node];
+		}
+	}
+	
+	while (position >= weights.size() or weights[position] <= 0) {
+		assert(position > 0);
+		position--;
+	}
+	return position;
+}
@@ -0,0 +1,51 @@
+#include "FitnessTreeTest.hpp"
+
+
+/*Index found by a linear scan of the cumulative weights*/
+static std::size_t linearFind(const std::vector<double>& weights, double target)
+{
+	double cumulative = 0;
+	for (std::size_t i=0; i<weights.size(); ++i) {
+		cumulative += weights[i];
+		if (target < cumulative) return i;
+	}
+	return weights.size() - 1;
+}
+
+void testFitnessTree()
+{
+	std::cout << "Testing FitnessTree...";
+	
+	///Individuals without weight are never found, negative weights count as 0
+	FitnessTree tree(5);
+	tree.assign({1, 0, 3, 2, -1});
+	assert(tree.total() == 6 and tree.get(4) == 0);
+	assert(tree.find(0) == 0 and tree.find(0.5) == 0);
+	assert(tree.find(1) == 2 and tree.find(3.5) == 2);
+	assert(tree.find(4) == 3 and tree.find(5.5) == 3);
+	
+	///Changing one weight
+	tree.set(1, 2);
+	assert(tree.total() == 8);
+	assert(tree.find(1) == 1 and tree.find(3) == 2);
+	tree.set(4, -2);
+	assert(tree.total() == 8 and tree.get(4) == 0);
+	
+	///Same results as a linear scan, after assignments and changes
+	std::vector<double> weights(FITNESSTREE_TEST_SIZE);
+	for (double& weight : weights) {
+		weight = RNG::getRandomProbability();
+	}
+	FitnessTree random_tree(FITNESSTREE_TEST_SIZE);
+	random_tree.assign(weights);
+	for (int target_index=0; target_index<FITNESSTREE_TEST_TARGETS; ++target_index) {
+		std::size_t changed = static_cast<std::size_t>(RNG::getRandomInt(0, FITNESSTREE_TEST_SIZE-1));
+		weights[changed] = RNG::getRandomProbability();
+		random_tree.set(changed, weights[changed]);
+		
+		double target = RNG::getRandomProbability() * random_tree.total();
+		assert(random_tree.find(target) == linearFind(weights, target));
+	}
+	
+	std::cout << " done!" << std::endl;
+}
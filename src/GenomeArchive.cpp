@@ -0,0 +1,289 @@
+#include "GenomeArchive.hpp"
+#include "DenseNetwork.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define ARCHIVE_ALIGNMENT 8 //snapshots start on multiples of 8 bytes so that headers can be read in place
+
+static_assert(sizeof(ArchiveHeader) % ARCHIVE_ALIGNMENT == 0, "GenomeArchive: the first snapshot must be aligned");
+
+
+/**---------- Writer ----------**/
+
+GenomeArchiveWriter::GenomeArchiveWriter(const std::string& archive_file, const char* precision, std::uint64_t seed,
+	std::uint32_t population_size, std::uint32_t interval):
+	output(archive_file.c_str(), std::ios::binary | std::ios::trunc),
+	file_name(archive_file)
+{
+	if (not output)
+		throw std::runtime_error("GenomeArchive: cannot open file " + file_name);
+	
+	ArchiveHeader header = {};
+	std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+	header.version = ARCHIVE_VERSION;
+	header.byte_order = ARCHIVE_BYTE_ORDER;
+	std::strncpy(header.precision, precision, ARCHIVE_PRECISION_SIZE - 1);
+	header.seed = seed;
+	header.population_size = population_size;
+	header.interval = interval;
+	write(&header, sizeof(header));
+}
+
+GenomeArchiveWriter::~GenomeArchiveWriter()
+{
+	//errors cannot be reported from a destructor, the archive stays readable without its footer
+	try {
+		close();
+	}
+	catch (const std::exception&) {}
+}
+
+void GenomeArchiveWriter::write(const void* data, std::size_t size)
+{
+	output.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+	if (not output)
+		throw std::runtime_error("GenomeArchive: cannot write to file " + file_name);
+	position += size;
+}
+
+/*Builds the snapshot in memory, then writes it at once*/
+template<typename Network>
+void GenomeArchiveWriter::append(unsigned long generation, Network* const* population, int population_size)
+{
+	assert(output.is_open());
+	assert(index.empty() or generation > index.back().generation);
+	
+	std::size_t offsets_size = (static_cast<std::size_t>(population_size) + 1) * sizeof(std::uint64_t);
+	std::size_t snapshot_size = sizeof(SnapshotHeader) + offsets_size;
+	for (int i=0; i<population_size; ++i) {
+		snapshot_size += population[i]->getGenomeSize();
+	}
+	snapshot_size = (snapshot_size + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+	buffer.assign(snapshot_size, 0);
+	
+	SnapshotHeader snapshot = {};
+	snapshot.generation = generation;
+	snapshot.size = snapshot_size;
+	snapshot.individual_count = static_cast<std::uint32_t>(population_size);
+	std::memcpy(buffer.data(), &snapshot, sizeof(snapshot));
+	
+	//offset table followed by the genomes
+	std::uint64_t* offsets = reinterpret_cast<std::uint64_t*>(buffer.data() + sizeof(SnapshotHeader));
+	std::uint64_t offset = sizeof(SnapshotHeader) + offsets_size;
+	for (int i=0; i<population_size; ++i) {
+		offsets[i] = offset;
+		population[i]->writeGenome(buffer.data() + offset);
+		offset += population[i]->getGenomeSize();
+	}
+	offsets[population_size] = offset;
+	
+	index.push_back({generation, position});
+	write(buffer.data(), buffer.size());
+}
+
+void GenomeArchiveWriter::close()
+{
+	if (not output.is_open()) return;
+	
+	ArchiveFooter footer = {};
+	footer.snapshot_count = index.size();
+	footer.index_offset = position;
+	std::memcpy(footer.magic, ARCHIVE_INDEX_MAGIC, sizeof(footer.magic));
+	
+	if (not index.empty()) write(index.data(), index.size() * sizeof(ArchiveIndexEntry));
+	write(&footer, sizeof(footer));
+	output.close();
+}
+
+
+/**---------- Reader ----------**/
+
+GenomeArchiveReader::GenomeArchiveReader(const std::string& archive_file)
+{
+	int descriptor = open(archive_file.c_str(), O_RDONLY);
+	if (descriptor < 0)
+		throw std::runtime_error("GenomeArchive: cannot open file " + archive_file);
+	
+	struct stat file_stat;
+	if (fstat(descriptor, &file_stat) != 0 or file_stat.st_size < static_cast<off_t>(sizeof(ArchiveHeader))) {
+		::close(descriptor);
+		throw std::runtime_error("GenomeArchive: " + archive_file + " is not an archive");
+	}
+	size = static_cast<std::size_t>(file_stat.st_size);
+	
+	void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	::close(descriptor); //the mapping stays valid
+	if (address == MAP_FAILED)
+		throw std::runtime_error("GenomeArchive: cannot map file " + archive_file);
+	data = static_cast<const char*>(address);
+	
+	header = reinterpret_cast<const ArchiveHeader*>(data);
+	try {
+		check(std::memcmp(header->magic, ARCHIVE_MAGIC, sizeof(header->magic)) == 0, archive_file + " is not an archive");
+		check(header->version == ARCHIVE_VERSION, "unsupported version of " + archive_file);
+		check(header->byte_order == ARCHIVE_BYTE_ORDER, archive_file + " was written with another byte order");
+		loadIndex();
+	}
+	catch (...) {
+		munmap(const_cast<char*>(data), size);
+		throw;
+	}
+}
+
+GenomeArchiveReader::~GenomeArchiveReader()
+{
+	munmap(const_cast<char*>(data), size);
+}
+
+void GenomeArchiveReader::check(bool condition, const std::string& problem) const
+{
+	if (not condition)
+		throw std::runtime_error("GenomeArchive: " + problem);
+}
+
+/*
+Uses the footer index if present, otherwise walks through the snapshots up to the last complete one.
+Both check every snapshot in the same way, and that generations increase (see findSnapshot).*/
+void GenomeArchiveReader::loadIndex()
+{
+	if (size >= sizeof(ArchiveHeader) + sizeof(ArchiveFooter)) {
+		ArchiveFooter footer;
+		std::memcpy(&footer, data + size - sizeof(ArchiveFooter), sizeof(footer));
+		
+		//without overflow: index_offset + snapshot_count * sizeof(ArchiveIndexEntry) == index_end
+		std::uint64_t index_end = size - sizeof(ArchiveFooter);
+		complete = std::memcmp(footer.magic, ARCHIVE_INDEX_MAGIC, sizeof(footer.magic)) == 0
+			and footer.index_offset >= sizeof(ArchiveHeader) and footer.index_offset <= index_end
+			and (index_end - footer.index_offset) % sizeof(ArchiveIndexEntry) == 0
+			and (index_end - footer.index_offset) / sizeof(ArchiveIndexEntry) == footer.snapshot_count;
+		
+		if (complete) {
+			index.resize(footer.snapshot_count);
+			if (not index.empty()) 
+				std::memcpy(index.data(), data + footer.index_offset, index.size() * sizeof(ArchiveIndexEntry));
+			for (std::size_t entry=0; entry<index.size(); ++entry) {
+				check(validSnapshot(index[entry].offset, footer.index_offset), "corrupted index");
+				check(reinterpret_cast<const SnapshotHeader*>(data + index[entry].offset)->generation == index[entry].generation
+					and (entry == 0 or index[entry-1].generation < index[entry].generation), "corrupted index");
+			}
+			return;
+		}
+	}
+	
+	std::uint64_t offset = sizeof(ArchiveHeader);
+	while (offset + sizeof(SnapshotHeader) <= size) {
+		const SnapshotHeader* current = reinterpret_cast<const SnapshotHeader*>(data + offset);
+		
+		//stop at a truncated snapshot or at the start of a partially written index
+		if (not validSnapshot(offset, size)) break;
+		if (not index.empty() and current->generation <= index.back().generation) break;
+		
+		index.push_back({current->generation, offset});
+		offset += current->size;
+	}
+}
+
+/*The snapshot's header, offsets and its declared size fit before end, and it is aligned*/
+bool GenomeArchiveReader::validSnapshot(std::uint64_t offset, std::uint64_t end) const
+{
+	if (offset < sizeof(ArchiveHeader) or offset % ARCHIVE_ALIGNMENT != 0 or end > size 
+		or offset > end or end - offset < sizeof(SnapshotHeader))
+		return false;
+	
+	const SnapshotHeader* current = reinterpret_cast<const SnapshotHeader*>(data + offset);
+	std::uint64_t minimum_size = sizeof(SnapshotHeader) + (current->individual_count + 1ULL) * sizeof(std::uint64_t);
+	return current->size >= minimum_size and current->size % ARCHIVE_ALIGNMENT == 0 and current->size <= end - offset;
+}
+
+const SnapshotHeader& GenomeArchiveReader::snapshot(std::size_t snapshot_index) const
+{
+	check(snapshot_index < index.size(), "no snapshot " + std::to_string(snapshot_index));
+	return *reinterpret_cast<const SnapshotHeader*>(data + index[snapshot_index].offset);
+}
+
+const ArchiveHeader& GenomeArchiveReader::getHeader() const
+{
+	return *header;
+}
+
+bool GenomeArchiveReader::isComplete() const
+{
+	return complete;
+}
+
+std::size_t GenomeArchiveReader::getSnapshotCount() const
+{
+	return index.size();
+}
+
+unsigned long GenomeArchiveReader::getGeneration(std::size_t snapshot_index) const
+{
+	check(snapshot_index < index.size(), "no snapshot " + std::to_string(snapshot_index));
+	return index[snapshot_index].generation;
+}
+
+/*Binary search in the index, which is sorted by generation*/
+long GenomeArchiveReader::findSnapshot(unsigned long generation) const
+{
+	std::vector<ArchiveIndexEntry>::const_iterator entry = std::lower_bound(index.begin(), index.end(), generation,
+		[](const ArchiveIndexEntry& left, unsigned long value){ return left.generation < value; });
+	
+	if (entry == index.end() or entry->generation != generation) return -1;
+	return entry - index.begin();
+}
+
+unsigned GenomeArchiveReader::getIndividualCount(std::size_t snapshot_index) const
+{
+	return snapshot(snapshot_index).individual_count;
+}
+
+const char* GenomeArchiveReader::getGenome(std::size_t snapshot_index, unsigned individual) const
+{
+	const SnapshotHeader& current = snapshot(snapshot_index);
+	check(individual < current.individual_count, "no individual " + std::to_string(individual));
+	
+	const char* snapshot_start = reinterpret_cast<const char*>(&current);
+	const std::uint64_t* offsets = reinterpret_cast<const std::uint64_t*>(snapshot_start + sizeof(SnapshotHeader));
+	std::uint64_t offsets_end = sizeof(SnapshotHeader) + (current.individual_count + 1ULL) * sizeof(std::uint64_t);
+	check(offsets[individual] >= offsets_end and offsets[individual] < offsets[individual + 1] 
+		and offsets[individual + 1] <= current.size, "corrupted snapshot");
+	
+	return snapshot_start + offsets[individual];
+}
+
+template<typename Network>
+Network* GenomeArchiveReader::loadIndividual(std::size_t snapshot_index, unsigned individual) const
+{
+	check(std::strncmp(header->precision, Network::precisionName(), ARCHIVE_PRECISION_SIZE) == 0,
+		std::string("archive precision is ") + header->precision);
+	
+	const char* genome = getGenome(snapshot_index, individual);
+	std::size_t genome_offset = static_cast<std::size_t>(genome - data);
+	check(Network::genomeHeaderSize() <= size - genome_offset, "corrupted genome");
+	check(Network::readGenomeSize(genome) <= size - genome_offset, "corrupted genome");
+	check(Network::isValidGenome(genome), "corrupted genome"); //node counts are only asserted by the constructor
+	
+	return new Network(genome);
+}
+
+
+/**---------- Available precisions ----------**/
+
+template void GenomeArchiveWriter::append<NeuralNetwork>(unsigned long generation, 
+	NeuralNetwork* const* population, int population_size);
+template void GenomeArchiveWriter::append<FloatNeuralNetwork>(unsigned long generation, 
+	FloatNeuralNetwork* const* population, int population_size);
+template void GenomeArchiveWriter::append<FixedNeuralNetwork>(unsigned long generation, 
+	FixedNeuralNetwork* const* population, int population_size);
+template void GenomeArchiveWriter::append<DenseNetwork>(unsigned long generation, 
+	DenseNetwork* const* population, int population_size);
+
+template NeuralNetwork* GenomeArchiveReader::loadIndividual<NeuralNetwork>(std::size_t snapshot_index, unsigned individual) const;
+template FloatNeuralNetwork* GenomeArchiveReader::loadIndividual<FloatNeuralNetwork>(std::size_t snapshot_index, unsigned individual) const;
+template FixedNeuralNetwork* GenomeArchiveReader::loadIndividual<FixedNeuralNetwork>(std::size_t snapshot_index, unsigned individual) const;
+template DenseNetwork* GenomeArchiveReader::loadIndividual<DenseNetwork>(std::size_t snapshot_index, unsigned individual) const;
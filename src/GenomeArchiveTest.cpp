@@ -0,0 +1,171 @@
+#include "GenomeArchiveTest.hpp"
+
+
+/*Writes an archive's contents to the test file of truncated archives*/
+static void writeArchive(const std::vector<char>& contents)
+{
+	std::ofstream output(GENOMEARCHIVE_TEST_TRUNCATED_FILE, std::ios::binary | std::ios::trunc);
+	output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+
+/*Returns true if reading the archive's contents throws*/
+static bool rejectsArchive(const std::vector<char>& contents)
+{
+	writeArchive(contents);
+	try {
+		GenomeArchiveReader reader(GENOMEARCHIVE_TEST_TRUNCATED_FILE);
+	}
+	catch (const std::runtime_error&) {
+		return true;
+	}
+	return false;
+}
+
+void testGenomeArchive()
+{
+	std::cout << "Testing GenomeArchive...";
+	
+	///Genome serialization
+	NeuralNetwork network;
+	for (int i=0; i<10; ++i) network.addNode();
+	std::vector<char> genome(network.getGenomeSize());
+	network.writeGenome(genome.data());
+	assert(NeuralNetwork::readGenomeSize(genome.data()) == genome.size());
+	NeuralNetwork copy(genome.data());
+	assert(copy == network and copy.hash() == network.hash());
+	assert(NeuralNetwork::isValidGenome(genome.data()));
+	
+	//node counts that the genome constructor would only assert
+	std::vector<char> wrong_context(genome);
+	wrong_context[2] = static_cast<char>(network.getContextNodeCount() + 1);
+	assert(not NeuralNetwork::isValidGenome(wrong_context.data()));
+	std::vector<char> too_many_nodes(NeuralNetwork::readGenomeSize(genome.data()) 
+		+ GENOME_NODE_VALUES * sizeof(double) + 1);
+	std::copy(genome.begin(), genome.end(), too_many_nodes.begin());
+	too_many_nodes[1] = static_cast<char>(MAXNODES + 1);
+	assert(not NeuralNetwork::isValidGenome(too_many_nodes.data()));
+	
+	///Snapshots of an evolving population
+	std::vector<FixedNeuralNetwork*> population;
+	for (int i=0; i<GENOMEARCHIVE_TEST_POPULATION; ++i) {
+		population.push_back(new FixedNeuralNetwork());
+	}
+	std::vector<std::vector<std::uint64_t>> hashes;
+	{
+		GenomeArchiveWriter writer(GENOMEARCHIVE_TEST_FILE, FixedNeuralNetwork::precisionName(), 42, GENOMEARCHIVE_TEST_POPULATION, 2);
+		for (int snapshot=0; snapshot<GENOMEARCHIVE_TEST_SNAPSHOTS; ++snapshot) {
+			writer.append(2 * snapshot, population.data(), GENOMEARCHIVE_TEST_POPULATION);
+			
+			hashes.emplace_back();
+			for (FixedNeuralNetwork* individual : population) {
+				hashes.back().push_back(individual->hash());
+				individual->mutate();
+			}
+		}
+	}
+	
+	///Random access through the index
+	{
+		GenomeArchiveReader reader(GENOMEARCHIVE_TEST_FILE);
+		assert(reader.isComplete());
+		assert(reader.getHeader().seed == 42 and reader.getHeader().population_size == GENOMEARCHIVE_TEST_POPULATION);
+		assert(reader.getSnapshotCount() == GENOMEARCHIVE_TEST_SNAPSHOTS);
+		assert(reader.findSnapshot(4) == 2);
+		assert(reader.findSnapshot(3) == -1);
+		
+		for (int snapshot=GENOMEARCHIVE_TEST_SNAPSHOTS-1; snapshot>=0; --snapshot) {
+			assert(reader.getGeneration(static_cast<std::size_t>(snapshot)) == static_cast<unsigned long>(2 * snapshot));
+			assert(reader.getIndividualCount(static_cast<std::size_t>(snapshot)) == GENOMEARCHIVE_TEST_POPULATION);
+			for (unsigned individual=0; individual<GENOMEARCHIVE_TEST_POPULATION; ++individual) {
+				FixedNeuralNetwork* loaded = reader.loadIndividual<FixedNeuralNetwork>(static_cast<std::size_t>(snapshot), individual);
+				assert(loaded->hash() == hashes[snapshot][individual]);
+				delete loaded;
+			}
+		}
+		
+		//the precision must match
+		bool rejected = false;
+		try {
+			delete reader.loadIndividual<NeuralNetwork>(0, 0);
+		}
+		catch (const std::runtime_error&) {
+			rejected = true;
+		}
+		assert(rejected);
+	}
+	
+	///Archives of interrupted runs keep their complete snapshots
+	{
+		std::ifstream input(GENOMEARCHIVE_TEST_FILE, std::ios::binary);
+		std::vector<char> contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+		std::ofstream output(GENOMEARCHIVE_TEST_TRUNCATED_FILE, std::ios::binary | std::ios::trunc);
+		output.write(contents.data(), static_cast<std::streamsize>(contents.size() - sizeof(ArchiveFooter) - 1));
+	}
+	{
+		GenomeArchiveReader reader(GENOMEARCHIVE_TEST_TRUNCATED_FILE);
+		assert(not reader.isComplete());
+		assert(reader.getSnapshotCount() == GENOMEARCHIVE_TEST_SNAPSHOTS);
+		FixedNeuralNetwork* loaded = reader.loadIndividual<FixedNeuralNetwork>(1, 3);
+		assert(loaded->hash() == hashes[1][3]);
+		delete loaded;
+	}
+	
+	///Corrupted indexes are rejected, corrupted footers fall back to the snapshots
+	{
+		std::ifstream input(GENOMEARCHIVE_TEST_FILE, std::ios::binary);
+		std::vector<char> contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+		ArchiveFooter footer;
+		std::memcpy(&footer, contents.data() + contents.size() - sizeof(footer), sizeof(footer));
+		
+		//a snapshot larger than the file
+		std::vector<char> oversized(contents);
+		SnapshotHeader first;
+		std::memcpy(&first, oversized.data() + sizeof(ArchiveHeader), sizeof(first));
+		first.size += contents.size();
+		std::memcpy(oversized.data() + sizeof(ArchiveHeader), &first, sizeof(first));
+		assert(rejectsArchive(oversized));
+		
+		//generations out of order
+		std::vector<char> unsorted(contents);
+		ArchiveIndexEntry entries[2];
+		std::memcpy(entries, unsorted.data() + footer.index_offset, sizeof(entries));
+		std::swap(entries[0], entries[1]);
+		std::memcpy(unsorted.data() + footer.index_offset, entries, sizeof(entries));
+		assert(rejectsArchive(unsorted));
+		
+		//an individual whose context node count does not match its nodes
+		std::vector<char> miscounted(contents);
+		std::uint64_t first_genome;
+		std::memcpy(&first_genome, miscounted.data() + sizeof(ArchiveHeader) + sizeof(SnapshotHeader), sizeof(first_genome));
+		miscounted[sizeof(ArchiveHeader) + first_genome + 2] = static_cast<char>(MAXNODES + 1);
+		writeArchive(miscounted);
+		{
+			GenomeArchiveReader reader(GENOMEARCHIVE_TEST_TRUNCATED_FILE);
+			bool rejected = false;
+			try {
+				delete reader.loadIndividual<FixedNeuralNetwork>(0, 0);
+			}
+			catch (const std::runtime_error&) {
+				rejected = true;
+			}
+			assert(rejected);
+		}
+		
+		//a snapshot count whose index would overflow
+		std::vector<char> overflowing(contents);
+		ArchiveFooter huge_footer = footer;
+		huge_footer.snapshot_count = ~0ULL / sizeof(ArchiveIndexEntry) + 2;
+		std::memcpy(overflowing.data() + overflowing.size() - sizeof(huge_footer), &huge_footer, sizeof(huge_footer));
+		writeArchive(overflowing);
+		GenomeArchiveReader reader(GENOMEARCHIVE_TEST_TRUNCATED_FILE);
+		assert(not reader.isComplete() and reader.getSnapshotCount() == GENOMEARCHIVE_TEST_SNAPSHOTS);
+	}
+	
+	for (FixedNeuralNetwork* individual : population) {
+		delete individual;
+	}
+	std::remove(GENOMEARCHIVE_TEST_FILE);
+	std::remove(GENOMEARCHIVE_TEST_TRUNCATED_FILE);
+	
+	std::cout << " done!" << std::endl;
+}
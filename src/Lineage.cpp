@@ -0,0 +1,171 @@
+#include "Lineage.hpp"
+#include "DenseNetwork.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+
+/*Records the initial population, which has no parents*/
+template<typename Network>
+void Lineage::addFounders(Network* const* networks, int population_size)
+{
+	assert(nodes.empty());
+
+	for (int i=0; i<population_size; ++i) {
+		LineageNode node;
+		node.id = next_id++;
+		node.parent = -1;
+		node.generation = generation;
+		node.population_index = i;
+		node.value_mutations = 0;
+		node.node_change = 0;
+		node.intelligence = networks[i]->getInnerNodeCount();
+		node.genome_hash = networks[i]->hash();
+		node.alive = true;
+
+		population.push_back(static_cast<long>(nodes.size()));
+		nodes.push_back(node);
+	}
+}
+
+/*Replaces the current population by its offspring, then prunes the tree*/
+template<typename Network>
+void Lineage::addGeneration(Network* const* networks, const int* parent_indexes,
+	const MutationRecord* mutations, int population_size)
+{
+	assert(static_cast<int>(population.size()) == population_size);
+	generation++;
+
+	std::vector<long> new_population;
+	new_population.reserve(population.size());
+
+	for (int i=0; i<population_size; ++i) {
+		LineageNode node;
+		node.id = next_id++;
+		node.parent = population[parent_indexes[i]];
+		node.generation = generation;
+		node.population_index = i;
+		node.value_mutations = mutations[i].value_mutations;
+		node.node_change = mutations[i].node_change;
+		node.intelligence = networks[i]->getInnerNodeCount();
+		node.genome_hash = networks[i]->hash();
+		node.alive = true;
+
+		new_population.push_back(static_cast<long>(nodes.size()));
+		nodes.push_back(node);
+	}
+
+	//the previous generation is no longer alive
+	for (long position : population) {
+		nodes[position].alive = false;
+	}
+	population.swap(new_population);
+
+	prune();
+}
+
+/*
+Removes extinct lineages and merges dead single-child ancestors into their child.
+Since parents are always stored before their children, a backward pass counts living descendants
+and a forward pass rebuilds the tree with updated parent positions.*/
+void Lineage::prune()
+{
+	std::size_t node_count = nodes.size();
+
+	//Backward pass: count the children of each node that are kept
+	std::vector<int> kept_children(node_count, 0);
+	std::vector<bool> kept(node_count, false);
+	for (std::size_t i=node_count; i-- > 0;) {
+		kept[i] = nodes[i].alive or kept_children[i] > 0;
+		if (kept[i] and nodes[i].parent >= 0) kept_children[nodes[i].parent]++;
+	}
+
+	//Forward pass: rebuild the tree without extinct or merged nodes
+	std::vector<long> new_position(node_count, -1); //position in the new tree (or of the merged node's parent)
+	std::vector<int> merged_mutations(node_count, 0); //mutations carried over by merged nodes
+	std::vector<LineageNode> new_nodes;
+
+	for (std::size_t i=0; i<node_count; ++i) {
+		if (not kept[i]) continue;
+
+		LineageNode node = nodes[i];
+		if (node.parent >= 0) {
+			node.value_mutations += merged_mutations[node.parent];
+			node.parent = new_position[node.parent];
+		}
+
+		//Merge dead non-founders with a single child and no structural mutation into the child
+		if (not node.alive and kept_children[i] == 1 and node.parent >= 0 and node.node_change == 0) {
+			new_position[i] = node.parent;
+			merged_mutations[i] = node.value_mutations;
+			continue;
+		}
+
+		new_position[i] = static_cast<long>(new_nodes.size());
+		new_nodes.push_back(node);
+	}
+
+	//Update the positions of the living population
+	for (long& position : population) {
+		position = new_position[position];
+		assert(position >= 0 and new_nodes[position].alive);
+	}
+	nodes.swap(new_nodes);
+}
+
+std::size_t Lineage::size() const
+{
+	return nodes.size();
+}
+
+const std::vector<LineageNode>& Lineage::getNodes() const
+{
+	return nodes;
+}
+
+/*Writes the tree as an octave matrix, one row per individual.
+Genome hashes are split in two 32-bit columns so that they are exactly representable.*/
+void Lineage::write(std::ostream& output) const
+{
+	output << "# LINEAGE columns are [id, parent id (-1 for founders), generation, population index, "
+		<< "value mutations, node change, intelligence, alive, hash (high 32 bits), hash (low 32 bits)]\n";
+	output << "# name: lineage\n";
+	output << "# type: matrix\n";
+	output << "# rows: " << nodes.size() << "\n";
+	output << "# columns: 10\n";
+
+	for (const LineageNode& node : nodes) {
+		long parent_id = (node.parent >= 0) ? static_cast<long>(nodes[node.parent].id) : -1;
+		output << node.id << " " << parent_id << " " << node.generation << " " << node.population_index << " "
+			<< node.value_mutations << " " << node.node_change << " " << node.intelligence << " "
+			<< (node.alive ? 1 : 0) << " " << (node.genome_hash >> 32) << " " << (node.genome_hash & 0xFFFFFFFFULL) << "\n";
+	}
+	output << "\n";
+}
+
+/*Writes the tree to a file, replacing any previous checkpoint*/
+void Lineage::writeFile(const std::string& file_name) const
+{
+	std::ofstream output(file_name.c_str(), std::ios::trunc);
+	if (not output)
+		throw std::runtime_error("Lineage: cannot open file " + file_name);
+
+	write(output);
+}
+
+
+/**---------- Available precisions ----------**/
+
+template void Lineage::addFounders<NeuralNetwork>(NeuralNetwork* const* networks, int population_size);
+template void Lineage::addFounders<FloatNeuralNetwork>(FloatNeuralNetwork* const* networks, int population_size);
+template void Lineage::addFounders<FixedNeuralNetwork>(FixedNeuralNetwork* const* networks, int population_size);
+template void Lineage::addFounders<DenseNetwork>(DenseNetwork* const* networks, int population_size);
+
+template void Lineage::addGeneration<NeuralNetwork>(NeuralNetwork* const* networks, const int* parent_indexes,
+	const MutationRecord* mutations, int population_size);
+template void Lineage::addGeneration<FloatNeuralNetwork>(FloatNeuralNetwork* const* networks, const int* parent_indexes,
+	const MutationRecord* mutations, int population_size);
+template void Lineage::addGeneration<FixedNeuralNetwork>(FixedNeuralNetwork* const* networks, const int* parent_indexes,
+	const MutationRecord* mutations, int population_size);
+template void Lineage::addGeneration<DenseNetwork>(DenseNetwork* const* networks, const int* parent_indexes,
+	const MutationRecord* mutations, int population_size);
@@ -0,0 +1,66 @@
+#include "LineageTest.hpp"
+
+
+void testLineage()
+{
+	std::cout << "Testing Lineage...";
+	
+	std::array<NeuralNetwork*, LINEAGE_TEST_POPULATION> population;
+	for (int i=0; i<LINEAGE_TEST_POPULATION; ++i) {
+		population[i] = new NeuralNetwork();
+	}
+	
+	Lineage lineage;
+	lineage.addFounders(population.data(), LINEAGE_TEST_POPULATION);
+	assert(lineage.size() == LINEAGE_TEST_POPULATION);
+	
+	///Random reproduction without mutations (neutral drift)
+	std::array<int, LINEAGE_TEST_POPULATION> parents;
+	std::array<MutationRecord, LINEAGE_TEST_POPULATION> mutations;
+	for (int generation=0; generation<LINEAGE_TEST_GENERATIONS; ++generation) {
+		for (int i=0; i<LINEAGE_TEST_POPULATION; ++i) {
+			parents[i] = RNG::getRandomInt(0, LINEAGE_TEST_POPULATION-1);
+		}
+		lineage.addGeneration(population.data(), parents.data(), mutations.data(), LINEAGE_TEST_POPULATION);
+		
+		//Each living individual has at least one ancestor per generation, pruning keeps at most
+		//the living individuals, their founders and one branching node per merge
+		assert(lineage.size() < 3 * LINEAGE_TEST_POPULATION);
+	}
+	
+	///Tree structure
+	int alive = 0;
+	const std::vector<LineageNode>& nodes = lineage.getNodes();
+	for (std::size_t i=0; i<nodes.size(); ++i) {
+		if (nodes[i].alive) {
+			alive++;
+			assert(nodes[i].generation == LINEAGE_TEST_GENERATIONS);
+		}
+		//Parents are stored before their children, and are older
+		if (nodes[i].parent >= 0) {
+			assert(nodes[i].parent < static_cast<long>(i));
+			assert(nodes[nodes[i].parent].generation < nodes[i].generation);
+		}
+		//Dead individuals were kept because of their descendants
+		else assert(nodes[i].generation == 0);
+	}
+	assert(alive == LINEAGE_TEST_POPULATION);
+	
+	///Structural mutations are never merged
+	std::array<int, LINEAGE_TEST_POPULATION> single_parent = {};
+	mutations[0].node_change = 1;
+	lineage.addGeneration(population.data(), single_parent.data(), mutations.data(), LINEAGE_TEST_POPULATION);
+	mutations[0].node_change = 0;
+	lineage.addGeneration(population.data(), single_parent.data(), mutations.data(), LINEAGE_TEST_POPULATION);
+	int structural = 0;
+	for (const LineageNode& node : lineage.getNodes()) {
+		if (node.node_change != 0) structural++;
+	}
+	assert(structural == 1);
+	
+	for (int i=0; i<LINEAGE_TEST_POPULATION; ++i) {
+		delete population[i];
+	}
+	
+	std::cout << " done!" << std::endl;
+}
@@ -0,0 +1,121 @@
+#include "MarkovGame.hpp"
+#include "DenseNetwork.hpp"
+
+
+/*Solves matrix * x = vector by gaussian elimination with partial pivoting (vector is replaced by x)*/
+void MarkovGame::solve(Matrix& matrix, Vector& vector)
+{
+	for (int col=0; col<OUTCOME_COUNT; ++col) {
+		//Find the row with the largest pivot and swap it into place
+		int pivot = col;
+		for (int row=col+1; row<OUTCOME_COUNT; ++row) {
+			if (std::fabs(matrix[row][col]) > std::fabs(matrix[pivot][col])) pivot = row;
+		}
+		std::swap(matrix[col], matrix[pivot]);
+		std::swap(vector[col], vector[pivot]);
+		assert(matrix[col][col] != 0); //I - pQ is strictly diagonally dominant for p < 1
+
+		//Eliminate the column from the following rows
+		for (int row=col+1; row<OUTCOME_COUNT; ++row) {
+			double factor = matrix[row][col] / matrix[col][col];
+			for (int k=col; k<OUTCOME_COUNT; ++k) {
+				matrix[row][k] -= factor * matrix[col][k];
+			}
+			vector[row] -= factor * vector[col];
+		}
+	}
+
+	//Back substitution
+	for (int row=OUTCOME_COUNT-1; row>=0; --row) {
+		for (int k=row+1; k<OUTCOME_COUNT; ++k) {
+			vector[row] -= matrix[row][k] * vector[k];
+		}
+		vector[row] /= matrix[row][row];
+	}
+}
+
+/*Probability that RNG::getIterationCount adds another iteration*/
+double MarkovGame::continuationProbability()
+{
+	return std::pow(ROUND_ITERATIONS_MEAN_PROB, ROUND_ITERATIONS_STOP_COUNT);
+}
+
+/*Returns the outcome index (see OUTCOME_* macros) of both player's choices*/
+int MarkovGame::outcomeIndex(bool a_cooperates, bool b_cooperates)
+{
+	if (a_cooperates) return b_cooperates ? OUTCOME_BOTH_COOPERATE : OUTCOME_SELF_COOPERATES;
+	else return b_cooperates ? OUTCOME_SELF_DEFECTS : OUTCOME_BOTH_DEFECT;
+}
+
+/*True if the network has no context nodes, so that its decisions only depend on its inputs*/
+template<typename Network>
+bool MarkovGame::isMarkovian(const Network& player)
+{
+	return player.getContextNodeCount() == 0;
+}
+
+/*Computes the expected results of a match between two markovian players.
+This matches the expectation of Simulation::playEachOther without drawing any random value.*/
+template<typename Network>
+MatchExpectation MarkovGame::expectedMatch(Network& player_a, Network& player_b, const Payoffs& payoffs)
+{
+	assert(isMarkovian(player_a) and isMarkovian(player_b));
+
+	double continuation = continuationProbability();
+
+	Vector payoffs_a, payoffs_b, cooperations; //per-outcome values
+	Matrix transitions; //transpose of (I - pQ)
+
+	for (int outcome=0; outcome<OUTCOME_COUNT; ++outcome) {
+		bool a_cooperates = (outcome == OUTCOME_BOTH_COOPERATE or outcome == OUTCOME_SELF_COOPERATES);
+		bool b_cooperates = (outcome == OUTCOME_BOTH_COOPERATE or outcome == OUTCOME_SELF_DEFECTS);
+
+		//Payoffs and cooperations for this outcome
+		payoff a_payoff, b_payoff;
+		payoffs.payoffsFromChoices(a_cooperates, b_cooperates, a_payoff, b_payoff);
+		payoffs_a[outcome] = a_payoff;
+		payoffs_b[outcome] = b_payoff;
+		cooperations[outcome] = (a_cooperates ? 1 : 0) + (b_cooperates ? 1 : 0);
+
+		//Probabilities of each player cooperating in the next iteration
+		double a_prob = static_cast<double>(player_a.getCooperationProbability(a_payoff, b_payoff));
+		double b_prob = static_cast<double>(player_b.getCooperationProbability(b_payoff, a_payoff));
+
+		//Transition probabilities from this outcome to every next outcome
+		for (int next=0; next<OUTCOME_COUNT; ++next) {
+			bool a_next = (next == OUTCOME_BOTH_COOPERATE or next == OUTCOME_SELF_COOPERATES);
+			bool b_next = (next == OUTCOME_BOTH_COOPERATE or next == OUTCOME_SELF_DEFECTS);
+			double probability = (a_next ? a_prob : 1 - a_prob) * (b_next ? b_prob : 1 - b_prob);
+			transitions[next][outcome] = (next == outcome ? 1 : 0) - continuation * probability;
+		}
+	}
+
+	//Expected number of visits of each outcome, starting from both players' default choices
+	Vector visits = {};
+	visits[outcomeIndex(player_a(), player_b())] = 1;
+	solve(transitions, visits);
+
+	MatchExpectation expectation;
+	for (int outcome=0; outcome<OUTCOME_COUNT; ++outcome) {
+		expectation.player_a_payoff_sum += visits[outcome] * payoffs_a[outcome];
+		expectation.player_b_payoff_sum += visits[outcome] * payoffs_b[outcome];
+		expectation.cooperations += visits[outcome] * cooperations[outcome];
+		expectation.round_iterations += visits[outcome];
+	}
+	expectation.defections = 2 * expectation.round_iterations - expectation.cooperations;
+
+	return expectation;
+}
+
+
+/**---------- Available precisions ----------**/
+
+template bool MarkovGame::isMarkovian<NeuralNetwork>(const NeuralNetwork& player);
+template bool MarkovGame::isMarkovian<FloatNeuralNetwork>(const FloatNeuralNetwork& player);
+template bool MarkovGame::isMarkovian<FixedNeuralNetwork>(const FixedNeuralNetwork& player);
+template bool MarkovGame::isMarkovian<DenseNetwork>(const DenseNetwork& player);
+
+template MatchExpectation MarkovGame::expectedMatch<NeuralNetwork>(NeuralNetwork& player_a, NeuralNetwork& player_b, const Payoffs& payoffs);
+template MatchExpectation MarkovGame::expectedMatch<FloatNeuralNetwork>(FloatNeuralNetwork& player_a, FloatNeuralNetwork& player_b, const Payoffs& payoffs);
+template MatchExpectation MarkovGame::expectedMatch<FixedNeuralNetwork>(FixedNeuralNetwork& player_a, FixedNeuralNetwork& player_b, const Payoffs& payoffs);
+template MatchExpectation MarkovGame::expectedMatch<DenseNetwork>(DenseNetwork& player_a, DenseNetwork& player_b, const Payoffs& payoffs);
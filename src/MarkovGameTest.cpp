@@ -0,0 +1,77 @@
+#include "MarkovGameTest.hpp"
+
+void testConstantPlayers(const Payoffs& payoffs);
+void testSampledMatches(const Payoffs& payoffs);
+
+void testMarkovGame()
+{
+	std::cout << "Testing MarkovGame...";
+	
+	Payoffs payoffs = Payoffs::getPayoffsForGameType("IPD");
+	testConstantPlayers(payoffs);
+	testSampledMatches(payoffs);
+	
+	std::cout << " done!" << std::endl;
+}
+
+/*Networks without nodes always play their default choice*/
+void testConstantPlayers(const Payoffs& payoffs)
+{
+	NeuralNetwork nn_a, nn_b;
+	for (int i=0; i<MAXNODES; ++i) {
+		nn_a.removeNode();
+		nn_b.removeNode();
+	}
+	assert(MarkovGame::isMarkovian(nn_a) and MarkovGame::isMarkovian(nn_b));
+	
+	MatchExpectation expectation = MarkovGame::expectedMatch(nn_a, nn_b, payoffs);
+	double iterations = 1 / (1 - MarkovGame::continuationProbability());
+	assert(std::fabs(expectation.round_iterations - iterations) < 1e-9);
+	
+	payoff a_payoff, b_payoff;
+	payoffs.payoffsFromChoices(nn_a(), nn_b(), a_payoff, b_payoff);
+	assert(std::fabs(expectation.player_a_payoff_sum - iterations * a_payoff) < 1e-9);
+	assert(std::fabs(expectation.player_b_payoff_sum - iterations * b_payoff) < 1e-9);
+	
+	double cooperations = iterations * ((nn_a() ? 1 : 0) + (nn_b() ? 1 : 0));
+	assert(std::fabs(expectation.cooperations - cooperations) < 1e-9);
+	assert(std::fabs(expectation.cooperations + expectation.defections - 2 * iterations) < 1e-9);
+}
+
+/*Expected results agree with the average of many sampled matches*/
+void testSampledMatches(const Payoffs& payoffs)
+{
+	for (int network=0; network<MARKOV_TEST_NETWORKS; ++network) {
+		//Random networks without context nodes
+		NeuralNetwork nn_a, nn_b;
+		while (nn_a.getContextNodeCount() > 0) nn_a.removeContextNode();
+		while (nn_b.getContextNodeCount() > 0) nn_b.removeContextNode();
+		
+		MatchExpectation expectation = MarkovGame::expectedMatch(nn_a, nn_b, payoffs);
+		
+		//Play matches the same way as Simulation::playEachOther
+		double iterations = 0, cooperations = 0, a_payoff_sum = 0;
+		for (int match=0; match<MARKOV_TEST_MATCHES; ++match) {
+			payoff a_payoff, b_payoff;
+			bool a_cooperates = nn_a(), b_cooperates = nn_b();
+			int round_iterations = RNG::getIterationCount();
+			for (int iteration=0; iteration<round_iterations; ++iteration) {
+				cooperations += (a_cooperates ? 1 : 0) + (b_cooperates ? 1 : 0);
+				payoffs.payoffsFromChoices(a_cooperates, b_cooperates, a_payoff, b_payoff);
+				a_payoff_sum += a_payoff;
+				a_cooperates = nn_a(a_payoff, b_payoff);
+				b_cooperates = nn_b(b_payoff, a_payoff);
+			}
+			iterations += round_iterations;
+		}
+		
+		//Compare per-iteration frequencies (match length noise cancels out)
+		double sampled_coop = cooperations / (2 * iterations);
+		double expected_coop = expectation.cooperations / (2 * expectation.round_iterations);
+		assert(std::fabs(sampled_coop - expected_coop) < MARKOV_TEST_FREQ_DIFF);
+		
+		double sampled_payoff = a_payoff_sum / iterations;
+		double expected_payoff = expectation.player_a_payoff_sum / expectation.round_iterations;
+		assert(std::fabs(sampled_payoff - expected_payoff) < MARKOV_TEST_PAYOFF_DIFF);
+	}
+}
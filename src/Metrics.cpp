@@ -0,0 +1,374 @@
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+
+/*Writes a matrix in the octave text format, with the same number formatting as the simulation's outputs*/
+template<typename Row>
+static void writeMatrix(std::ostream& output, const std::vector<Row>& matrix, const std::string& name, std::size_t columns)
+{
+	std::string text = "";
+	text += "# name: " + name + "\n";
+	text += "# type: matrix\n";
+	text += "# rows: " + std::to_string(matrix.size()) + "\n";
+	text += "# columns: " + std::to_string(columns) + "\n";
+
+	for (const Row& row : matrix) {
+		for (std::size_t col=0; col<columns; ++col) {
+			text += std::to_string(row[col]) + " ";
+		}
+		text += "\n";
+	}
+	text += "\n";
+	output << text;
+}
+
+
+/**---------- Cooperation ----------**/
+
+template<typename Network>
+void CooperationCollector<Network>::collect(const GenerationView<Network>& view)
+{
+	cooperation_frequency.push_back({{view.cooperation_frequency}});
+}
+
+template<typename Network>
+void CooperationCollector<Network>::write(std::ostream& output) const
+{
+	writeMatrix(output, cooperation_frequency, "cooperation_freq", 1);
+}
+
+
+/**---------- Mean intelligence and fitness ----------**/
+
+template<typename Network>
+MeanCollector<Network>::MeanCollector(bool fitness):
+	of_fitness(fitness)
+{
+}
+
+template<typename Network>
+void MeanCollector<Network>::collect(const GenerationView<Network>& view)
+{
+	double sum = 0;
+	for (int i=0; i<view.population_size; ++i) {
+		sum += of_fitness ? view.fitness[i] : view.intelligence[i];
+	}
+	means.push_back({{sum / view.population_size}});
+}
+
+template<typename Network>
+void MeanCollector<Network>::write(std::ostream& output) const
+{
+	writeMatrix(output, means, of_fitness ? "mean_fitness" : "mean_intelligence", 1);
+}
+
+
+/**---------- Intelligence and fitness of every individual ----------**/
+
+template<typename Network>
+IndividualCollector<Network>::IndividualCollector(bool fitness):
+	of_fitness(fitness)
+{
+}
+
+template<typename Network>
+void IndividualCollector<Network>::collect(const GenerationView<Network>& view)
+{
+	if (of_fitness) values.emplace_back(view.fitness, view.fitness + view.population_size);
+	else values.emplace_back(view.intelligence, view.intelligence + view.population_size);
+}
+
+/*Intelligence is written as integers, like the simulation's pop_intelligence*/
+template<typename Network>
+void IndividualCollector<Network>::write(std::ostream& output) const
+{
+	std::size_t columns = values.empty() ? 0 : values.front().size();
+	if (of_fitness) {
+		writeMatrix(output, values, "pop_fitness", columns);
+		return;
+	}
+
+	std::vector<std::vector<int>> intelligence;
+	intelligence.reserve(values.size());
+	for (const std::vector<double>& row : values) {
+		intelligence.emplace_back(row.begin(), row.end());
+	}
+	writeMatrix(output, intelligence, "pop_intelligence", columns);
+}
+
+
+/**---------- Intelligence histogram ----------**/
+
+template<typename Network>
+void HistogramCollector<Network>::collect(const GenerationView<Network>& view)
+{
+	histograms.emplace_back();
+	std::array<int, METRICS_HISTOGRAM_BINS>& histogram = histograms.back();
+	histogram.fill(0);
+
+	for (int i=0; i<view.population_size; ++i) {
+		histogram[static_cast<std::size_t>(std::min(view.intelligence[i], METRICS_HISTOGRAM_BINS - 1))] += 1;
+	}
+}
+
+template<typename Network>
+void HistogramCollector<Network>::write(std::ostream& output) const
+{
+	output << "# INTELLIGENCE_HISTOGRAM columns are the individuals with 0 to " << METRICS_HISTOGRAM_BINS - 1
+		<< " inner nodes (the last column includes larger networks)\n";
+	writeMatrix(output, histograms, "intelligence_histogram", METRICS_HISTOGRAM_BINS);
+}
+
+
+/**---------- Strategies ----------**/
+
+template<typename Network>
+StrategyCollector<Network>::StrategyCollector(const Strategies& strategies, unsigned classification_interval, int classified_sample):
+	strats(strategies),
+	interval(classification_interval),
+	sample_size(classified_sample)
+{
+	assert(interval > 0 and sample_size >= 0);
+}
+
+/*Classifies the sampled individuals from copies of their states, without modifying the population*/
+template<typename Network>
+void StrategyCollector<Network>::collect(const GenerationView<Network>& view)
+{
+	if (view.generation % interval != 0) return;
+
+	counts.emplace_back();
+	std::array<int, STRATEGIES_MAX + 1>& current_counts = counts.back();
+	current_counts.fill(0);
+	current_counts[0] = static_cast<int>(view.generation);
+
+	int classified = (sample_size > 0) ? std::min(sample_size, view.population_size) : view.population_size;
+	for (int sample=0; sample<classified; ++sample) {
+		const Network& player = *view.population[sample * view.population_size / classified];
+		typename Network::State state = player.createState();
+		current_counts[static_cast<std::size_t>(1 + strats.closestPureStrategy(player, state))] += 1;
+	}
+}
+
+template<typename Network>
+void StrategyCollector<Network>::write(std::ostream& output) const
+{
+	output << "# STRATEGIES columns are [generation";
+	for (int strat_index=0; strat_index<strats.getStrategyCount(); ++strat_index) {
+		output << ", " << strats.getStrategyName(strat_index);
+	}
+	output << "]";
+	if (sample_size > 0) output << " (sample of " << sample_size << " individuals)";
+	output << "\n";
+	writeMatrix(output, counts, (sample_size > 0) ? "strategies_sample" : "strategies", static_cast<std::size_t>(1 + strats.getStrategyCount()));
+}
+
+
+/**---------- Diversity ----------**/
+
+/*Rounds a number of floats up to whole lanes*/
+static std::size_t laneStride(std::size_t floats)
+{
+	return std::max<std::size_t>((floats + DIVERSITY_LANES - 1) / DIVERSITY_LANES, 1) * DIVERSITY_LANES;
+}
+
+/*Squared Euclidean distance between two rows of stride floats (a multiple of DIVERSITY_LANES)*/
+static float squaredDistance(const float* first, const float* second, std::size_t stride)
+{
+	float lanes[DIVERSITY_LANES] = {};
+	for (std::size_t block=0; block<stride; block+=DIVERSITY_LANES) {
+		for (std::size_t lane=0; lane<DIVERSITY_LANES; ++lane) {
+			float difference = first[block + lane] - second[block + lane];
+			lanes[lane] += difference * difference;
+		}
+	}
+	
+	float sum = 0;
+	for (float lane : lanes) sum += lane;
+	return sum;
+}
+
+/*Manhattan distance between two rows of stride floats (a multiple of DIVERSITY_LANES)*/
+static float absoluteDistance(const float* first, const float* second, std::size_t stride)
+{
+	float lanes[DIVERSITY_LANES] = {};
+	for (std::size_t block=0; block<stride; block+=DIVERSITY_LANES) {
+		for (std::size_t lane=0; lane<DIVERSITY_LANES; ++lane) {
+			lanes[lane] += std::fabs(first[block + lane] - second[block + lane]);
+		}
+	}
+	
+	float sum = 0;
+	for (float lane : lanes) sum += lane;
+	return sum;
+}
+
+/*Flattens the population with as many node slots as its largest network, then compares every pair*/
+template<typename Network>
+Diversity measureDiversity(const Network* const* population, int population_size)
+{
+	Diversity diversity;
+	if (population_size == 0) return diversity;
+	
+	int node_slots = 0;
+	std::vector<std::uint64_t> hashes;
+	hashes.reserve(static_cast<std::size_t>(population_size));
+	for (int i=0; i<population_size; ++i) {
+		node_slots = std::max(node_slots, population[i]->getCognitiveNodeCount());
+		hashes.push_back(population[i]->hash());
+	}
+	std::sort(hashes.begin(), hashes.end());
+	diversity.distinct_genotypes = static_cast<int>(std::unique(hashes.begin(), hashes.end()) - hashes.begin());
+	
+	std::size_t value_stride = laneStride(static_cast<std::size_t>(FLAT_NETWORK_VALUES + node_slots*FLAT_NODE_VALUES));
+	std::size_t structure_stride = laneStride(static_cast<std::size_t>(node_slots*FLAT_NODE_STRUCTURE));
+	std::vector<float> values(static_cast<std::size_t>(population_size) * value_stride, 0.0f);
+	std::vector<float> structures(static_cast<std::size_t>(population_size) * structure_stride, 0.0f);
+	for (int i=0; i<population_size; ++i) {
+		population[i]->writeFlatParameters(&values[static_cast<std::size_t>(i) * value_stride], 
+			&structures[static_cast<std::size_t>(i) * structure_stride], node_slots);
+	}
+	
+	double parameter_sum = 0, structural_sum = 0;
+	for (std::size_t a=0; a<static_cast<std::size_t>(population_size); ++a) {
+		for (std::size_t b=a+1; b<static_cast<std::size_t>(population_size); ++b) {
+			parameter_sum += std::sqrt(squaredDistance(&values[a * value_stride], &values[b * value_stride], value_stride));
+			structural_sum += absoluteDistance(&structures[a * structure_stride], &structures[b * structure_stride], structure_stride);
+		}
+	}
+	
+	double pairs = population_size * (population_size - 1) / 2.0;
+	if (pairs > 0) {
+		diversity.parameter_distance = parameter_sum / pairs;
+		diversity.structural_distance = structural_sum / pairs;
+	}
+	return diversity;
+}
+
+template<typename Network>
+void DiversityCollector<Network>::collect(const GenerationView<Network>& view)
+{
+	Diversity generation = measureDiversity(view.population, view.population_size);
+	diversity.push_back({{static_cast<double>(generation.distinct_genotypes), generation.parameter_distance, 
+		generation.structural_distance}});
+}
+
+template<typename Network>
+void DiversityCollector<Network>::write(std::ostream& output) const
+{
+	output << "# DIVERSITY columns are [distinct genotypes, mean parameter distance, mean structural distance]\n";
+	writeMatrix(output, diversity, "diversity", 3);
+}
+
+
+/**---------- Factory ----------**/
+
+/*Parses an optional positive parameter, returns default_value if there is none*/
+static unsigned parseParameter(const std::string& name, const std::string& parameter, unsigned default_value)
+{
+	if (parameter.empty()) return default_value;
+
+	std::istringstream stream(parameter);
+	long value = 0;
+	if (not (stream >> value) or not stream.eof() or value <= 0)
+		throw std::runtime_error("Metrics: invalid parameter " + parameter + " of " + name);
+	return static_cast<unsigned>(value);
+}
+
+template<typename Network>
+std::vector<std::unique_ptr<MetricCollector<Network>>> createCollectors(const std::string& list, const Strategies& strats)
+{
+	std::vector<std::unique_ptr<MetricCollector<Network>>> collectors;
+
+	std::istringstream stream(list);
+	std::string item;
+	while (std::getline(stream, item, METRICS_SEPARATOR)) {
+		std::size_t separator = item.find(METRICS_PARAMETER_SEPARATOR);
+		std::string name = item.substr(0, separator);
+		std::string parameter = (separator == std::string::npos) ? "" : item.substr(separator + 1);
+		if (separator != std::string::npos and parameter.empty())
+			throw std::runtime_error("Metrics: missing parameter of " + name);
+
+		MetricCollector<Network>* collector;
+		if (name == "cooperation" and parameter.empty())
+			collector = new CooperationCollector<Network>();
+		else if ((name == "mean_intelligence" or name == "mean_fitness") and parameter.empty())
+			collector = new MeanCollector<Network>(name == "mean_fitness");
+		else if ((name == "intelligence" or name == "fitness") and parameter.empty())
+			collector = new IndividualCollector<Network>(name == "fitness");
+		else if (name == "intelligence_histogram" and parameter.empty())
+			collector = new HistogramCollector<Network>();
+		else if (name == "diversity" and parameter.empty())
+			collector = new DiversityCollector<Network>();
+		else if (name == "strategies")
+			collector = new StrategyCollector<Network>(strats, parseParameter(name, parameter, 1));
+		else if (name == "strategies_sample" and not parameter.empty())
+			collector = new StrategyCollector<Network>(strats, 1, static_cast<int>(parseParameter(name, parameter, 0)));
+		else
+			throw std::runtime_error("Metrics: unknown metric " + item + " (available: " + metricNames() + ")");
+
+		collectors.emplace_back(collector);
+	}
+
+	if (collectors.empty())
+		throw std::runtime_error("Metrics: no metric in " + list);
+	return collectors;
+}
+
+std::string metricNames()
+{
+	return "cooperation, mean_intelligence, mean_fitness, intelligence, fitness, intelligence_histogram, "
+		"diversity, strategies[:interval], strategies_sample:size";
+}
+
+
+/**---------- Available precisions ----------**/
+
+template class CooperationCollector<NeuralNetwork>;
+template class CooperationCollector<FloatNeuralNetwork>;
+template class CooperationCollector<FixedNeuralNetwork>;
+template class CooperationCollector<DenseNetwork>;
+
+template class MeanCollector<NeuralNetwork>;
+template class MeanCollector<FloatNeuralNetwork>;
+template class MeanCollector<FixedNeuralNetwork>;
+template class MeanCollector<DenseNetwork>;
+
+template class IndividualCollector<NeuralNetwork>;
+template class IndividualCollector<FloatNeuralNetwork>;
+template class IndividualCollector<FixedNeuralNetwork>;
+template class IndividualCollector<DenseNetwork>;
+
+template class HistogramCollector<NeuralNetwork>;
+template class HistogramCollector<FloatNeuralNetwork>;
+template class HistogramCollector<FixedNeuralNetwork>;
+template class HistogramCollector<DenseNetwork>;
+
+template class DiversityCollector<NeuralNetwork>;
+template class DiversityCollector<FloatNeuralNetwork>;
+template class DiversityCollector<FixedNeuralNetwork>;
+template class DiversityCollector<DenseNetwork>;
+
+template Diversity measureDiversity<NeuralNetwork>(const NeuralNetwork* const* population, int population_size);
+template Diversity measureDiversity<FloatNeuralNetwork>(const FloatNeuralNetwork* const* population, int population_size);
+template Diversity measureDiversity<FixedNeuralNetwork>(const FixedNeuralNetwork* const* population, int population_size);
+template Diversity measureDiversity<DenseNetwork>(const DenseNetwork* const* population, int population_size);
+
+template class StrategyCollector<NeuralNetwork>;
+template class StrategyCollector<FloatNeuralNetwork>;
+template class StrategyCollector<FixedNeuralNetwork>;
+template class StrategyCollector<DenseNetwork>;
+
+template std::vector<std::unique_ptr<MetricCollector<NeuralNetwork>>> createCollectors<NeuralNetwork>(
+	const std::string& list, const Strategies& strats);
+template std::vector<std::unique_ptr<MetricCollector<FloatNeuralNetwork>>> createCollectors<FloatNeuralNetwork>(
+	const std::string& list, const Strategies& strats);
+template std::vector<std::unique_ptr<MetricCollector<FixedNeuralNetwork>>> createCollectors<FixedNeuralNetwork>(
+	const std::string& list, const Strategies& strats);
+template std::vector<std::unique_ptr<MetricCollector<DenseNetwork>>> createCollectors<DenseNetwork>(
+	const std::string& list, const Strategies& strats);
@@ -0,0 +1,201 @@
+#include "MetricsTest.hpp"
+
+
+/*Records the views it is given (a collector defined outside of the library)*/
+class ViewRecorder: public MetricCollector<NeuralNetwork>
+{
+	public:
+		std::vector<unsigned long> generations;
+		bool classified = false; //a view had the simulation's strategy counts
+
+		void collect(const GenerationView<NeuralNetwork>& view) override
+		{
+			generations.push_back(view.generation);
+			if (view.strategies != nullptr) classified = true;
+		}
+
+		void write(std::ostream& output) const override
+		{
+			output << "# views: " << generations.size() << "\n";
+		}
+};
+
+/*Mean distances of every pair computed one value at a time, for comparison with measureDiversity*/
+template<typename Network>
+static void naiveDistances(const std::vector<Network*>& population, double& parameter_distance, double& structural_distance)
+{
+	int node_slots = 0;
+	for (const Network* individual : population) {
+		node_slots = std::max(node_slots, individual->getCognitiveNodeCount());
+	}
+	
+	std::size_t value_count = static_cast<std::size_t>(FLAT_NETWORK_VALUES + node_slots*FLAT_NODE_VALUES);
+	std::size_t structure_count = static_cast<std::size_t>(node_slots*FLAT_NODE_STRUCTURE);
+	std::vector<std::vector<float>> values, structures;
+	for (const Network* individual : population) {
+		values.emplace_back(value_count);
+		structures.emplace_back(structure_count + 1); //never empty
+		individual->writeFlatParameters(values.back().data(), structures.back().data(), node_slots);
+	}
+	
+	parameter_distance = structural_distance = 0;
+	double pairs = 0;
+	for (std::size_t a=0; a<population.size(); ++a) {
+		for (std::size_t b=a+1; b<population.size(); ++b) {
+			double squared = 0;
+			for (std::size_t k=0; k<value_count; ++k) {
+				squared += (values[a][k] - values[b][k]) * (values[a][k] - values[b][k]);
+			}
+			parameter_distance += std::sqrt(squared);
+			for (std::size_t k=0; k<structure_count; ++k) {
+				structural_distance += std::fabs(structures[a][k] - structures[b][k]);
+			}
+			pairs += 1;
+		}
+	}
+	parameter_distance /= pairs;
+	structural_distance /= pairs;
+}
+
+/*Checks measureDiversity against the naive distances on a random population of a network type*/
+template<typename Network>
+static void checkDiversity()
+{
+	std::vector<Network*> population;
+	for (int i=0; i<METRICS_TEST_DIVERSITY_SIZE; ++i) {
+		population.push_back(new Network());
+	}
+	population.push_back(new Network(*population[0])); //a duplicate genotype
+	
+	Diversity diversity = measureDiversity(population.data(), static_cast<int>(population.size()));
+	double parameter_distance, structural_distance;
+	naiveDistances(population, parameter_distance, structural_distance);
+	
+	assert(diversity.distinct_genotypes == METRICS_TEST_DIVERSITY_SIZE);
+	assert(std::fabs(diversity.parameter_distance - parameter_distance) < 1e-4 * (1 + parameter_distance));
+	assert(std::fabs(diversity.structural_distance - structural_distance) < 1e-9);
+	
+	for (Network* individual : population) {
+		delete individual;
+	}
+}
+
+/*Returns true if creating the collectors of the list throws*/
+static bool rejects(const std::string& list, const Strategies& strats)
+{
+	try {
+		createCollectors<NeuralNetwork>(list, strats);
+	}
+	catch (const std::runtime_error&) {
+		return true;
+	}
+	return false;
+}
+
+void testMetrics()
+{
+	std::cout << "Testing Metrics...";
+
+	const Payoffs payoffs = Payoffs::getPayoffsForGameType("IPD");
+
+	///Collector lists
+	Strategies strats(payoffs);
+	assert(createCollectors<NeuralNetwork>("cooperation,mean_intelligence", strats).size() == 2);
+	assert(createCollectors<NeuralNetwork>("strategies:5,strategies_sample:10,intelligence_histogram", strats).size() == 3);
+	assert(createCollectors<NeuralNetwork>("diversity", strats).size() == 1);
+	assert(rejects("unknown", strats));
+	assert(rejects("cooperation:2", strats));
+	assert(rejects("strategies:0", strats));
+	assert(rejects("strategies_sample", strats));
+	assert(rejects("", strats));
+
+	///Histogram of a handmade generation (larger networks are counted in the last bin)
+	int intelligence[] = {0, 1, 1, METRICS_HISTOGRAM_BINS + 5};
+	GenerationView<NeuralNetwork> view = {};
+	view.population_size = 4;
+	view.intelligence = intelligence;
+	HistogramCollector<NeuralNetwork> histogram;
+	histogram.collect(view);
+	std::ostringstream histogram_output;
+	histogram.write(histogram_output);
+	std::string expected_row = "1 2 ";
+	for (int bin=2; bin<METRICS_HISTOGRAM_BINS-1; ++bin) {
+		expected_row += "0 ";
+	}
+	expected_row += "1 \n";
+	assert(histogram_output.str().find("\n" + expected_row) != std::string::npos);
+
+	///Diversity: a population of clones has a single genotype and no distance
+	NeuralNetwork clone;
+	for (int i=0; i<3; ++i) clone.addNode();
+	std::vector<const NeuralNetwork*> clones(METRICS_TEST_DIVERSITY_SIZE, &clone);
+	Diversity clone_diversity = measureDiversity(clones.data(), METRICS_TEST_DIVERSITY_SIZE);
+	assert(clone_diversity.distinct_genotypes == 1);
+	assert(clone_diversity.parameter_distance == 0 and clone_diversity.structural_distance == 0);
+	
+	//a network and a copy with one more node differ by the node's slot (and its context node, if any)
+	NeuralNetwork larger(clone);
+	larger.addCognitiveNode();
+	const NeuralNetwork* pair[] = {&clone, &larger};
+	Diversity pair_diversity = measureDiversity(pair, 2);
+	assert(pair_diversity.distinct_genotypes == 2);
+	assert(pair_diversity.structural_distance == 1 + larger.getContextNodeCount() - clone.getContextNodeCount());
+	assert(pair_diversity.parameter_distance > 0);
+	
+	//vectorized distances match the naive ones, for each network type
+	checkDiversity<NeuralNetwork>();
+	checkDiversity<FixedNeuralNetwork>();
+	DenseNetwork::setInitialNodeCount(METRICS_TEST_DENSE_NODES);
+	checkDiversity<DenseNetwork>();
+	DenseNetwork::setInitialNodeCount(-1);
+	
+	///Reference run with the classic outputs
+	RNG::setSeed(METRICS_TEST_SEED);
+	Simulation reference(payoffs);
+	reference.run(METRICS_TEST_GENERATIONS);
+
+	///Collectors classify like the simulation, which then does not classify at all
+	RNG::setSeed(METRICS_TEST_SEED);
+	Simulation collected(payoffs);
+	StrategyCollector<NeuralNetwork>* strategies = new StrategyCollector<NeuralNetwork>(collected.getStrategies(), 1);
+	ViewRecorder* recorder = new ViewRecorder();
+	collected.addCollector(std::unique_ptr<MetricCollector<NeuralNetwork>>(strategies));
+	collected.addCollector(std::unique_ptr<MetricCollector<NeuralNetwork>>(recorder));
+	collected.run(METRICS_TEST_GENERATIONS);
+
+	assert(recorder->generations.size() == METRICS_TEST_GENERATIONS);
+	assert(not recorder->classified);
+	assert(collected.getPopulationFitness() == reference.getPopulationFitness());
+
+	std::ostringstream strategies_output;
+	strategies->write(strategies_output);
+	for (unsigned generation=0; generation<METRICS_TEST_GENERATIONS; ++generation) {
+		assert(collected.getStrategiesCount()[generation] == StrategyCounts());
+
+		std::string row = std::to_string(generation) + " ";
+		for (int strat_index=0; strat_index<reference.getStrategies().getStrategyCount(); ++strat_index) {
+			row += std::to_string(reference.getStrategiesCount()[generation][strat_index]) + " ";
+		}
+		assert(strategies_output.str().find("\n" + row + "\n") != std::string::npos);
+	}
+
+	///Collectors cannot be added once started
+	bool rejected = false;
+	try {
+		collected.addCollector(std::unique_ptr<MetricCollector<NeuralNetwork>>(new ViewRecorder()));
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	assert(rejected);
+
+	///Classifying every few generations changes the random draws, but not the number of generations
+	RNG::setSeed(METRICS_TEST_SEED);
+	SimulationSettings settings;
+	settings.metrics = "cooperation,strategies:" + std::to_string(METRICS_TEST_INTERVAL);
+	Simulation sparse(payoffs, settings);
+	sparse.run(METRICS_TEST_GENERATIONS);
+	assert(sparse.getGeneration() == METRICS_TEST_GENERATIONS);
+
+	std::cout << " done!" << std::endl;
+}
@@ -0,0 +1,121 @@
+#include "Monitor.hpp"
+
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Monitor: the seqlock needs lock-free 64-bit atomics");
+
+
+/*POSIX shared memory objects names start with a slash*/
+std::string Monitor::segmentName(const std::string& name)
+{
+	return "/coop-" + name;
+}
+
+/*Creates the named shared memory segment, which must not exist yet (another run would share it)*/
+Monitor::Monitor(const std::string& name):
+	segment_name(segmentName(name)),
+	start_time(std::chrono::steady_clock::now())
+{
+	int descriptor = shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (descriptor < 0 and errno == EEXIST)
+		throw std::runtime_error("Monitor: shared memory " + segment_name + " already exists (used by another run, "
+			"or left by a run that did not finish, see /dev/shm)");
+	if (descriptor < 0)
+		throw std::runtime_error("Monitor: cannot create shared memory " + segment_name);
+	
+	//the segment was created by this run: remove it on failure, or the next run would find it
+	if (ftruncate(descriptor, sizeof(MonitorSegment)) != 0) {
+		close(descriptor);
+		shm_unlink(segment_name.c_str());
+		throw std::runtime_error("Monitor: cannot resize shared memory " + segment_name);
+	}
+	
+	void* address = mmap(nullptr, sizeof(MonitorSegment), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	close(descriptor); //the mapping stays valid
+	if (address == MAP_FAILED) {
+		shm_unlink(segment_name.c_str());
+		throw std::runtime_error("Monitor: cannot map shared memory " + segment_name);
+	}
+	
+	//initialize an empty snapshot, the magic number is written last
+	segment = static_cast<MonitorSegment*>(address);
+	segment->sequence.store(0, std::memory_order_relaxed);
+	std::memset(&segment->stats, 0, sizeof(MonitorStats));
+	segment->stats.strategies_generation = -1;
+	segment->version = MONITOR_VERSION;
+	std::atomic_thread_fence(std::memory_order_release);
+	segment->magic = MONITOR_MAGIC;
+}
+
+Monitor::~Monitor()
+{
+	munmap(segment, sizeof(MonitorSegment));
+	shm_unlink(segment_name.c_str());
+}
+
+/*Writes new stats under the seqlock (a single writer never waits)*/
+void Monitor::publish(MonitorStats stats)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+	stats.generations_per_second = (elapsed.count() > 0) ? static_cast<double>(stats.generation) / elapsed.count() : 0;
+	
+	std::uint64_t sequence = segment->sequence.load(std::memory_order_relaxed);
+	segment->sequence.store(sequence + 1, std::memory_order_relaxed); //odd: write in progress
+	std::atomic_thread_fence(std::memory_order_release);
+	
+	std::memcpy(&segment->stats, &stats, sizeof(MonitorStats));
+	
+	segment->sequence.store(sequence + 2, std::memory_order_release); //even: consistent
+}
+
+/*Maps the named segment for reading*/
+MonitorReader::MonitorReader(const std::string& name)
+{
+	std::string segment_name = Monitor::segmentName(name);
+	int descriptor = shm_open(segment_name.c_str(), O_RDONLY, 0);
+	if (descriptor < 0) return;
+	
+	void* address = mmap(nullptr, sizeof(MonitorSegment), PROT_READ, MAP_SHARED, descriptor, 0);
+	close(descriptor); //the mapping stays valid
+	if (address == MAP_FAILED) return;
+	
+	segment = static_cast<const MonitorSegment*>(address);
+	if (segment->magic != MONITOR_MAGIC or segment->version != MONITOR_VERSION) {
+		munmap(const_cast<MonitorSegment*>(segment), sizeof(MonitorSegment));
+		segment = nullptr;
+	}
+}
+
+MonitorReader::~MonitorReader()
+{
+	if (segment) munmap(const_cast<MonitorSegment*>(segment), sizeof(MonitorSegment));
+}
+
+bool MonitorReader::isOpen() const
+{
+	return segment != nullptr;
+}
+
+/*Copies the stats until two identical even sequence numbers surround the copy*/
+bool MonitorReader::read(MonitorStats& stats) const
+{
+	if (not segment) return false;
+	
+	for (int attempt=0; attempt<MONITOR_READ_ATTEMPTS; ++attempt) {
+		std::uint64_t before = segment->sequence.load(std::memory_order_acquire);
+		if (before % 2 == 1) continue; //write in progress
+		
+		std::memcpy(&stats, &segment->stats, sizeof(MonitorStats));
+		
+		std::atomic_thread_fence(std::memory_order_acquire);
+		std::uint64_t after = segment->sequence.load(std::memory_order_relaxed);
+		if (before == after) return true;
+	}
+	
+	return false;
+}
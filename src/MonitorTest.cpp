@@ -0,0 +1,65 @@
+#include "MonitorTest.hpp"
+
+
+void testMonitor()
+{
+	std::cout << "Testing Monitor...";
+	
+	std::string name = "test-" + std::to_string(getpid());
+	MonitorStats stats = {};
+	
+	{
+		Monitor monitor(name);
+		MonitorReader reader(name);
+		assert(reader.isOpen());
+		
+		///Initial empty snapshot
+		assert(reader.read(stats));
+		assert(stats.generation == 0 and stats.strategies_generation == -1);
+		
+		///A second run cannot take over the segment
+		bool rejected = false;
+		try {
+			Monitor duplicate(name);
+		}
+		catch (const std::runtime_error&) {
+			rejected = true;
+		}
+		assert(rejected and reader.read(stats));
+		
+		///Readers never observe partial updates
+		std::atomic<bool> writing(true);
+		std::thread writer([&]{
+			for (std::uint64_t update=1; update<=MONITOR_TEST_UPDATES; ++update) {
+				MonitorStats written = {};
+				written.generation = update;
+				written.mean_fitness = static_cast<double>(update);
+				written.strategies_generation = static_cast<std::int64_t>(update);
+				written.strategies[MONITOR_MAX_STRATEGIES-1] = static_cast<std::int32_t>(update);
+				monitor.publish(written);
+			}
+			writing = false;
+		});
+		
+		std::uint64_t previous = 0;
+		while (writing) {
+			if (reader.read(stats) and stats.generation > 0) {
+				assert(stats.mean_fitness == static_cast<double>(stats.generation));
+				assert(stats.strategies_generation == static_cast<std::int64_t>(stats.generation));
+				assert(stats.strategies[MONITOR_MAX_STRATEGIES-1] == static_cast<std::int32_t>(stats.generation));
+				assert(stats.generation >= previous);
+				previous = stats.generation;
+			}
+		}
+		writer.join();
+		
+		assert(reader.read(stats));
+		assert(stats.generation == MONITOR_TEST_UPDATES);
+	}
+	
+	///The segment is removed with the monitor
+	MonitorReader removed_reader(name);
+	assert(not removed_reader.isOpen() and not removed_reader.read(stats));
+	
+	std::cout << " done!" << std::endl;
+}
@@ -0,0 +1,135 @@
+#include "Mutation.hpp"
+#include "DenseNetwork.hpp"
+
+#include <sstream>
+#include <cstdlib>
+
+
+/**---------- MutationRates ----------**/
+
+MutationRates::MutationRates()
+{
+	rates.fill(NETWORK_VALUE_MUTATION_PROB);
+	rates[PARAMETER_STRUCTURE] = NETWORK_STRUCTURE_MUTATION_PROB;
+}
+
+bool MutationRates::set(const std::string& class_name, double rate)
+{
+	if (rate < 0 or rate > 1) return false;
+	
+	if (class_name == "values") {
+		for (int parameter_class=0; parameter_class<PARAMETER_CLASS_COUNT; ++parameter_class) {
+			if (parameter_class != PARAMETER_STRUCTURE) rates[parameter_class] = rate;
+		}
+		return true;
+	}
+	for (int parameter_class=0; parameter_class<PARAMETER_CLASS_COUNT; ++parameter_class) {
+		if (class_name == className(parameter_class)) {
+			rates[parameter_class] = rate;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*For instance "values:0.05,structure:0.01"*/
+bool MutationRates::parse(const std::string& rate_list)
+{
+	std::istringstream list(rate_list);
+	std::string item;
+	while (std::getline(list, item, ',')) {
+		std::size_t separator = item.find(':');
+		if (separator == std::string::npos) return false;
+		
+		const char* rate_str = item.c_str() + separator + 1;
+		char* end;
+		double rate = std::strtod(rate_str, &end);
+		if (end == rate_str or *end != '\0') return false;
+		
+		if (not set(item.substr(0, separator), rate)) return false;
+	}
+	return true;
+}
+
+const char* MutationRates::className(int parameter_class)
+{
+	switch (parameter_class) {
+		case PARAMETER_DEFAULT_CHOICE: return "default";
+		case PARAMETER_SELF_PAYOFF_WEIGHT: return "self";
+		case PARAMETER_OTHER_PAYOFF_WEIGHT: return "other";
+		case PARAMETER_OUTPUT_WEIGHT: return "output";
+		case PARAMETER_CONTEXT_WEIGHT: return "context";
+		case PARAMETER_NODE_THRESHOLD: return "threshold";
+		case PARAMETER_OUTPUT_THRESHOLD: return "output-threshold";
+		case PARAMETER_STRUCTURE: return "structure";
+		default: return "unknown";
+	}
+}
+
+
+/**---------- MutationEngine ----------**/
+
+template<typename Network>
+MutationEngine<Network>::MutationEngine(const MutationRates& rates):
+	mutation_rates(rates)
+	{}
+
+template<typename Network>
+void MutationEngine<Network>::mutatePopulation(Network* const* population, int population_size, MutationRecord* records)
+{
+	for (int i=0; i<population_size; ++i) {
+		records[i] = MutationRecord();
+	}
+	
+	//value classes do not change parameter counts, so the structure is mutated last
+	for (int parameter_class=0; parameter_class<PARAMETER_CLASS_COUNT; ++parameter_class) {
+		if (parameter_class != PARAMETER_STRUCTURE)
+			mutateClass(parameter_class, population, population_size, records);
+	}
+	mutateClass(PARAMETER_STRUCTURE, population, population_size, records);
+}
+
+/*Jumps from one mutated parameter to the next across the networks' flattened parameters*/
+template<typename Network>
+void MutationEngine<Network>::mutateClass(int parameter_class, Network* const* population, int population_size, 
+	MutationRecord* records)
+{
+	double rate = mutation_rates.rates[parameter_class];
+	if (rate <= 0) return;
+	
+	int network = 0; //network containing the current position
+	long network_start = 0; //flattened position of the network's first parameter
+	long network_end = population_size > 0 ? population[0]->getParameterCount(parameter_class) : 0;
+	long position = -1; //flattened position of the last mutated parameter
+	
+	for (;;) {
+		long skip = RNG::getGeometricSkip(rate);
+		if (skip >= std::numeric_limits<long>::max() - position - 1) return; //beyond any population
+		position += skip + 1;
+		
+		//advance to the network containing the position
+		while (position >= network_end) {
+			if (++network == population_size) return;
+			network_start = network_end;
+			network_end += population[network]->getParameterCount(parameter_class);
+		}
+		
+		int node_change = population[network]->mutateParameter(parameter_class, static_cast<int>(position - network_start));
+		if (parameter_class == PARAMETER_STRUCTURE) records[network].node_change = node_change;
+		else records[network].value_mutations++;
+	}
+}
+
+template<typename Network>
+const MutationRates& MutationEngine<Network>::getRates() const
+{
+	return mutation_rates;
+}
+
+
+/**---------- Available precisions ----------**/
+
+template class MutationEngine<NeuralNetwork>;
+template class MutationEngine<FloatNeuralNetwork>;
+template class MutationEngine<FixedNeuralNetwork>;
+template class MutationEngine<DenseNetwork>;
@@ -0,0 +1,205 @@
+#include "MutationScan.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Statistics.hpp"
+
+
+template<typename Network>
+MutationScan<Network>::MutationScan(const Payoffs& payoffs, unsigned threads, const MutationRates& rates):
+	game_payoffs(payoffs),
+	thread_count(threads),
+	mutation_engine(rates)
+{
+}
+
+/*A node can be added unless the network is full (the limits depend on the network type)*/
+template<typename Network>
+bool MutationScan<Network>::applies(const Network& focal, int type)
+{
+	if (type == SCAN_TYPE_ADD_NODE) {
+		Network larger(focal);
+		larger.addNode();
+		return larger.getInnerNodeCount() > focal.getInnerNodeCount();
+	}
+	if (type == SCAN_TYPE_REMOVE_NODE) return focal.getCognitiveNodeCount() > 0;
+	if (type == SCAN_TYPE_MUTATE) return true;
+	return focal.getParameterCount(type) > 0;
+}
+
+/*
+Mutates a random parameter of a value class, or applies the structural mutation, or mutates the whole
+network as the simulation does (which may leave it unchanged, as in the simulation)*/
+template<typename Network>
+int MutationScan<Network>::mutate(Network& mutant, int type)
+{
+	int inner_node_count = mutant.getInnerNodeCount();
+	if (type == SCAN_TYPE_ADD_NODE) mutant.addNode();
+	else if (type == SCAN_TYPE_REMOVE_NODE) mutant.removeNode();
+	else if (type == SCAN_TYPE_MUTATE) {
+		Network* population[1] = {&mutant};
+		MutationRecord record;
+		mutation_engine.mutatePopulation(population, 1, &record);
+	}
+	else mutant.mutateParameter(type, RNG::getRandomInt(0, mutant.getParameterCount(type) - 1));
+	return mutant.getInnerNodeCount() - inner_node_count;
+}
+
+/*
+Mutants are generated on the calling thread (from its RNG stream), the focal copies being the first
+individuals of the evaluated set, followed by the mutants in order of type.*/
+template<typename Network>
+void MutationScan<Network>::scan(const Network& focal, std::vector<std::unique_ptr<Network>> residents, 
+	unsigned mutants_per_type, const PairingPlan& plan)
+{
+	if (residents.empty())
+		throw std::runtime_error("MutationScan: no resident population");
+	if (mutants_per_type == 0)
+		throw std::runtime_error("MutationScan: no mutants per type");
+	if (plan.sampled_pairs > 0) //candidates left without a pair would have no fitness
+		throw std::runtime_error("MutationScan: every candidate must play every resident (no sampled pairs)");
+	
+	mutants.clear();
+	std::vector<std::unique_ptr<Network>> candidates;
+	focal_copies = mutants_per_type;
+	for (unsigned copy=0; copy<focal_copies; ++copy) {
+		candidates.emplace_back(new Network(focal));
+	}
+	for (int type=0; type<SCAN_TYPE_COUNT; ++type) {
+		if (not applies(focal, type)) continue;
+		
+		for (unsigned mutant_index=0; mutant_index<mutants_per_type; ++mutant_index) {
+			candidates.emplace_back(new Network(focal));
+			mutants.push_back({type, mutate(*candidates.back(), type), 0});
+		}
+	}
+	
+	std::vector<int> inner_nodes;
+	for (const std::unique_ptr<Network>& candidate : candidates) {
+		inner_nodes.push_back(candidate->getInnerNodeCount());
+	}
+	
+	CrossEvaluation<Network> evaluation(game_payoffs, thread_count);
+	std::size_t resident_set = evaluation.addSet("residents", std::move(residents));
+	std::size_t candidate_set = evaluation.addSet("mutants", std::move(candidates));
+	PairingPlan across = plan;
+	across.across_sets_only = true;
+	evaluation.evaluate(across);
+	
+	std::vector<double> payoffs = evaluation.getIndividualPayoffs(candidate_set, resident_set);
+	std::vector<double> fitness(payoffs.size());
+	for (std::size_t candidate=0; candidate<payoffs.size(); ++candidate) {
+		fitness[candidate] = payoffs[candidate] - NODE_FITNESS_PENALTY * inner_nodes[candidate];
+	}
+	
+	RunningStats focal_stats;
+	for (unsigned copy=0; copy<focal_copies; ++copy) {
+		focal_stats.add(fitness[copy]);
+	}
+	focal_fitness = focal_stats.mean();
+	focal_error = std::sqrt(focal_stats.variance() / focal_copies);
+	for (std::size_t mutant=0; mutant<mutants.size(); ++mutant) {
+		mutants[mutant].fitness_effect = fitness[mutant + focal_copies] - focal_fitness;
+	}
+}
+
+template<typename Network>
+double MutationScan<Network>::getFocalFitness() const
+{
+	return focal_fitness;
+}
+
+template<typename Network>
+double MutationScan<Network>::getFocalError() const
+{
+	return focal_error;
+}
+
+template<typename Network>
+const std::vector<ScanMutant>& MutationScan<Network>::getMutants() const
+{
+	return mutants;
+}
+
+/*
+Writes fitness_effects (one row per mutant) and effect_summary (one row per scanned type), with the
+mean, standard deviation, median and the fractions of beneficial and deleterious mutants.*/
+template<typename Network>
+void MutationScan<Network>::write(std::ostream& output) const
+{
+	std::string text = "# SCAN types are [";
+	for (int type=0; type<SCAN_TYPE_COUNT; ++type) {
+		text += std::string(type > 0 ? ", " : "") + std::to_string(type) + " " + typeName(type);
+	}
+	text += "]\n";
+	text += "# Focal fitness: " + std::to_string(focal_fitness) + " (standard error " + std::to_string(focal_error) 
+		+ " over " + std::to_string(focal_copies) + " copies)\n";
+	
+	text += "# FITNESS_EFFECTS columns are [type, inner node change, fitness effect]\n";
+	text += "# name: fitness_effects\n";
+	text += "# type: matrix\n";
+	text += "# rows: " + std::to_string(mutants.size()) + "\n";
+	text += "# columns: 3\n";
+	for (const ScanMutant& mutant : mutants) {
+		text += std::to_string(mutant.type) + " " + std::to_string(mutant.node_change) + " " 
+			+ std::to_string(mutant.fitness_effect) + " \n";
+	}
+	text += "\n";
+	
+	std::vector<std::string> rows;
+	for (int type=0; type<SCAN_TYPE_COUNT; ++type) {
+		RunningStats effects;
+		std::vector<double> sorted_effects;
+		double beneficial = 0, deleterious = 0;
+		for (const ScanMutant& mutant : mutants) {
+			if (mutant.type != type) continue;
+			effects.add(mutant.fitness_effect);
+			sorted_effects.push_back(mutant.fitness_effect);
+			if (mutant.fitness_effect > 0) beneficial += 1;
+			if (mutant.fitness_effect < 0) deleterious += 1;
+		}
+		if (sorted_effects.empty()) continue;
+		
+		std::sort(sorted_effects.begin(), sorted_effects.end());
+		std::size_t middle = sorted_effects.size() / 2;
+		double median = (sorted_effects.size() % 2 == 1) ? sorted_effects[middle] 
+			: (sorted_effects[middle - 1] + sorted_effects[middle]) / 2;
+		double count = static_cast<double>(sorted_effects.size());
+		
+		rows.push_back(std::to_string(type) + " " + std::to_string(sorted_effects.size()) + " " 
+			+ std::to_string(effects.mean()) + " " + std::to_string(std::sqrt(effects.variance())) + " "
+			+ std::to_string(median) + " " + std::to_string(beneficial / count) + " " + std::to_string(deleterious / count) + " \n");
+	}
+	
+	text += "# EFFECT_SUMMARY columns are [type, mutants, mean effect, standard deviation, median effect, "
+		"beneficial fraction, deleterious fraction]\n";
+	text += "# name: effect_summary\n";
+	text += "# type: matrix\n";
+	text += "# rows: " + std::to_string(rows.size()) + "\n";
+	text += "# columns: 7\n";
+	for (const std::string& row : rows) {
+		text += row;
+	}
+	text += "\n";
+	output << text;
+}
+
+template<typename Network>
+const char* MutationScan<Network>::typeName(int type)
+{
+	switch (type) {
+		case SCAN_TYPE_ADD_NODE: return "add-node";
+		case SCAN_TYPE_REMOVE_NODE: return "remove-node";
+		case SCAN_TYPE_MUTATE: return "mutate";
+		default: return MutationRates::className(type);
+	}
+}
+
+
+/**---------- Available precisions ----------**/
+
+template class MutationScan<NeuralNetwork>;
+template class MutationScan<FloatNeuralNetwork>;
+template class MutationScan<FixedNeuralNetwork>;
+template class MutationScan<DenseNetwork>;
@@ -0,0 +1,110 @@
+#include "MutationScanTest.hpp"
+
+
+/*Scans the focal network against copies of the residents, from the test seed*/
+static void runScan(MutationScan<NeuralNetwork>& scan, const NeuralNetwork& focal, const std::vector<NeuralNetwork>& residents)
+{
+	std::vector<std::unique_ptr<NeuralNetwork>> copies;
+	for (const NeuralNetwork& resident : residents) {
+		copies.emplace_back(new NeuralNetwork(resident));
+	}
+	
+	RNG::setSeed(MUTATIONSCAN_TEST_SEED);
+	PairingPlan plan;
+	plan.matches = 2;
+	scan.scan(focal, std::move(copies), MUTATIONSCAN_TEST_MUTANTS, plan);
+}
+
+void testMutationScan()
+{
+	std::cout << "Testing MutationScan...";
+	
+	const Payoffs payoffs = Payoffs::getPayoffsForGameType("IPD");
+	std::vector<NeuralNetwork> residents(MUTATIONSCAN_TEST_RESIDENTS);
+	
+	///Every type applies to a network with a cognitive node and its context node
+	NeuralNetwork focal;
+	while (focal.getCognitiveNodeCount() > 0) focal.removeNode();
+	focal.addCognitiveNode();
+	focal.addContextNode();
+	
+	MutationScan<NeuralNetwork> scan(payoffs, 1);
+	runScan(scan, focal, residents);
+	assert(scan.getMutants().size() == SCAN_TYPE_COUNT * MUTATIONSCAN_TEST_MUTANTS);
+	for (std::size_t mutant=0; mutant<scan.getMutants().size(); ++mutant) {
+		const ScanMutant& current = scan.getMutants()[mutant];
+		assert(current.type == static_cast<int>(mutant / MUTATIONSCAN_TEST_MUTANTS)); //in order of type
+		assert(std::isfinite(current.fitness_effect));
+		if (current.type == SCAN_TYPE_ADD_NODE) assert(current.node_change == 1);
+		else if (current.type == SCAN_TYPE_REMOVE_NODE) assert(current.node_change < 0); //with its context node, if any
+		else if (current.type != SCAN_TYPE_MUTATE) assert(current.node_change == 0);
+	}
+	//payoffs per game iteration are between the lowest and highest IPD payoffs
+	assert(scan.getFocalFitness() >= IPD_SELF_DEFECTS - NODE_FITNESS_PENALTY * 2);
+	assert(scan.getFocalFitness() <= IPD_SELF_COOPERATES);
+	assert(scan.getFocalError() > 0); //match lengths are random
+	
+	///The results do not depend on the number of threads
+	MutationScan<NeuralNetwork> threaded(payoffs, MUTATIONSCAN_TEST_THREADS);
+	runScan(threaded, focal, residents);
+	assert(threaded.getFocalFitness() == scan.getFocalFitness());
+	assert(threaded.getFocalError() == scan.getFocalError());
+	for (std::size_t mutant=0; mutant<scan.getMutants().size(); ++mutant) {
+		assert(threaded.getMutants()[mutant].fitness_effect == scan.getMutants()[mutant].fitness_effect);
+	}
+	
+	///Whole mutations follow the rates, as in the simulation
+	MutationRates structural_rates;
+	structural_rates.set("values", 0);
+	structural_rates.set("structure", 1);
+	MutationScan<NeuralNetwork> structural(payoffs, 1, structural_rates);
+	runScan(structural, focal, residents);
+	for (const ScanMutant& mutant : structural.getMutants()) {
+		if (mutant.type == SCAN_TYPE_MUTATE) assert(mutant.node_change != 0);
+	}
+	
+	//unmutated copies have no effect on average, within the noise of both means
+	MutationRates no_rates;
+	no_rates.set("values", 0);
+	no_rates.set("structure", 0);
+	MutationScan<NeuralNetwork> unmutated(payoffs, 1, no_rates);
+	runScan(unmutated, focal, residents);
+	RunningStats copy_effects;
+	for (const ScanMutant& mutant : unmutated.getMutants()) {
+		if (mutant.type == SCAN_TYPE_MUTATE) copy_effects.add(mutant.fitness_effect);
+	}
+	assert(std::fabs(copy_effects.mean()) <= 4 * std::sqrt(2.0) * unmutated.getFocalError());
+	
+	std::ostringstream output;
+	scan.write(output);
+	assert(output.str().find(" over " + std::to_string(MUTATIONSCAN_TEST_MUTANTS) + " copies)\n") != std::string::npos);
+	assert(output.str().find("# name: effect_summary\n# type: matrix\n# rows: " + std::to_string(SCAN_TYPE_COUNT) + "\n") != std::string::npos);
+	
+	///Node values and removals do not apply to a network without nodes
+	NeuralNetwork empty(focal);
+	empty.removeContextNode();
+	empty.removeCognitiveNode();
+	MutationScan<NeuralNetwork> empty_scan(payoffs, 1);
+	runScan(empty_scan, empty, residents);
+	for (const ScanMutant& mutant : empty_scan.getMutants()) {
+		assert(mutant.type == PARAMETER_DEFAULT_CHOICE or mutant.type == PARAMETER_OUTPUT_THRESHOLD 
+			or mutant.type == SCAN_TYPE_ADD_NODE or mutant.type == SCAN_TYPE_MUTATE);
+	}
+	assert(empty_scan.getMutants().size() == 4 * MUTATIONSCAN_TEST_MUTANTS);
+	
+	///Sampled pairs would leave candidates without fitness
+	std::vector<std::unique_ptr<NeuralNetwork>> sampled_residents;
+	sampled_residents.emplace_back(new NeuralNetwork(residents[0]));
+	PairingPlan sampled;
+	sampled.sampled_pairs = 1;
+	bool rejected = false;
+	try {
+		scan.scan(focal, std::move(sampled_residents), MUTATIONSCAN_TEST_MUTANTS, sampled);
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	assert(rejected);
+	
+	std::cout << " done!" << std::endl;
+}
@@ -0,0 +1,72 @@
+#include "MutationTest.hpp"
+
+
+void testMutation()
+{
+	std::cout << "Testing Mutation...";
+	
+	///Rates parsing
+	MutationRates rates;
+	assert(rates.rates[PARAMETER_DEFAULT_CHOICE] == NETWORK_VALUE_MUTATION_PROB);
+	assert(rates.rates[PARAMETER_STRUCTURE] == NETWORK_STRUCTURE_MUTATION_PROB);
+	assert(rates.parse("values:0.5,structure:0"));
+	assert(rates.rates[PARAMETER_CONTEXT_WEIGHT] == 0.5 and rates.rates[PARAMETER_STRUCTURE] == 0);
+	assert(rates.parse("threshold:0.25") and rates.rates[PARAMETER_NODE_THRESHOLD] == 0.25);
+	assert(not rates.parse("unknown:0.1"));
+	assert(not rates.parse("values:2"));
+	assert(not rates.parse("values"));
+	
+	std::vector<NeuralNetwork*> population;
+	for (int i=0; i<MUTATION_TEST_POPULATION; ++i) {
+		population.push_back(new NeuralNetwork());
+	}
+	std::vector<MutationRecord> records(MUTATION_TEST_POPULATION);
+	
+	///Every parameter mutates with rate 1, none with rate 0
+	MutationRates all_rates, no_rates;
+	all_rates.set("values", 1);
+	all_rates.set("structure", 0);
+	no_rates.set("values", 0);
+	no_rates.set("structure", 0);
+	
+	MutationEngine<NeuralNetwork>(all_rates).mutatePopulation(population.data(), MUTATION_TEST_POPULATION, records.data());
+	for (int i=0; i<MUTATION_TEST_POPULATION; ++i) {
+		int parameter_count = 0;
+		for (int parameter_class=0; parameter_class<PARAMETER_CLASS_COUNT; ++parameter_class) {
+			if (parameter_class != PARAMETER_STRUCTURE) parameter_count += population[i]->getParameterCount(parameter_class);
+		}
+		assert(records[i].value_mutations == parameter_count);
+		assert(records[i].node_change == 0);
+	}
+	
+	NeuralNetwork unchanged(*population[0]);
+	MutationEngine<NeuralNetwork>(no_rates).mutatePopulation(population.data(), MUTATION_TEST_POPULATION, records.data());
+	assert(unchanged == *population[0]);
+	for (const MutationRecord& record : records) {
+		assert(record.value_mutations == 0 and record.node_change == 0);
+	}
+	
+	///Default rates give as many mutations as NeuralNetwork::mutate on average
+	MutationEngine<NeuralNetwork> engine;
+	double engine_mutations = 0, network_mutations = 0, expected_mutations = 0;
+	for (int round=0; round<MUTATION_TEST_ROUNDS; ++round) {
+		for (int i=0; i<MUTATION_TEST_POPULATION; ++i) {
+			expected_mutations += NETWORK_VALUE_MUTATION_PROB * (2 + 5 * population[i]->getCognitiveNodeCount());
+		}
+		engine.mutatePopulation(population.data(), MUTATION_TEST_POPULATION, records.data());
+		for (const MutationRecord& record : records) engine_mutations += record.value_mutations;
+		
+		for (int i=0; i<MUTATION_TEST_POPULATION; ++i) {
+			network_mutations += population[i]->mutate().value_mutations;
+		}
+	}
+	//both counts are binomial with about 2.10^4 expected mutations (standard deviation about 150)
+	assert(std::fabs(engine_mutations - expected_mutations) < 0.05 * expected_mutations);
+	assert(std::fabs(network_mutations - engine_mutations) < 0.05 * expected_mutations);
+	
+	for (NeuralNetwork* network : population) {
+		delete network;
+	}
+	
+	std::cout << " done!" << std::endl;
+}
@@ -1,78 +1,103 @@
 #include "NeuralNetwork.hpp"
 
+#include <algorithm>
+
 
 /**---------- Out of class ----------**/
 
 /* Computes the sigmoidal squash of -value -threshold (maps values from [-inf, inf] to [0, 1]) */
-numval sigmoidalSquash(numval value, numval threshold)
+template<typename T>
+T sigmoidalSquash(T value, T threshold)
 {
 	return 1 / (1 + std::exp(-value -threshold));
 }
 
+/* Fixed-point squash: value + threshold saturates to 16 bits, so every possible result fits in a table */
+template<>
+Fixed16 sigmoidalSquash<Fixed16>(Fixed16 value, Fixed16 threshold)
+{
+	//table of squashed values indexed by the raw sum (built once, thread-safe)
+	static const std::vector<Fixed16> squash_table = []{
+		std::vector<Fixed16> table;
+		for (std::int32_t raw=std::numeric_limits<std::int16_t>::min(); raw<=std::numeric_limits<std::int16_t>::max(); ++raw) {
+			double sum = static_cast<double>(Fixed16::fromRaw(static_cast<std::int16_t>(raw)));
+			table.push_back(Fixed16(1 / (1 + std::exp(-sum))));
+		}
+		return table;
+	}();
+	
+	Fixed16 sum = value + threshold;
+	return squash_table[static_cast<std::size_t>(sum.getRaw() - std::numeric_limits<std::int16_t>::min())];
+}
+
 
 /**---------- InnerNode ----------**/
 
 /*Regular constructor with provided threshold value*/
-InnerNode::InnerNode(numval threshold):
+template<typename T>
+BasicInnerNode<T>::BasicInnerNode(T threshold):
 	threshold_value(threshold)
 	{}
 	
 /*Copy constructor*/
-InnerNode::InnerNode(const InnerNode& in):
+template<typename T>
+BasicInnerNode<T>::BasicInnerNode(const BasicInnerNode& in):
 	threshold_value(in.threshold_value),
 	has_context_node(in.has_context_node),
 	context_link_weight(in.context_link_weight)
-	//context value (node's memory) is not inherited
 	{}
 
 /*True if the cognitive node has an associated context node.*/
-bool InnerNode::hasContextNode()
+template<typename T>
+bool BasicInnerNode<T>::hasContextNode() const
 {
 	return has_context_node;
 }
 
 /*Adds a context node to the cognitive node*/
-void InnerNode::addContextNode(numval value, numval link_weight)
+template<typename T>
+void BasicInnerNode<T>::addContextNode(T link_weight)
 {
 	assert(not hasContextNode());
 	has_context_node = true;
-	context_value = value;
 	context_link_weight = link_weight;
 	assert(hasContextNode());
 }
 
 /*Removes the context node from the cognitive node*/
-void InnerNode::removeContextNode()
+template<typename T>
+void BasicInnerNode<T>::removeContextNode()
 {
 	assert(hasContextNode());
 	has_context_node = false;
-	context_value = 0;
-	context_link_weight = 0;
+	context_link_weight = T(0);
 	assert(not hasContextNode());
 }
 
-/*Returns the node output given the provided input*/
-numval InnerNode::operator()(numval input)
+/*Returns the node output given the provided input and the node's context value (from the network's state)*/
+template<typename T>
+T BasicInnerNode<T>::operator()(T input, T& context_value) const
 {
-	assert(not std::isnan(input)); //verify numval is a regular numeric value
+	assert(not std::isnan(static_cast<double>(input))); //verify input is a regular numeric value
 	
 	if (has_context_node) {
 		input += context_value * context_link_weight; //add weighted context to input
 		input = sigmoidalSquash(input, threshold_value);
-		context_value = input; //store result in context node
+		context_value = input; //store result as the new context value
 	}
 	else {
 		input = sigmoidalSquash(input, threshold_value);
 	}
 	
-	assert(input >= 0 and input <= 1); //verify the squashing function worked
+	assert(input >= T(0) and input <= T(1)); //verify the squashing function worked
 	
 	return input;
 }
 
 /*True if both inner nodes have the same threshold value, number of context nodes 
 and context link weight (context value is not compared).*/
-bool InnerNode::operator==(const InnerNode& in)
+template<typename T>
+bool BasicInnerNode<T>::operator==(const BasicInnerNode& in) const
 {
 	return has_context_node == in.has_context_node
 		and context_link_weight == in.context_link_weight
@@ -83,9 +108,10 @@ bool InnerNode::operator==(const InnerNode& in)
 /**---------- NeuralNetwork ----------**/
 
 /*Default constructor*/
-NeuralNetwork::NeuralNetwork():
+template<typename T>
+BasicNeuralNetwork<T>::BasicNeuralNetwork():
 	cooperate_by_default(RNG::getRandomBool()), //random bool
-	output_node_threshold(RNG::getRandomNumval()) //random real value
+	output_node_threshold(static_cast<T>(RNG::getRandomNumval())) //random real value
 {	
 	//Choose number of initial nodes
 	int initial_nodes = RNG::getInitialNodeCount();
@@ -97,58 +123,96 @@ NeuralNetwork::NeuralNetwork():
 }
 
 /*Copy constructor*/
-NeuralNetwork::NeuralNetwork(const NeuralNetwork& nn):
+template<typename T>
+BasicNeuralNetwork<T>::BasicNeuralNetwork(const BasicNeuralNetwork& nn):
 	cooperate_by_default(nn.cooperate_by_default),
 	output_node_threshold(nn.output_node_threshold),
 	context_node_count(nn.context_node_count),
+	inner_nodes(nn.inner_nodes),
 	link_weights_from_self_payoff(nn.link_weights_from_self_payoff),
 	link_weights_from_other_payoff(nn.link_weights_from_other_payoff),
 	link_weights_from_inner_nodes(nn.link_weights_from_inner_nodes)
 {
-	//Create new inner nodes by copying nn's inner nodes
-	for (int i=0; i<nn.getCognitiveNodeCount(); ++i) {
-		inner_nodes.push_back(new InnerNode(*nn.inner_nodes[i]));
-	}
+	//context values (network's memory) are not inherited
+	carryover_state.context_values.assign(nn.carryover_state.context_values.size(), T(0));
 	assert(getCognitiveNodeCount() == nn.getCognitiveNodeCount());
 	assert(getContextNodeCount() == nn.getContextNodeCount());
 	assert(getInnerNodeCount() >= 0 and getInnerNodeCount() <= MAXNODES*2);
 }
 
-/*Destructor*/
-NeuralNetwork::~NeuralNetwork()
+/*Genome constructor (see writeGenome), does not draw any random value*/
+template<typename T>
+BasicNeuralNetwork<T>::BasicNeuralNetwork(const char* genome):
+	cooperate_by_default(genome[0] != 0)
 {
-	for (int i=0; i<getCognitiveNodeCount(); ++i) {
-		delete inner_nodes[i];
+	int cognitive_nodes = static_cast<unsigned char>(genome[1]);
+	assert(cognitive_nodes <= MAXNODES);
+	
+	const char* values = genome + GENOME_HEADER_SIZE;
+	std::memcpy(&output_node_threshold, values, sizeof(T));
+	values += sizeof(T);
+	
+	for (int i=0; i<cognitive_nodes; ++i) {
+		T node_values[GENOME_NODE_VALUES];
+		std::memcpy(node_values, values, sizeof(node_values));
+		values += sizeof(node_values);
+		
+		inner_nodes.emplace_back(node_values[0]);
+		link_weights_from_self_payoff.push_back(node_values[1]);
+		link_weights_from_other_payoff.push_back(node_values[2]);
+		link_weights_from_inner_nodes.push_back(node_values[3]);
+		carryover_state.context_values.push_back(node_values[4]);
+		inner_nodes.back().context_link_weight = node_values[5];
+		
+		if (*values++ != 0) {
+			inner_nodes.back().has_context_node = true;
+			context_node_count++;
+		}
 	}
+	assert(context_node_count == static_cast<unsigned char>(genome[2]));
 }
 
-/*Returns a randomly chosen cognitive node index, with or without context node depending on withContext*/
-int NeuralNetwork::getRandomCognitiveNode(bool withContext)
+/*Copy assignment, reusing the storage of the network's vectors (context values are not inherited)*/
+template<typename T>
+BasicNeuralNetwork<T>& BasicNeuralNetwork<T>::operator=(const BasicNeuralNetwork& nn)
 {
-	//Find which cognitive nodes have or do not have a context (depending on withContext)
-	std::vector<int> nodeSelection = {};
-	for (int i=0; i<getCognitiveNodeCount(); ++i) {
-		if (inner_nodes[i]->hasContextNode() == withContext)
-			nodeSelection.push_back(i);
-	}
+	if (this == &nn) return *this;
 	
-	int nodeSelectionSize = static_cast<int>(nodeSelection.size());
-	if (withContext)
-		assert(getContextNodeCount() == nodeSelectionSize);
-	else
-		assert(getCognitiveNodeCount() - getContextNodeCount() == nodeSelectionSize);
+	cooperate_by_default = nn.cooperate_by_default;
+	output_node_threshold = nn.output_node_threshold;
+	context_node_count = nn.context_node_count;
+	inner_nodes = nn.inner_nodes;
+	link_weights_from_self_payoff = nn.link_weights_from_self_payoff;
+	link_weights_from_other_payoff = nn.link_weights_from_other_payoff;
+	link_weights_from_inner_nodes = nn.link_weights_from_inner_nodes;
+	carryover_state.context_values.assign(nn.carryover_state.context_values.size(), T(0));
+	return *this;
+}
+
+/*Returns a randomly chosen cognitive node index, with or without context node depending on withContext*/
+template<typename T>
+int BasicNeuralNetwork<T>::getRandomCognitiveNode(bool withContext)
+{
+	//Number of cognitive nodes that have or do not have a context (depending on withContext)
+	int nodeSelectionSize = withContext ? getContextNodeCount() : getCognitiveNodeCount() - getContextNodeCount();
 	
-	//Choose random cognitive node from the context-free list
-	unsigned int chosen_context_node = nodeSelection[RNG::getRandomInt(0, nodeSelectionSize-1)];
+	//Choose the rank of the node among them, then find it (no temporary list)
+	int rank = RNG::getRandomInt(0, nodeSelectionSize-1);
+	int chosen_context_node = 0;
+	while (inner_nodes[chosen_context_node].hasContextNode() != withContext or rank-- > 0) {
+		chosen_context_node++;
+		assert(chosen_context_node < getCognitiveNodeCount());
+	}
 	
-	assert(inner_nodes[chosen_context_node]->hasContextNode() == withContext);
+	assert(inner_nodes[chosen_context_node].hasContextNode() == withContext);
 	
 	return chosen_context_node;
 }
 
 /*If possible, adds a node to the network. 
 Choice between context and cognitive nodes is random if both choices are allowed*/
-void NeuralNetwork::addNode()
+template<typename T>
+void BasicNeuralNetwork<T>::addNode()
 {
 	if (getInnerNodeCount() == MAXNODES*2) //Cannot add new nodes
 		return;
@@ -168,7 +232,8 @@ void NeuralNetwork::addNode()
 
 /*Adds a context node to a randomly chose, context-free cognitive node.
 If such a cognitive nodes does not exist, assertion fails.*/
-void NeuralNetwork::addContextNode() 
+template<typename T>
+void BasicNeuralNetwork<T>::addContextNode() 
 {
 	assert(getContextNodeCount() < getCognitiveNodeCount());
 	
@@ -176,31 +241,35 @@ void NeuralNetwork::addContextNode()
 	unsigned int chosen_context_node = getRandomCognitiveNode(false);
 	
 	//Add context node to one cognitive node (random context value and link weight)
-	numval context_value = RNG::getRandomNumval();
-	numval link_weight = RNG::getRandomNumval();
-	inner_nodes[chosen_context_node]->addContextNode(context_value, link_weight);
+	T context_value = static_cast<T>(RNG::getRandomNumval());
+	T link_weight = static_cast<T>(RNG::getRandomNumval());
+	inner_nodes[chosen_context_node].addContextNode(link_weight);
+	carryover_state.context_values[chosen_context_node] = context_value;
 	context_node_count++;
 }
 
 /*Adds a cognitive node to the network.
 If the maximum amount of cognitive nodes is already reached, assertion fails.*/
-void NeuralNetwork::addCognitiveNode()
+template<typename T>
+void BasicNeuralNetwork<T>::addCognitiveNode()
 {
 	assert(getCognitiveNodeCount() < MAXNODES);
 	
 	//Add cognitive node to the network (random threshold)
-	numval threshold_value = RNG::getRandomNumval();
-	inner_nodes.push_back(new InnerNode(threshold_value));
+	T threshold_value = static_cast<T>(RNG::getRandomNumval());
+	inner_nodes.emplace_back(threshold_value);
+	carryover_state.context_values.push_back(T(0));
 	
 	//Initialize link weights to and from node with random values
-	link_weights_from_self_payoff.push_back(RNG::getRandomNumval());
-	link_weights_from_other_payoff.push_back(RNG::getRandomNumval());
-	link_weights_from_inner_nodes.push_back(RNG::getRandomNumval());
+	link_weights_from_self_payoff.push_back(static_cast<T>(RNG::getRandomNumval()));
+	link_weights_from_other_payoff.push_back(static_cast<T>(RNG::getRandomNumval()));
+	link_weights_from_inner_nodes.push_back(static_cast<T>(RNG::getRandomNumval()));
 }
 
 /*If possible, removes a randomly chosen, context or cognitive node from the network. 
 Choice between context and cognitive nodes is random if both choices are allowed*/
-void NeuralNetwork::removeNode()
+template<typename T>
+void BasicNeuralNetwork<T>::removeNode()
 {
 	if (getCognitiveNodeCount() == 0) //there are no nodes to remove
 		return;
@@ -215,7 +284,8 @@ void NeuralNetwork::removeNode()
 		removeCognitiveNode();
 }
 
-void NeuralNetwork::removeContextNode() 
+template<typename T>
+void BasicNeuralNetwork<T>::removeContextNode() 
 {
 	assert(getContextNodeCount() > 0 and getCognitiveNodeCount() >= getContextNodeCount());
 	
@@ -223,12 +293,14 @@ void NeuralNetwork::removeContextNode()
 	int chosen_context_node = getRandomCognitiveNode(true);
 	
 	//Remove context node from one cognitive node
-	inner_nodes[chosen_context_node]->removeContextNode();
+	inner_nodes[chosen_context_node].removeContextNode();
+	carryover_state.context_values[chosen_context_node] = T(0);
 	
 	context_node_count--;
 }
 
-void NeuralNetwork::removeCognitiveNode()
+template<typename T>
+void BasicNeuralNetwork<T>::removeCognitiveNode()
 {
 	assert(getCognitiveNodeCount() > 0);
 	
@@ -236,12 +308,12 @@ void NeuralNetwork::removeCognitiveNode()
 	int chosen_cognitive_node = RNG::getRandomInt(0, getCognitiveNodeCount()-1);
 	
 	//If cognitive node has context node, uncount it
-	if (inner_nodes[chosen_cognitive_node]->hasContextNode())
+	if (inner_nodes[chosen_cognitive_node].hasContextNode())
 		context_node_count--;
 	
 	//Remove cognitive node from the network
-	delete inner_nodes[chosen_cognitive_node];
 	inner_nodes.erase(inner_nodes.begin() + chosen_cognitive_node);
+	carryover_state.context_values.erase(carryover_state.context_values.begin() + chosen_cognitive_node);
 	
 	//Remove its link weights
 	link_weights_from_self_payoff.erase(link_weights_from_self_payoff.begin() + chosen_cognitive_node);
@@ -251,56 +323,110 @@ void NeuralNetwork::removeCognitiveNode()
 
 /*
 Mutates the network's numeric values and structure with default probabilities.
+Returns the number of mutated values and the resulting change in inner nodes.
 */
-void NeuralNetwork::mutate()
+template<typename T>
+MutationRecord BasicNeuralNetwork<T>::mutate()
 {
+	MutationRecord record;
+	
 	///Default choice
-	if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) 
-		cooperate_by_default = not (cooperate_by_default);
+	if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) {
+		mutateParameter(PARAMETER_DEFAULT_CHOICE, 0);
+		record.value_mutations++;
+	}
 	
-	///Link weights and inner node thresholds
+	///Link weights and inner node thresholds (in this order for each cognitive node)
 	for (int i=0; i<getCognitiveNodeCount(); i++) {
-		//From self payoff to inner nodes
-		if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) {
-			link_weights_from_self_payoff[i] += RNG::getRandomNumval();
-		}
-		//From other payoff to inner nodes
-		if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) {
-			link_weights_from_other_payoff[i] += RNG::getRandomNumval();
-		}
-		//From inner nodes to output
-		if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) {
-			link_weights_from_inner_nodes[i] += RNG::getRandomNumval();
-		}
-		//From context nodes to cognitive nodes
-		if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) {
-			inner_nodes[i]->context_link_weight += RNG::getRandomNumval();
-		}
-		
-		//Cognitive nodes thresholds
-		if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) {
-			inner_nodes[i]->threshold_value += RNG::getRandomNumval();
+		for (int parameter_class=PARAMETER_SELF_PAYOFF_WEIGHT; parameter_class<=PARAMETER_NODE_THRESHOLD; ++parameter_class) {
+			if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) {
+				mutateParameter(parameter_class, i);
+				record.value_mutations++;
+			}
 		}
 	}
 	
 	///Output node threshold
 	if (RNG::getTrueWithProbability(NETWORK_VALUE_MUTATION_PROB)) {
-		output_node_threshold += RNG::getRandomNumval();
+		mutateParameter(PARAMETER_OUTPUT_THRESHOLD, 0);
+		record.value_mutations++;
 	}
 	
 	///Network structure
 	if (RNG::getTrueWithProbability(NETWORK_STRUCTURE_MUTATION_PROB)) {
-		if (RNG::getRandomBool()) addNode();
-		else removeNode();
+		record.node_change = mutateParameter(PARAMETER_STRUCTURE, 0);
+	}
+	
+	return record;
+}
+
+/*Returns the number of mutable parameters of the given class*/
+template<typename T>
+int BasicNeuralNetwork<T>::getParameterCount(int parameter_class) const
+{
+	switch (parameter_class) {
+		case PARAMETER_SELF_PAYOFF_WEIGHT:
+		case PARAMETER_OTHER_PAYOFF_WEIGHT:
+		case PARAMETER_OUTPUT_WEIGHT:
+		case PARAMETER_CONTEXT_WEIGHT:
+		case PARAMETER_NODE_THRESHOLD:
+			return getCognitiveNodeCount();
+		default:
+			assert(parameter_class >= 0 and parameter_class < PARAMETER_CLASS_COUNT);
+			return 1;
+	}
+}
+
+/*
+Applies a single mutation: flips the default choice, adds a random value to a numeric parameter,
+or adds/removes a node (structure). Index selects the cognitive node of per-node parameters.
+Returns the resulting change in inner nodes (always 0 for value mutations).*/
+template<typename T>
+int BasicNeuralNetwork<T>::mutateParameter(int parameter_class, int index)
+{
+	assert(index >= 0 and index < getParameterCount(parameter_class));
+	
+	switch (parameter_class) {
+		case PARAMETER_DEFAULT_CHOICE:
+			cooperate_by_default = not (cooperate_by_default);
+			break;
+		case PARAMETER_SELF_PAYOFF_WEIGHT:
+			link_weights_from_self_payoff[index] += static_cast<T>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_OTHER_PAYOFF_WEIGHT:
+			link_weights_from_other_payoff[index] += static_cast<T>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_OUTPUT_WEIGHT:
+			link_weights_from_inner_nodes[index] += static_cast<T>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_CONTEXT_WEIGHT:
+			inner_nodes[index].context_link_weight += static_cast<T>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_NODE_THRESHOLD:
+			inner_nodes[index].threshold_value += static_cast<T>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_OUTPUT_THRESHOLD:
+			output_node_threshold += static_cast<T>(RNG::getRandomNumval());
+			break;
+		case PARAMETER_STRUCTURE: {
+			int inner_node_count = getInnerNodeCount();
+			if (RNG::getRandomBool()) addNode();
+			else removeNode();
+			return getInnerNodeCount() - inner_node_count;
+		}
 	}
+	
+	return 0;
 }
 
-int NeuralNetwork::getInnerNodeCount()const
+template<typename T>
+int BasicNeuralNetwork<T>::getInnerNodeCount()const
 {
 	return getCognitiveNodeCount() + getContextNodeCount();
 }
 
-int NeuralNetwork::getCognitiveNodeCount() const
+template<typename T>
+int BasicNeuralNetwork<T>::getCognitiveNodeCount() const
 {
 	int size = static_cast<int>(inner_nodes.size());
 	assert (size == static_cast<int>(link_weights_from_inner_nodes.size()) and
@@ -309,39 +435,201 @@ int NeuralNetwork::getCognitiveNodeCount() const
 	return size;
 }
 
-int NeuralNetwork::getContextNodeCount() const
+template<typename T>
+int BasicNeuralNetwork<T>::getContextNodeCount() const
 {
 	return context_node_count;
 }
 
-/*Returns true if it chooses to cooperate based on the input, false otherwise*/
-bool NeuralNetwork::operator()(payoff self_payoff, payoff other_payoff)
+/*Returns a state holding the network's current context values*/
+template<typename T>
+typename BasicNeuralNetwork<T>::State BasicNeuralNetwork<T>::createState() const
+{
+	return carryover_state;
+}
+
+template<typename T>
+typename BasicNeuralNetwork<T>::State& BasicNeuralNetwork<T>::getCarryoverState()
+{
+	return carryover_state;
+}
+
+/*Returns the probability that the network cooperates given the input (updates the state's context values)*/
+template<typename T>
+T BasicNeuralNetwork<T>::getCooperationProbability(payoff self_payoff, payoff other_payoff, State& state) const
 {
 	//If there are no cognitive nodes, use default choice
-	if (getCognitiveNodeCount() == 0) return (*this)();
+	if (getCognitiveNodeCount() == 0) return T(cooperate_by_default ? 1 : 0);
+	assert(static_cast<int>(state.context_values.size()) == getCognitiveNodeCount());
 	
 	//Use inner nodes to compute output
-	numval output = 0;
+	T output = T(0);
 	for (int i=0; i<getCognitiveNodeCount(); ++i) {
-		numval self_input = self_payoff * link_weights_from_self_payoff[i];
-		numval other_input = other_payoff * link_weights_from_other_payoff[i];
-		output += (*inner_nodes[i])(self_input + other_input) * link_weights_from_inner_nodes[i];
+		T self_input = T(self_payoff) * link_weights_from_self_payoff[i];
+		T other_input = T(other_payoff) * link_weights_from_other_payoff[i];
+		output += inner_nodes[i](self_input + other_input, state.context_values[i]) * link_weights_from_inner_nodes[i];
 	}
 	//Squash output into collaboration probability
-	numval cooperate_prob = sigmoidalSquash(output, output_node_threshold);
+	return sigmoidalSquash(output, output_node_threshold);
+}
+
+/*Returns true if it chooses to cooperate based on the input and the state, false otherwise*/
+template<typename T>
+bool BasicNeuralNetwork<T>::decide(payoff self_payoff, payoff other_payoff, State& state) const
+{
+	//If there are no cognitive nodes, use default choice
+	if (getCognitiveNodeCount() == 0) return (*this)();
 	
 	//Cooperate with probability cooperate_prob
-	return RNG::getTrueWithProbability(cooperate_prob);
+	return RNG::getTrueWithProbability(static_cast<double>(getCooperationProbability(self_payoff, other_payoff, state)));
+}
+
+/*Returns the probability that the network cooperates given the input (updates the carryover state)*/
+template<typename T>
+T BasicNeuralNetwork<T>::getCooperationProbability(payoff self_payoff, payoff other_payoff)
+{
+	return getCooperationProbability(self_payoff, other_payoff, carryover_state);
+}
+
+/*Returns true if it chooses to cooperate based on the input, false otherwise (updates the carryover state)*/
+template<typename T>
+bool BasicNeuralNetwork<T>::operator()(payoff self_payoff, payoff other_payoff)
+{
+	return decide(self_payoff, other_payoff, carryover_state);
 }
 
 /*Returns true if it chooses to cooperate by default, false otherwise*/
-bool NeuralNetwork::operator()()
+template<typename T>
+bool BasicNeuralNetwork<T>::operator()() const
 {
 	return cooperate_by_default;
 }
 
+/*Mixes a value into a FNV-1a hash, byte by byte*/
+static void hashCombine(std::uint64_t& hash, const void* value, std::size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(value);
+	for (std::size_t i=0; i<size; ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL; //FNV prime
+	}
+}
+
+/*Returns a hash of everything compared by operator== (identical networks have equal hashes)*/
+template<typename T>
+std::uint64_t BasicNeuralNetwork<T>::hash() const
+{
+	std::uint64_t hash = 14695981039346656037ULL; //FNV offset basis
+	
+	hashCombine(hash, &cooperate_by_default, sizeof(cooperate_by_default));
+	hashCombine(hash, &output_node_threshold, sizeof(output_node_threshold));
+	for (int i=0; i<getCognitiveNodeCount(); ++i) {
+		const BasicInnerNode<T>& node = inner_nodes[i];
+		hashCombine(hash, &node.threshold_value, sizeof(node.threshold_value));
+		hashCombine(hash, &node.has_context_node, sizeof(node.has_context_node));
+		hashCombine(hash, &node.context_link_weight, sizeof(node.context_link_weight));
+		hashCombine(hash, &link_weights_from_self_payoff[i], sizeof(T));
+		hashCombine(hash, &link_weights_from_other_payoff[i], sizeof(T));
+		hashCombine(hash, &link_weights_from_inner_nodes[i], sizeof(T));
+	}
+	
+	return hash;
+}
+
+/*
+Flat layout, shared by every network type so that networks are compared value by value (see 
+DiversityCollector): default choice (0 or 1) and output threshold, then per node slot its threshold,
+payoff weights, output weight and context weight. Context values belong to the state and are left out.*/
+template<typename T>
+void BasicNeuralNetwork<T>::writeFlatParameters(float* values, float* structure, int node_slots) const
+{
+	assert(node_slots >= getCognitiveNodeCount());
+	
+	values[0] = cooperate_by_default ? 1.0f : 0.0f;
+	values[1] = static_cast<float>(static_cast<double>(output_node_threshold));
+	std::fill(values + FLAT_NETWORK_VALUES, values + FLAT_NETWORK_VALUES + node_slots*FLAT_NODE_VALUES, 0.0f);
+	std::fill(structure, structure + node_slots*FLAT_NODE_STRUCTURE, 0.0f);
+	
+	for (int i=0; i<getCognitiveNodeCount(); ++i) {
+		const BasicInnerNode<T>& node = inner_nodes[i];
+		float* node_values = values + FLAT_NETWORK_VALUES + i*FLAT_NODE_VALUES;
+		node_values[0] = static_cast<float>(static_cast<double>(node.threshold_value));
+		node_values[1] = static_cast<float>(static_cast<double>(link_weights_from_self_payoff[i]));
+		node_values[2] = static_cast<float>(static_cast<double>(link_weights_from_other_payoff[i]));
+		node_values[3] = static_cast<float>(static_cast<double>(link_weights_from_inner_nodes[i]));
+		node_values[4] = static_cast<float>(static_cast<double>(node.context_link_weight));
+		
+		structure[i*FLAT_NODE_STRUCTURE] = 1.0f;
+		structure[i*FLAT_NODE_STRUCTURE + 1] = node.has_context_node ? 1.0f : 0.0f;
+	}
+}
+
+template<typename T>
+std::size_t BasicNeuralNetwork<T>::getGenomeSize() const
+{
+	return GENOME_HEADER_SIZE + sizeof(T) + static_cast<std::size_t>(getCognitiveNodeCount()) * (GENOME_NODE_VALUES * sizeof(T) + 1);
+}
+
+/*
+Genome layout (values in the network's precision, native byte order, unaligned):
+- 4 bytes: default choice, cognitive node count, context node count, padding
+- output node threshold
+- per cognitive node: threshold, self payoff weight, other payoff weight, output weight, 
+  context value, context link weight, then one byte telling if the context node exists*/
+template<typename T>
+void BasicNeuralNetwork<T>::writeGenome(char* genome) const
+{
+	genome[0] = cooperate_by_default ? 1 : 0;
+	genome[1] = static_cast<char>(getCognitiveNodeCount());
+	genome[2] = static_cast<char>(getContextNodeCount());
+	genome[3] = 0;
+	
+	char* values = genome + GENOME_HEADER_SIZE;
+	std::memcpy(values, &output_node_threshold, sizeof(T));
+	values += sizeof(T);
+	
+	for (int i=0; i<getCognitiveNodeCount(); ++i) {
+		const BasicInnerNode<T>& node = inner_nodes[i];
+		T node_values[GENOME_NODE_VALUES] = {node.threshold_value, link_weights_from_self_payoff[i], 
+			link_weights_from_other_payoff[i], link_weights_from_inner_nodes[i], carryover_state.context_values[i], node.context_link_weight};
+		std::memcpy(values, node_values, sizeof(node_values));
+		values += sizeof(node_values);
+		
+		*values++ = node.has_context_node ? 1 : 0;
+	}
+}
+
+template<typename T>
+std::size_t BasicNeuralNetwork<T>::readGenomeSize(const char* genome)
+{
+	std::size_t cognitive_nodes = static_cast<unsigned char>(genome[1]);
+	return GENOME_HEADER_SIZE + sizeof(T) + cognitive_nodes * (GENOME_NODE_VALUES * sizeof(T) + 1);
+}
+
+template<typename T>
+std::size_t BasicNeuralNetwork<T>::genomeHeaderSize()
+{
+	return GENOME_HEADER_SIZE;
+}
+
+/*At most MAXNODES cognitive nodes, and as many context flags set as the context node count*/
+template<typename T>
+bool BasicNeuralNetwork<T>::isValidGenome(const char* genome)
+{
+	int cognitive_nodes = static_cast<unsigned char>(genome[1]);
+	if (cognitive_nodes > MAXNODES) return false;
+	
+	int context_nodes = 0;
+	const char* flag = genome + GENOME_HEADER_SIZE + sizeof(T) + GENOME_NODE_VALUES * sizeof(T);
+	for (int i=0; i<cognitive_nodes; ++i, flag += GENOME_NODE_VALUES * sizeof(T) + 1) {
+		if (*flag != 0) context_nodes++;
+	}
+	return context_nodes == static_cast<unsigned char>(genome[2]);
+}
+
 /*Returns true if both neuralnetworks have the exact same structures and values, false otherwise*/
-bool NeuralNetwork::operator==(const NeuralNetwork& nn)
+template<typename T>
+bool BasicNeuralNetwork<T>::operator==(const BasicNeuralNetwork& nn)
 {
 	return getContextNodeCount() == nn.getContextNodeCount()
 		and getCognitiveNodeCount() == nn.getCognitiveNodeCount()
@@ -350,11 +638,29 @@ bool NeuralNetwork::operator==(const NeuralNetwork& nn)
 		and link_weights_from_self_payoff == nn.link_weights_from_self_payoff
 		and link_weights_from_other_payoff == nn.link_weights_from_other_payoff
 		and link_weights_from_inner_nodes == nn.link_weights_from_inner_nodes
-		and std::equal(inner_nodes.begin(), inner_nodes.end(), nn.inner_nodes.begin(), 
-               [](InnerNode* left, InnerNode* right){ return *left == *right; });
+		and inner_nodes == nn.inner_nodes;
 }
 
-bool NeuralNetwork::operator!=(const NeuralNetwork& nn)
+template<typename T>
+bool BasicNeuralNetwork<T>::operator!=(const BasicNeuralNetwork& nn)
 {
 	return not operator==(nn);
 }
+
+
+/**---------- Available precisions ----------**/
+
+template<> const char* BasicNeuralNetwork<double>::precisionName() { return "double"; }
+template<> const char* BasicNeuralNetwork<float>::precisionName() { return "float"; }
+template<> const char* BasicNeuralNetwork<Fixed16>::precisionName() { return "fixed (Q7.8)"; }
+
+template double sigmoidalSquash<double>(double value, double threshold);
+template float sigmoidalSquash<float>(float value, float threshold);
+
+template class BasicInnerNode<double>;
+template class BasicInnerNode<float>;
+template class BasicInnerNode<Fixed16>;
+
+template class BasicNeuralNetwork<double>;
+template class BasicNeuralNetwork<float>;
+template class BasicNeuralNetwork<Fixed16>;
@@ -2,6 +2,8 @@
 
 void testInnerNodes();
 void testNetwork();
+void testPrecisions();
+void testStates();
 
 void testNeuralNetwork()
 {
@@ -9,6 +11,8 @@ void testNeuralNetwork()
 	
 	testInnerNodes();
 	testNetwork();
+	testPrecisions();
+	testStates();
 	
 	std::cout << " done!" << std::endl;
 }	
@@ -18,14 +22,18 @@ void testInnerNodes()
 	///InnerNode class construction
 	numval input = RNG::getRandomNumval();
 	numval threshold = RNG::getRandomNumval();
+	numval context_value = RNG::getRandomNumval();
+	numval unused_context = context_value;
 	InnerNode node(threshold);
-	assert(node(input) == sigmoidalSquash(input, threshold));
+	assert(node(input, unused_context) == sigmoidalSquash(input, threshold));
+	assert(unused_context == context_value);
 	
-	///InnerNode context addition
-	numval context_value = RNG::getRandomNumval();
+	///InnerNode context addition (the context value is updated with the output)
 	numval link_weight = RNG::getRandomNumval();
-	node.addContextNode(context_value, link_weight);
-	assert(node(input) == sigmoidalSquash(input + (context_value * link_weight), threshold));
+	node.addContextNode(link_weight);
+	numval expected = sigmoidalSquash(input + (context_value * link_weight), threshold);
+	assert(node(input, context_value) == expected);
+	assert(context_value == expected);
 	
 	///InnerNode copy
 	InnerNode node2(node);
@@ -33,7 +41,7 @@ void testInnerNodes()
 	
 	///InnerNode context removal
 	node.removeContextNode();
-	assert(node(input) == sigmoidalSquash(input, threshold));
+	assert(node(input, context_value) == sigmoidalSquash(input, threshold));
 	
 	///InnerNode squashing function
 	numval max = std::numeric_limits<numval>::max();
@@ -41,13 +49,15 @@ void testInnerNodes()
 	numval low = std::numeric_limits<numval>::lowest();
 	
 	InnerNode node3(max);
-	node3.addContextNode(max, max);
-	numval result = node3(max);
+	node3.addContextNode(max);
+	numval max_context = max;
+	numval result = node3(max, max_context);
 	assert(result >= 0 and  result <= 1);
 	
 	node3.removeContextNode();
-	node3.addContextNode(min, low);
-	result = node3(max);
+	node3.addContextNode(low);
+	numval min_context = min;
+	result = node3(max, min_context);
 	assert(result >= 0 and  result <= 1);
 }
 
@@ -85,6 +95,15 @@ void testNetwork()
 	}
 	assert(abs(nn2_cooperations - nn_cooperations) < 55); //prob. of different results is weak
 	
+	///Copy assignment (reuses the network, context values are not inherited)
+	NeuralNetwork nn_assigned;
+	nn_assigned = nn;
+	assert(nn_assigned == nn);
+	assert(nn_assigned.hash() == nn2.hash());
+	for (numval context_value : nn_assigned.getCarryoverState().context_values) {
+		assert(context_value == 0);
+	}
+	
 	///Node removal
 	innNodes = MAXNODES*2;
 	for (int i=0; i<MAXNODES*2 and innNodes>0; ++i) {
@@ -130,3 +149,68 @@ void testNetwork()
 	assert(defaultCollab < 575); 
 	assert(otherCollab < 575);
 }
+
+void testPrecisions()
+{
+	///Fixed16 conversions and saturation
+	assert(static_cast<double>(Fixed16(1.5)) == 1.5);
+	assert(static_cast<double>(Fixed16(-0.25)) == -0.25);
+	assert(Fixed16(1000.0) == Fixed16::fromRaw(std::numeric_limits<std::int16_t>::max()));
+	assert(Fixed16(100.0) + Fixed16(100.0) == Fixed16(1000.0));
+	assert(Fixed16(-100.0) - Fixed16(100.0) == Fixed16(-1000.0));
+	assert(Fixed16(2.0) * Fixed16(-0.5) == Fixed16(-1.0));
+	
+	///Reduced precision squashing functions stay close to double precision
+	for (int i=0; i<100; ++i) {
+		numval value = RNG::getRandomNumval() * 10;
+		numval threshold = RNG::getRandomNumval();
+		numval reference = sigmoidalSquash(value, threshold);
+		
+		float float_result = sigmoidalSquash(static_cast<float>(value), static_cast<float>(threshold));
+		assert(std::fabs(float_result - reference) < 1e-6);
+		
+		Fixed16 fixed_result = sigmoidalSquash(Fixed16(value), Fixed16(threshold));
+		assert(std::fabs(static_cast<double>(fixed_result) - reference) < 0.01);
+	}
+	
+	///Reduced precision networks behave like double precision networks
+	FloatNeuralNetwork float_nn;
+	FixedNeuralNetwork fixed_nn;
+	for (int i=0; i<20; ++i) {
+		float_nn.mutate();
+		fixed_nn.mutate();
+	}
+	FixedNeuralNetwork fixed_copy(fixed_nn);
+	assert(fixed_copy == fixed_nn);
+	assert(fixed_copy.hash() == fixed_nn.hash());
+	
+	float float_prob = float_nn.getCooperationProbability(3, 1);
+	Fixed16 fixed_prob = fixed_nn.getCooperationProbability(3, 1);
+	assert(float_prob >= 0 and float_prob <= 1);
+	assert(fixed_prob >= Fixed16(0.0) and fixed_prob <= Fixed16(1.0));
+}
+
+void testStates()
+{
+	///A network with context nodes
+	NeuralNetwork nn;
+	while (nn.getContextNodeCount() == 0) nn.addNode();
+	NeuralNetwork::State initial_state = nn.createState();
+	
+	///Explicit states evolve like the carryover state, without changing the network
+	NeuralNetwork::State state = nn.createState();
+	NeuralNetwork::State other_state = nn.createState();
+	for (int i=0; i<10; ++i) {
+		numval state_prob = nn.getCooperationProbability(7, 6, state);
+		if (i == 0) assert(nn.createState().context_values == initial_state.context_values);
+		assert(state_prob == nn.getCooperationProbability(7, 6));
+	}
+	assert(state.context_values == nn.getCarryoverState().context_values);
+	assert(other_state.context_values == initial_state.context_values);
+	
+	///States are independent of each other
+	NeuralNetwork::State state_copy = state;
+	nn.getCooperationProbability(0, 5, other_state);
+	assert(state.context_values == state_copy.context_values);
+	assert(nn.getCarryoverState().context_values == state_copy.context_values);
+}
@@ -0,0 +1,227 @@
+#include "Profiler.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+
+/*Values read from a counter (read_format TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING)*/
+struct CounterReading
+{
+	std::uint64_t value;
+	std::uint64_t time_enabled;
+	std::uint64_t time_running;
+};
+
+static const std::uint64_t counter_configs[PROFILE_COUNTER_COUNT] = {
+	PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+};
+
+
+void PhaseCounters::add(const PhaseCounters& other)
+{
+	for (int counter=0; counter<PROFILE_COUNTER_COUNT; ++counter) {
+		counters[counter] += other.counters[counter];
+	}
+	seconds += other.seconds;
+	allocations += other.allocations;
+	allocated_bytes += other.allocated_bytes;
+	peak_live_bytes = std::max(peak_live_bytes, other.peak_live_bytes);
+}
+
+double PhaseCounters::instructionsPerCycle() const
+{
+	double cycles = counters[PROFILE_COUNTER_CYCLES];
+	return (cycles > 0) ? counters[PROFILE_COUNTER_INSTRUCTIONS] / cycles : 0;
+}
+
+double PhaseCounters::missesPerKiloInstruction(int counter) const
+{
+	double instructions = counters[PROFILE_COUNTER_INSTRUCTIONS];
+	return (instructions > 0) ? 1000 * counters[counter] / instructions : 0;
+}
+
+
+/*Opens one counter per event, keeping only the wall clock time if any of them fails*/
+PhaseProfiler::PhaseProfiler()
+{
+	AllocationCounter::enable();
+	descriptors.fill(-1);
+	
+	for (int counter=0; counter<PROFILE_COUNTER_COUNT; ++counter) {
+		perf_event_attr attributes;
+		std::memset(&attributes, 0, sizeof(attributes));
+		attributes.size = sizeof(attributes);
+		attributes.type = PERF_TYPE_HARDWARE;
+		attributes.config = counter_configs[counter];
+		attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attributes.inherit = 1; //count the threads created afterwards
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		
+		long descriptor = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+		if (descriptor < 0) {
+			unavailable_reason = std::string("perf_event_open: ") + std::strerror(errno);
+			break;
+		}
+		descriptors[counter] = static_cast<int>(descriptor);
+	}
+	counters_available = unavailable_reason.empty();
+	
+	if (not counters_available) {
+		for (int& descriptor : descriptors) {
+			if (descriptor >= 0) close(descriptor);
+			descriptor = -1;
+		}
+	}
+}
+
+PhaseProfiler::~PhaseProfiler()
+{
+	for (int descriptor : descriptors) {
+		if (descriptor >= 0) close(descriptor);
+	}
+}
+
+/*Reads every counter, scaled by the share of time it was scheduled on the PMU*/
+void PhaseProfiler::readCounters(std::array<double, PROFILE_COUNTER_COUNT>& values) const
+{
+	for (int counter=0; counter<PROFILE_COUNTER_COUNT; ++counter) {
+		CounterReading reading = {0, 0, 0};
+		if (counters_available and read(descriptors[counter], &reading, sizeof(reading)) == sizeof(reading) 
+			and reading.time_running > 0)
+			values[counter] = static_cast<double>(reading.value) 
+				* (static_cast<double>(reading.time_enabled) / static_cast<double>(reading.time_running));
+		else
+			values[counter] = 0;
+	}
+}
+
+void PhaseProfiler::begin(int phase)
+{
+	assert(current_phase < 0 and phase >= 0 and phase < PROFILE_PHASE_COUNT);
+	
+	current_phase = phase;
+	readCounters(phase_start_counters);
+	AllocationCounter::resetPeak();
+	phase_start_allocations = AllocationCounter::read();
+	phase_start_time = std::chrono::steady_clock::now();
+}
+
+void PhaseProfiler::end()
+{
+	assert(current_phase >= 0);
+	
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - phase_start_time;
+	AllocationStats allocations = AllocationCounter::read();
+	std::array<double, PROFILE_COUNTER_COUNT> values;
+	readCounters(values);
+	
+	PhaseCounters measured;
+	for (int counter=0; counter<PROFILE_COUNTER_COUNT; ++counter) {
+		measured.counters[counter] = values[counter] - phase_start_counters[counter];
+	}
+	measured.seconds = elapsed.count();
+	measured.allocations = static_cast<double>(allocations.allocations - phase_start_allocations.allocations);
+	measured.allocated_bytes = static_cast<double>(allocations.bytes - phase_start_allocations.bytes);
+	measured.peak_live_bytes = static_cast<double>(allocations.peak_live_bytes);
+	
+	generation_phases[current_phase].add(measured);
+	totals[current_phase].add(measured);
+	current_phase = -1;
+}
+
+void PhaseProfiler::endGeneration()
+{
+	generations.push_back(generation_phases);
+	generation_phases = std::array<PhaseCounters, PROFILE_PHASE_COUNT>();
+}
+
+bool PhaseProfiler::countersAvailable() const
+{
+	return counters_available;
+}
+
+const std::vector<std::array<PhaseCounters, PROFILE_PHASE_COUNT>>& PhaseProfiler::getGenerations() const
+{
+	return generations;
+}
+
+const std::array<PhaseCounters, PROFILE_PHASE_COUNT>& PhaseProfiler::getTotals() const
+{
+	return totals;
+}
+
+/*Writes the phases of each generation as an octave matrix, followed by the totals of the run*/
+void PhaseProfiler::write(std::ostream& output) const
+{
+	output << "# PROFILE columns are, for each phase (";
+	for (int phase=0; phase<PROFILE_PHASE_COUNT; ++phase) {
+		output << (phase > 0 ? ", " : "") << phaseName(phase);
+	}
+	output << "): [seconds, instructions per cycle, cache misses per 1000 instructions, branch misses per 1000 instructions, "
+		<< "allocations, allocated bytes]\n";
+	if (not counters_available)
+		output << "# PROFILE hardware counters unavailable (" << unavailable_reason << "), wall clock time only\n";
+	if (not AllocationCounter::isCompiled())
+		output << "# PROFILE allocations are not counted (build bin/Cooperation-allocations with \"make allocations\")\n";
+	
+	output << "# name: profile\n";
+	output << "# type: matrix\n";
+	output << "# rows: " << generations.size() << "\n";
+	output << "# columns: " << PROFILE_COLUMNS_PER_PHASE * PROFILE_PHASE_COUNT << "\n";
+	for (const std::array<PhaseCounters, PROFILE_PHASE_COUNT>& generation : generations) {
+		for (const PhaseCounters& phase : generation) {
+			output << phase.seconds << " " << phase.instructionsPerCycle() << " " 
+				<< phase.missesPerKiloInstruction(PROFILE_COUNTER_CACHE_MISSES) << " " 
+				<< phase.missesPerKiloInstruction(PROFILE_COUNTER_BRANCH_MISSES) << " " 
+				<< phase.allocations << " " << phase.allocated_bytes << " ";
+		}
+		output << "\n";
+	}
+	output << "\n";
+	
+	for (int phase=0; phase<PROFILE_PHASE_COUNT; ++phase) {
+		const PhaseCounters& total = totals[phase];
+		output << "# PROFILE " << phaseName(phase) << ": " << total.seconds << " s";
+		if (counters_available) {
+			output << ", " << total.counters[PROFILE_COUNTER_CYCLES] << " cycles, " 
+				<< total.counters[PROFILE_COUNTER_INSTRUCTIONS] << " instructions, IPC " << total.instructionsPerCycle() 
+				<< ", cache misses " << total.missesPerKiloInstruction(PROFILE_COUNTER_CACHE_MISSES) << "/1000 instructions"
+				<< ", branch misses " << total.missesPerKiloInstruction(PROFILE_COUNTER_BRANCH_MISSES) << "/1000 instructions";
+		}
+		if (AllocationCounter::isCompiled()) {
+			output << ", " << total.allocations << " allocations (" << total.allocated_bytes << " bytes), peak heap " 
+				<< total.peak_live_bytes << " bytes";
+		}
+		output << "\n";
+	}
+}
+
+const char* PhaseProfiler::phaseName(int phase)
+{
+	switch (phase) {
+		case PROFILE_PHASE_TOURNAMENT: return "tournament";
+		case PROFILE_PHASE_ASSESSMENT: return "assessment";
+		case PROFILE_PHASE_SELECTION: return "selection";
+		case PROFILE_PHASE_OUTPUT: return "output";
+		default: return "unknown";
+	}
+}
+
+
+ProfiledPhase::ProfiledPhase(PhaseProfiler* phase_profiler, int phase):
+	profiler(phase_profiler)
+{
+	if (profiler) profiler->begin(phase);
+}
+
+ProfiledPhase::~ProfiledPhase()
+{
+	if (profiler) profiler->end();
+}
@@ -0,0 +1,66 @@
+#include "ProfilerTest.hpp"
+
+
+void testProfiler()
+{
+	std::cout << "Testing Profiler...";
+	
+	///Counter ratios
+	PhaseCounters counters;
+	assert(counters.instructionsPerCycle() == 0);
+	counters.counters[PROFILE_COUNTER_CYCLES] = 1000;
+	counters.counters[PROFILE_COUNTER_INSTRUCTIONS] = 2000;
+	counters.counters[PROFILE_COUNTER_BRANCH_MISSES] = 10;
+	assert(counters.instructionsPerCycle() == 2);
+	assert(counters.missesPerKiloInstruction(PROFILE_COUNTER_BRANCH_MISSES) == 5);
+	
+	///Phases are measured per generation and in total, with or without hardware counters
+	PhaseProfiler profiler;
+	volatile double sink = 0;
+	for (int generation=0; generation<PROFILER_TEST_GENERATIONS; ++generation) {
+		{
+			ProfiledPhase phase(&profiler, PROFILE_PHASE_TOURNAMENT);
+			for (int i=0; i<100000; ++i) sink = sink + i;
+		}
+		{
+			ProfiledPhase phase(&profiler, PROFILE_PHASE_SELECTION);
+		}
+		profiler.endGeneration();
+	}
+	
+	assert(profiler.getGenerations().size() == PROFILER_TEST_GENERATIONS);
+	double tournament_seconds = 0;
+	for (const std::array<PhaseCounters, PROFILE_PHASE_COUNT>& generation : profiler.getGenerations()) {
+		assert(generation[PROFILE_PHASE_TOURNAMENT].seconds > 0);
+		assert(generation[PROFILE_PHASE_ASSESSMENT].seconds == 0);
+		if (profiler.countersAvailable()) assert(generation[PROFILE_PHASE_TOURNAMENT].counters[PROFILE_COUNTER_INSTRUCTIONS] > 0);
+		else assert(generation[PROFILE_PHASE_TOURNAMENT].counters[PROFILE_COUNTER_INSTRUCTIONS] == 0);
+		tournament_seconds += generation[PROFILE_PHASE_TOURNAMENT].seconds;
+	}
+	assert(profiler.getTotals()[PROFILE_PHASE_TOURNAMENT].seconds == tournament_seconds);
+	
+	///A null profiler measures nothing
+	{
+		ProfiledPhase phase(nullptr, PROFILE_PHASE_OUTPUT);
+	}
+	
+	///Allocations are counted within phases when the allocator is replaced
+	if (AllocationCounter::isCompiled()) {
+		PhaseProfiler allocation_profiler;
+		{
+			ProfiledPhase phase(&allocation_profiler, PROFILE_PHASE_OUTPUT);
+			delete[] new int[PROFILER_TEST_ALLOCATION_SIZE];
+		}
+		allocation_profiler.endGeneration();
+		const PhaseCounters& output_phase = allocation_profiler.getTotals()[PROFILE_PHASE_OUTPUT];
+		assert(output_phase.allocations == 1);
+		assert(output_phase.allocated_bytes == PROFILER_TEST_ALLOCATION_SIZE * sizeof(int));
+	}
+	
+	///Results are written as a matrix with one row per generation
+	std::ostringstream output;
+	profiler.write(output);
+	assert(output.str().find("# rows: " + std::to_string(PROFILER_TEST_GENERATIONS)) != std::string::npos);
+	
+	std::cout << " done!" << std::endl;
+}
@@ -2,33 +2,66 @@
 
 
 /*Static members*/
-unsigned RNG::seed = std::random_device()();
+unsigned long long RNG::seed = std::random_device()();
 bool RNG::seed_is_random = true;
-std::mt19937_64 RNG::generator = std::mt19937_64(seed);
+thread_local std::mt19937_64 RNG::generator = std::mt19937_64(seed);
 
 //uniform int distribution [0, 1]
-std::uniform_int_distribution<int> RNG::distribution_bool = std::uniform_int_distribution<int>(0,1);
+thread_local std::uniform_int_distribution<int> RNG::distribution_bool = std::uniform_int_distribution<int>(0,1);
 
 //uniform double distribution [0, 1[
-std::uniform_real_distribution<double> RNG::distribution_probabilities = std::uniform_real_distribution<double>(0, 1);
+thread_local std::uniform_real_distribution<double> RNG::distribution_probabilities = std::uniform_real_distribution<double>(0, 1);
 
 //normal distribution with mean NUMVAL_MEAN and standard deviation NUMVAL_STDDEV
-std::normal_distribution<double> RNG::distribution_numvals = std::normal_distribution<double>(NUMVAL_MEAN, NUMVAL_STDDEV);
+thread_local std::normal_distribution<double> RNG::distribution_numvals = std::normal_distribution<double>(NUMVAL_MEAN, NUMVAL_STDDEV);
 
 //uniform int distribution [0, MAXINITIALNODES]
-std::uniform_int_distribution<int> RNG::distribution_initial_nodes = std::uniform_int_distribution<int>(0,MAXINITIALNODES);
+thread_local std::uniform_int_distribution<int> RNG::distribution_initial_nodes = std::uniform_int_distribution<int>(0,MAXINITIALNODES);
 
 //negative binomial distribution with stop count ROUND_ITERATIONS_STOP_COUNT and probability ROUND_ITERATIONS_MEAN_PROB
-std::negative_binomial_distribution<int> RNG::distribution_iterations = std::negative_binomial_distribution<int>(ROUND_ITERATIONS_STOP_COUNT, ROUND_ITERATIONS_MEAN_PROB);
+thread_local std::negative_binomial_distribution<int> RNG::distribution_iterations = std::negative_binomial_distribution<int>(ROUND_ITERATIONS_STOP_COUNT, ROUND_ITERATIONS_MEAN_PROB);
 
 /*If called at all, this function should be called before any of the following functions.*/
-void RNG::setSeed(unsigned new_seed) {
+void RNG::setSeed(unsigned long long new_seed) {
 	seed = new_seed;
 	seed_is_random = false;
 	generator.seed(seed);
+	
+	//discard values cached by distributions, so that a seed gives the same values after previous runs
+	distribution_numvals.reset();
+	distribution_iterations.reset();
 }
 
-long long int RNG::getSeed() {
+/*
+Streams are independent of each other and reproducible for a given seed and stream number.
+The high half of the seed is only added when it is set, so that 32-bit seeds keep their streams.*/
+void RNG::setStream(unsigned long long stream) {
+	std::array<unsigned, 4> values;
+	std::size_t count = 0;
+	values[count++] = static_cast<unsigned>(seed);
+	if (seed >> 32) values[count++] = static_cast<unsigned>(seed >> 32);
+	values[count++] = static_cast<unsigned>(stream);
+	values[count++] = static_cast<unsigned>(stream >> 32);
+	std::seed_seq sequence(values.begin(), values.begin() + count);
+	generator.seed(sequence);
+	
+	//discard values cached by distributions from the previous stream
+	distribution_numvals.reset();
+	distribution_iterations.reset();
+}
+
+const std::mt19937_64& RNG::getGenerator() {
+	return generator;
+}
+
+/*Copying a state is much faster than seeding a stream, for streams restarted many times*/
+void RNG::setGenerator(const std::mt19937_64& state) {
+	generator = state;
+	distribution_numvals.reset();
+	distribution_iterations.reset();
+}
+
+unsigned long long RNG::getSeed() {
 	return seed;
 }
 
@@ -50,6 +83,10 @@ int RNG::getRandomInt(int rangeStart, int rangeStop) {
 	return distribution_int(generator);
 }
 
+double RNG::getRandomProbability() {
+	return distribution_probabilities(generator);
+}
+
 double RNG::getRandomNumval() {
 	return distribution_numvals(generator);
 }
@@ -64,3 +101,32 @@ int RNG::getIterationCount() {
 	
 	return iterations;
 }
+
+/*
+getIterationCount adds iterations while the negative binomial draw is 0, which happens with probability
+c = p^k, so the count is geometric: P(count > n) = c^n. The count of tail probability t is then
+1 + floor(log(t) / log(c)), so that t and 1 - t give antithetic counts.*/
+int RNG::getIterationCountAt(double tail_probability) {
+	double tail = std::max(tail_probability, std::numeric_limits<double>::min()); //finite count for t = 0
+	double continuation_log = ROUND_ITERATIONS_STOP_COUNT * std::log(ROUND_ITERATIONS_MEAN_PROB);
+	double iterations = 1 + std::floor(std::log(tail) / continuation_log);
+	if (iterations >= static_cast<double>(std::numeric_limits<int>::max())) return std::numeric_limits<int>::max();
+	return static_cast<int>(iterations);
+}
+
+/*Mean of the geometric count 1 / (1 - c), see getIterationCountAt*/
+double RNG::getMeanIterationCount() {
+	return 1 / (1 - std::pow(ROUND_ITERATIONS_MEAN_PROB, ROUND_ITERATIONS_STOP_COUNT));
+}
+
+/*Inverts the geometric distribution with a single uniform draw: floor(log(U) / log(1 - p)).
+Returns the largest long if the trials never succeed.*/
+long RNG::getGeometricSkip(double probability) {
+	if (probability >= 1) return 0;
+	if (probability <= 0) return std::numeric_limits<long>::max();
+	
+	double uniform = 1 - distribution_probabilities(generator); //in ]0, 1]
+	double skip = std::floor(std::log(uniform) / std::log1p(-probability));
+	if (skip >= static_cast<double>(std::numeric_limits<long>::max())) return std::numeric_limits<long>::max();
+	return static_cast<long>(skip);
+}
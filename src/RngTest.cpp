@@ -29,6 +29,16 @@ void testRng()
 	avg_iterations /= SAMPLE_SIZE;
 	assert(fabs(avg_iterations - ITERATIONS_GOAL) < ITERATIONS_DIFF);
 	
+	//counts of evenly spaced tail probabilities have the same mean (without drawing)
+	assert(fabs(RNG::getMeanIterationCount() - ITERATIONS_GOAL) < ITERATIONS_DIFF);
+	assert(RNG::getIterationCountAt(1) == 1 and RNG::getIterationCountAt(0) > RNG::getIterationCountAt(0.5));
+	double avg_quantile_iterations = 0;
+	for (int i=0; i<SAMPLE_SIZE; ++i) {
+		avg_quantile_iterations += RNG::getIterationCountAt((i + 0.5) / SAMPLE_SIZE);
+	}
+	avg_quantile_iterations /= SAMPLE_SIZE;
+	assert(fabs(avg_quantile_iterations - RNG::getMeanIterationCount()) < ITERATIONS_DIFF);
+	
 	///Numeric values
 	double avg_numval = 0;
 	for (int i=0; i<SAMPLE_SIZE; ++i) {
@@ -37,6 +47,25 @@ void testRng()
 	avg_numval /= SAMPLE_SIZE;
 	assert(fabs(avg_numval - NUMVAL_GOAL) < NUMVAL_DIFF);
 	
+	///Seeding gives the same values whatever was drawn before
+	unsigned seed = static_cast<unsigned>(RNG::getRandomInt(0, std::numeric_limits<int>::max()));
+	RNG::setSeed(seed);
+	double first_numval = RNG::getRandomNumval();
+	int first_iterations = RNG::getIterationCount();
+	RNG::setSeed(seed);
+	assert(RNG::getRandomNumval() == first_numval and RNG::getIterationCount() == first_iterations);
+	
+	//every bit of a 64-bit seed counts
+	RNG::setSeed((1ULL << 32) + seed);
+	assert(RNG::getSeed() == (1ULL << 32) + seed);
+	assert(RNG::getRandomNumval() != first_numval);
+	
+	//a saved state restarts the same draws
+	std::mt19937_64 saved_state = RNG::getGenerator();
+	double first_probability = RNG::getRandomProbability();
+	RNG::setGenerator(saved_state);
+	assert(RNG::getRandomProbability() == first_probability);
+	
 	///Population selection
 	std::array<double, SAMPLE_SIZE> fitness;
 	std::array<int, SAMPLE_SIZE> selected_pop;
@@ -0,0 +1,279 @@
+#include "Shard.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+/*Tiles of SHARD_TILE_SIZE individuals per side, skipping those below the diagonal*/
+std::vector<ShardTile> shardTiles(int population_size)
+{
+	std::vector<ShardTile> tiles;
+	for (int row=0; row<population_size; row+=SHARD_TILE_SIZE) {
+		for (int col=row; col<population_size; col+=SHARD_TILE_SIZE) {
+			ShardTile tile;
+			tile.row_begin = row;
+			tile.row_end = std::min(row + SHARD_TILE_SIZE, population_size);
+			tile.col_begin = col;
+			tile.col_end = std::min(col + SHARD_TILE_SIZE, population_size);
+			tiles.push_back(tile);
+		}
+	}
+	return tiles;
+}
+
+std::unique_ptr<ShardChannel> ShardChannel::create(const std::string& transport)
+{
+	if (transport == "socket") return std::unique_ptr<ShardChannel>(new SocketChannel());
+	if (transport == "shm") return std::unique_ptr<ShardChannel>(new SharedMemoryChannel());
+	throw std::runtime_error("Shard: unknown transport " + transport + " (socket or shm)");
+}
+
+
+/**---------- UNIX sockets ----------**/
+
+SocketChannel::SocketChannel()
+{
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+		throw std::runtime_error(std::string("Shard: cannot create sockets: ") + std::strerror(errno));
+}
+
+SocketChannel::~SocketChannel()
+{
+	for (int socket : sockets) {
+		if (socket >= 0) close(socket);
+	}
+}
+
+/*Closes the other side's end, so that either process sees the end of the stream if the other exits*/
+void SocketChannel::selectSide(bool worker, pid_t)
+{
+	int other = worker ? 0 : 1;
+	close(sockets[other]);
+	sockets[other] = -1;
+	own_socket = sockets[1 - other];
+}
+
+void SocketChannel::send(const void* data, std::size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	while (size > 0) {
+		ssize_t sent = ::send(own_socket, bytes, size, MSG_NOSIGNAL);
+		if (sent < 0 and errno == EINTR) continue;
+		if (sent <= 0)
+			throw std::runtime_error(std::string("Shard: cannot send: ") + std::strerror(errno));
+		bytes += sent;
+		size -= static_cast<std::size_t>(sent);
+	}
+}
+
+void SocketChannel::receive(void* data, std::size_t size)
+{
+	char* bytes = static_cast<char*>(data);
+	while (size > 0) {
+		ssize_t received = recv(own_socket, bytes, size, 0);
+		if (received < 0 and errno == EINTR) continue;
+		if (received == 0)
+			throw std::runtime_error("Shard: the other process closed the channel");
+		if (received < 0)
+			throw std::runtime_error(std::string("Shard: cannot receive: ") + std::strerror(errno));
+		bytes += received;
+		size -= static_cast<std::size_t>(received);
+	}
+}
+
+
+/**---------- Shared memory ----------**/
+
+/*Maps both mailboxes, shared with the processes forked afterwards; each outbox starts empty*/
+SharedMemoryChannel::SharedMemoryChannel()
+{
+	void* address = mmap(nullptr, 2 * sizeof(Mailbox), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (address == MAP_FAILED)
+		throw std::runtime_error(std::string("Shard: cannot map shared memory: ") + std::strerror(errno));
+	mailboxes = static_cast<Mailbox*>(address);
+
+	for (int box=0; box<2; ++box) {
+		if (sem_init(&mailboxes[box].filled, 1, 0) != 0 or sem_init(&mailboxes[box].emptied, 1, 1) != 0) {
+			munmap(mailboxes, 2 * sizeof(Mailbox));
+			throw std::runtime_error(std::string("Shard: cannot create semaphores: ") + std::strerror(errno));
+		}
+		mailboxes[box].size = 0;
+	}
+}
+
+/*Each process unmaps its own view (the semaphores are destroyed with the last mapping)*/
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+	munmap(mailboxes, 2 * sizeof(Mailbox));
+}
+
+void SharedMemoryChannel::selectSide(bool worker, pid_t peer_process)
+{
+	outbox = &mailboxes[worker ? 1 : 0];
+	inbox = &mailboxes[worker ? 0 : 1];
+	worker_side = worker;
+	peer = peer_process;
+}
+
+/*
+The coordinator reaps an exited worker (ShardPool then no longer waits for it), and a worker whose
+coordinator exited has been adopted by another parent.*/
+bool SharedMemoryChannel::peerExited()
+{
+	if (worker_side) return getppid() != peer;
+	
+	pid_t result = waitpid(peer, nullptr, WNOHANG);
+	return result == peer or (result < 0 and errno == ECHILD);
+}
+
+/*Waits on a semaphore, resuming after signals and checking the other process at every timeout*/
+void SharedMemoryChannel::waitSemaphore(sem_t* semaphore)
+{
+	while (true) {
+		timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_nsec += SHARD_SHM_PEER_CHECK_MS * 1000000L;
+		deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+		deadline.tv_nsec %= 1000000000L;
+		
+		if (sem_timedwait(semaphore, &deadline) == 0) return;
+		if (errno == ETIMEDOUT) {
+			if (peerExited()) throw std::runtime_error("Shard: the other process exited");
+		}
+		else if (errno != EINTR) {
+			throw std::runtime_error(std::string("Shard: cannot wait on semaphore: ") + std::strerror(errno));
+		}
+	}
+}
+
+/*Writes the data chunk by chunk, each once the previous one has been read*/
+void SharedMemoryChannel::send(const void* data, std::size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	while (size > 0) {
+		std::size_t chunk = std::min(size, static_cast<std::size_t>(SHARD_SHM_CAPACITY));
+		waitSemaphore(&outbox->emptied);
+		std::memcpy(outbox->data, bytes, chunk);
+		outbox->size = chunk;
+		sem_post(&outbox->filled);
+
+		bytes += chunk;
+		size -= chunk;
+	}
+}
+
+/*Reads the data from as many chunks as needed, a chunk may also hold the start of the next message*/
+void SharedMemoryChannel::receive(void* data, std::size_t size)
+{
+	char* bytes = static_cast<char*>(data);
+	while (size > 0) {
+		if (not reading) {
+			waitSemaphore(&inbox->filled);
+			read_offset = 0;
+			reading = true;
+		}
+
+		std::size_t copied = std::min(size, inbox->size - read_offset);
+		std::memcpy(bytes, inbox->data + read_offset, copied);
+		read_offset += copied;
+		bytes += copied;
+		size -= copied;
+
+		if (read_offset == inbox->size) {
+			reading = false;
+			sem_post(&inbox->emptied);
+		}
+	}
+}
+
+
+/**---------- Worker processes ----------**/
+
+/*
+Forks one process per shard. Pending output is flushed first so that it is not written twice, and
+workers exit without running destructors or atexit handlers, which belong to the coordinator.*/
+ShardPool::ShardPool(unsigned shard_count, const std::string& transport,
+	const std::function<void(unsigned, ShardChannel&)>& worker)
+{
+	std::cout.flush();
+	std::cerr.flush();
+
+	try {
+		startWorkers(shard_count, transport, worker);
+	}
+	catch (const std::exception&) {
+		stopWorkers();
+		throw;
+	}
+}
+
+void ShardPool::startWorkers(unsigned shard_count, const std::string& transport,
+	const std::function<void(unsigned, ShardChannel&)>& worker)
+{
+	for (unsigned shard=0; shard<shard_count; ++shard) {
+		channels.push_back(ShardChannel::create(transport));
+
+		pid_t pid = fork();
+		if (pid < 0)
+			throw std::runtime_error(std::string("Shard: cannot fork a worker: ") + std::strerror(errno));
+
+		if (pid == 0) {
+			//the channels of the previous workers belong to the coordinator
+			for (unsigned previous=0; previous<shard; ++previous) {
+				channels[previous].reset();
+			}
+			int status = 0;
+			try {
+				channels[shard]->selectSide(true, getppid());
+				worker(shard, *channels[shard]);
+			}
+			catch (const std::exception& error) {
+				std::cerr << "Error: shard " << shard << ": " << error.what() << std::endl;
+				status = 1;
+			}
+			_exit(status);
+		}
+
+		channels[shard]->selectSide(false, pid);
+		workers.push_back(pid);
+	}
+}
+
+ShardPool::~ShardPool()
+{
+	stopWorkers();
+}
+
+/*Sends the stop command to every worker, then waits for them to exit*/
+void ShardPool::stopWorkers()
+{
+	for (unsigned shard=0; shard<workers.size(); ++shard) {
+		try {
+			channels[shard]->sendValue<std::uint32_t>(SHARD_COMMAND_STOP);
+		}
+		catch (const std::exception&) {
+			//the worker already exited
+		}
+	}
+	for (pid_t worker : workers) {
+		waitpid(worker, nullptr, 0);
+	}
+	workers.clear();
+}
+
+unsigned ShardPool::size() const
+{
+	return static_cast<unsigned>(channels.size());
+}
+
+ShardChannel& ShardPool::getChannel(unsigned shard)
+{
+	return *channels.at(shard);
+}
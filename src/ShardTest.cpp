@@ -0,0 +1,108 @@
+#include "ShardTest.hpp"
+
+
+/*Sends back every message it receives, incremented by one more than its shard index, until stopped*/
+static void echoWorker(unsigned shard, ShardChannel& channel)
+{
+	while (channel.receiveValue<std::uint32_t>() == SHARD_COMMAND_PLAY) {
+		std::vector<char> message(channel.receiveValue<std::uint64_t>());
+		channel.receive(message.data(), message.size());
+		for (char& byte : message) {
+			byte = static_cast<char>(byte + 1 + static_cast<int>(shard));
+		}
+		channel.send(message.data(), message.size());
+	}
+}
+
+/*Exits as soon as it starts, like a worker that failed*/
+static void exitingWorker(unsigned, ShardChannel&)
+{
+	_exit(1);
+}
+
+/*Sends a small and a large message to every worker of a pool of the transport, and checks the replies*/
+static void testTransport(const std::string& transport)
+{
+	ShardPool pool(SHARD_TEST_WORKERS, transport, echoWorker);
+	assert(pool.size() == SHARD_TEST_WORKERS);
+	
+	for (std::size_t length : {static_cast<std::size_t>(3), static_cast<std::size_t>(SHARD_TEST_LARGE_MESSAGE)}) {
+		std::vector<char> message(length);
+		for (std::size_t i=0; i<length; ++i) {
+			message[i] = static_cast<char>(i % 100);
+		}
+		
+		for (unsigned shard=0; shard<pool.size(); ++shard) {
+			pool.getChannel(shard).sendValue<std::uint32_t>(SHARD_COMMAND_PLAY);
+			pool.getChannel(shard).sendValue<std::uint64_t>(length);
+			pool.getChannel(shard).send(message.data(), length);
+		}
+		for (unsigned shard=0; shard<pool.size(); ++shard) {
+			std::vector<char> reply(length);
+			pool.getChannel(shard).receive(reply.data(), length);
+			for (std::size_t i=0; i<length; ++i) {
+				assert(reply[i] == static_cast<char>(message[i] + 1 + static_cast<int>(shard)));
+			}
+		}
+	}
+}
+
+void testShard()
+{
+	std::cout << "Testing Shard...";
+	
+	///Tiles cover every pair exactly once
+	std::vector<std::vector<int>> covered(SHARD_TEST_POPULATION, std::vector<int>(SHARD_TEST_POPULATION, 0));
+	for (const ShardTile& tile : shardTiles(SHARD_TEST_POPULATION)) {
+		for (int a=tile.row_begin; a<tile.row_end; ++a) {
+			for (int b=std::max(a+1, tile.col_begin); b<tile.col_end; ++b) {
+				covered[a][b] += 1;
+			}
+		}
+	}
+	for (int a=0; a<SHARD_TEST_POPULATION; ++a) {
+		for (int b=0; b<SHARD_TEST_POPULATION; ++b) {
+			assert(covered[a][b] == (a < b ? 1 : 0));
+		}
+	}
+	
+	///Round trips with the workers
+	testTransport("socket");
+	testTransport("shm");
+	
+	///A worker that exited is noticed instead of waited for (and stopping the pool does not hang)
+	for (const std::string transport : {"socket", "shm"}) {
+		ShardPool pool(1, transport, exitingWorker);
+		bool noticed = false;
+		try {
+			pool.getChannel(0).receiveValue<std::uint32_t>();
+		}
+		catch (const std::runtime_error&) {
+			noticed = true;
+		}
+		assert(noticed);
+		
+		//the first message fits in the empty mailbox, the second one waits for it to be read
+		noticed = false;
+		try {
+			for (int message=0; message<2; ++message) {
+				pool.getChannel(0).sendValue<std::uint32_t>(SHARD_COMMAND_PLAY);
+			}
+		}
+		catch (const std::runtime_error&) {
+			noticed = true;
+		}
+		assert(noticed);
+	}
+	
+	bool rejected = false;
+	try {
+		ShardChannel::create("pipe");
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	assert(rejected);
+	
+	std::cout << " done!" << std::endl;
+}
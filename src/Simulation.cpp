@@ -1,42 +1,273 @@
 #include "Simulation.hpp"
 
+#include <stdexcept>
+
+static_assert(STRATEGIES_MAX <= MONITOR_MAX_STRATEGIES, "Simulation: the monitor cannot hold every strategy");
+
 
 /*Constructor*/
-Simulation::Simulation(const Payoffs& payoffs):
+template<typename Network>
+BasicSimulation<Network>::BasicSimulation(const Payoffs& payoffs, const SimulationSettings& sim_settings):
 	game_payoffs(payoffs), //use provided payoffs
-	strats(payoffs), //strategy evaluation class
+	settings(sim_settings), //use provided modes
+	strats(payoffs, sim_settings.extended_strategies ? Strategies::extendedStrategies() : Strategies::classicStrategies(), 
+		sim_settings.exact_strategies),
 	nn_population(), //nullptr array
+	spare_population(),
+	mutation_engine(sim_settings.mutation_rates),
+	tournament_threads(sim_settings.tournament_threads),
 	nn_game_counts(), //arrays of 0s
 	nn_payoff_sums()
 {
 	//create initial population of NeuralNetworks
 	for (int i=0; i<POPULATION_SIZE; ++i) {
 		//NNs are initialized with random structures (as specified)
-		nn_population[i] = new NeuralNetwork();
+		nn_population[i] = new Network();
+	}
+	
+	//live stats segment
+	if (not settings.monitor_name.empty())
+		monitor.reset(new Monitor(settings.monitor_name));
+	
+	//genomes of the population every archive_interval generations
+	if (not settings.archive_file.empty()) {
+		assert(settings.archive_interval > 0);
+		archive.reset(new GenomeArchiveWriter(settings.archive_file, Network::precisionName(), 
+			static_cast<std::uint64_t>(RNG::getSeed()), POPULATION_SIZE, settings.archive_interval));
+	}
+	
+	//hardware counters around each phase
+	if (settings.profile)
+		profiler.reset(new PhaseProfiler());
+	
+	//metrics recorded instead of the classic outputs
+	if (not settings.metrics.empty())
+		collectors = createCollectors<Network>(settings.metrics, strats);
+	
+	//steady state detection over a sliding window of generations
+	if (settings.steady_window > 0)
+		steady_detector.reset(new SteadyStateDetector(settings.steady_window));
+	
+	//track ancestry from the initial population
+	if (not settings.lineage_file.empty()) {
+		lineage.reset(new Lineage());
+		lineage->addFounders(nn_population, POPULATION_SIZE);
+	}
+}
+
+/*Destructor*/
+template<typename Network>
+BasicSimulation<Network>::~BasicSimulation()
+{
+	for (int i=0; i<POPULATION_SIZE; ++i) {
+		delete nn_population[i];
+		delete spare_population[i];
 	}
 }
 
 /*Executes one complete simulation with a certain number of generations*/
-void Simulation::run(unsigned int generations)
+template<typename Network>
+void BasicSimulation<Network>::run(unsigned int generations)
 {
-	//reserve array capacity for output data (optimisation)
+	start(generations);
+	while (getGeneration() < generations and not isStopped()) {
+		step();
+	}
+	finish();
+}
+
+/*Prepares the simulation, which can then be stepped for a certain number of generations*/
+template<typename Network>
+void BasicSimulation<Network>::start(unsigned int generations)
+{
+	if (total_generations > 0)
+		throw std::runtime_error("Simulation: already started");
+	total_generations = generations;
+	classic_outputs = collectors.empty();
+	
+	//reserve array capacity for output data (the pipeline writes into strategies_count)
 	population_intelligence.reserve(generations);
 	population_fitness.reserve(generations);
 	cooperation_frequency.reserve(generations);
 	strategies_count.reserve(generations);
+	fast_forwarded.reserve(generations);
+	
+	//units of antithetic matches, played on tournament threads (at least one, so that this thread keeps its stream)
+	if (settings.pair_matches == 0 or (settings.pair_matches > 1 and not settings.variance_reduction))
+		throw std::runtime_error("Simulation: matches per pair need variance reduction and at least one unit");
+	if (settings.variance_reduction) {
+		if (settings.shards > 0 or settings.moran)
+			throw std::runtime_error("Simulation: variance reduction cannot be combined with shards or the Moran process");
+		fitness_estimator.reset(new FitnessEstimator(POPULATION_SIZE, settings.pair_matches, true));
+		fitness_variance.reserve(generations);
+		effective_sample_size.reserve(generations);
+		tournament_threads = std::max(tournament_threads, 1u);
+	}
+	
+	//worker processes are forked before any thread is started
+	if (settings.shards > 0) {
+		if (settings.pipeline_workers > 0 or settings.tournament_threads > 0 or settings.moran)
+			throw std::runtime_error("Simulation: shards cannot be combined with the pipeline, tournament threads or the Moran process");
+		shard_tiles = shardTiles(POPULATION_SIZE);
+		shard_pool.reset(new ShardPool(settings.shards, settings.shard_transport, 
+			[this](unsigned shard, ShardChannel& channel) { runShardWorker(shard, channel); }));
+	}
+	
+	//classification of generation g overlaps with the tournament of generation g+1
+	if (settings.pipeline_workers > 0 and not classic_outputs)
+		throw std::runtime_error("Simulation: the pipeline only classifies the classic outputs, use a strategies collector");
+	if (settings.pipeline_workers > 0)
+		pipeline.reset(new AssessmentPipeline<Network>(strats, settings.pipeline_workers));
+	
+	//the number of tournament threads does not change the results, so the first generations can time them
+	if (settings.autotune) {
+		if (settings.tournament_threads == 0 or settings.shards > 0 or (MatchBatcher<Network>::supported and not fitness_estimator))
+			throw std::runtime_error("Simulation: autotuning needs matches played on tournament threads, without shards");
+		
+		//the cost of a match grows with the networks (whose size is set at creation for dense networks)
+		int initial_nodes = 0;
+		for (int i=0; i<POPULATION_SIZE; ++i) {
+			initial_nodes = std::max(initial_nodes, nn_population[i]->getInnerNodeCount());
+		}
+		std::string configuration = std::string(Network::precisionName()) + ",population=" + std::to_string(POPULATION_SIZE)
+			+ ",nodes=" + std::to_string(initial_nodes) + ",exact=" + std::to_string(settings.exact_payoffs) 
+			+ ",threads=" + std::to_string(settings.tournament_threads);
+		autotuner.reset(new Autotuner(configuration, Autotuner::threadCandidates(settings.tournament_threads), 
+			settings.autotune_cache.empty() ? Autotuner::defaultCacheFile() : settings.autotune_cache));
+	}
+	
+	//the Moran process keeps its population and the results of its matches
+	if (settings.moran) {
+		if (pipeline or settings.tournament_threads > 0 or steady_detector)
+			throw std::runtime_error("Simulation: the Moran process cannot be combined with the pipeline, tournament threads or steady states");
+		pair_results.reset(new PairwiseResults());
+		fitness_tree.reset(new FitnessTree(POPULATION_SIZE));
+	}
+}
+
+/*Plays, assesses and replaces one generation*/
+template<typename Network>
+void BasicSimulation<Network>::step()
+{
+	unsigned long generation = getGeneration();
+	if (generation >= total_generations)
+		throw std::runtime_error("Simulation: every generation it was started for has been run");
+	if (isStopped())
+		throw std::runtime_error("Simulation: stopped in a steady state");
+	
+	presetCounters();
+	{
+		ProfiledPhase phase(profiler.get(), PROFILE_PHASE_TOURNAMENT);
+		if (pair_results) {
+			if (generation == 0) playPairs();
+		}
+		else if (not fast_forwarding and autotuner) {
+			tournament_threads = autotuner->begin();
+			playGeneration();
+			autotuner->end();
+		}
+		else if (not fast_forwarding) playGeneration();
+	}
+	double structure_share = 0;
+	{
+		ProfiledPhase phase(profiler.get(), PROFILE_PHASE_ASSESSMENT);
+		if (fast_forwarding) assessFastForward();
+		else assessPopulation();
+		if (steady_detector) structure_share = SteadyStateDetector::structureShare(nn_population, POPULATION_SIZE);
+	}
+	{
+		ProfiledPhase phase(profiler.get(), PROFILE_PHASE_OUTPUT);
+		if (archive and generation % settings.archive_interval == 0) 
+			archive->append(generation, nn_population, POPULATION_SIZE);
+		
+		if (generation_callback or not collectors.empty()) {
+			GenerationView<Network> view;
+			view.generation = generation;
+			view.population_size = POPULATION_SIZE;
+			view.population = nn_population;
+			view.intelligence = population_intelligence.back().data();
+			view.fitness = population_fitness.back().data();
+			view.cooperation_frequency = cooperation_frequency.back()[0];
+			view.strategies = (pipeline or not classic_outputs) ? nullptr : strategies_count.back().data();
+			view.strategy_count = strats.getStrategyCount();
+			view.fast_forwarded = fast_forwarding;
+			
+			for (std::unique_ptr<MetricCollector<Network>>& collector : collectors) {
+				collector->collect(view);
+			}
+			if (generation_callback) generation_callback(view);
+		}
+	}
+	{
+		ProfiledPhase phase(profiler.get(), PROFILE_PHASE_SELECTION);
+		if (pair_results) moranGeneration();
+		else nextGeneration();
+	}
+	if (steady_detector) updateSteadyState(structure_share);
+	{
+		ProfiledPhase phase(profiler.get(), PROFILE_PHASE_OUTPUT);
+		if (monitor) publishStats(total_generations, false);
+		
+		//ancestry checkpoint
+		if (lineage and settings.lineage_interval > 0 and (generation+1) % settings.lineage_interval == 0)
+			lineage->writeFile(settings.lineage_file);
+	}
+	if (profiler) profiler->endGeneration();
+}
+
+/*Writes the final lineage, closes the archive and waits for background classification*/
+template<typename Network>
+void BasicSimulation<Network>::finish()
+{
+	if (lineage) lineage->writeFile(settings.lineage_file);
+	if (archive) archive->close();
 	
-	//main loop of simulation
-	for (unsigned int i=0; i<generations; ++i) {
-		presetCounters();
-		playGeneration();
-		assessPopulation();
-		nextGeneration();
+	//wait for background classification to complete
+	if (pipeline) {
+		pipeline->finish();
+		pipeline.reset();
 	}
-	outputResults();
+	shard_pool.reset(); //stops the workers
+	if (monitor) publishStats(total_generations, true);
 }
 
-/*Resets all generation-specific counters*/
-void Simulation::presetCounters()
+template<typename Network>
+unsigned long BasicSimulation<Network>::getGeneration() const
+{
+	return population_fitness.size();
+}
+
+template<typename Network>
+bool BasicSimulation<Network>::isStopped() const
+{
+	return not steady_reason.empty();
+}
+
+template<typename Network>
+const std::string& BasicSimulation<Network>::getSteadyReason() const
+{
+	return steady_reason;
+}
+
+/*Sets the function called after every generation (before selection replaces the population)*/
+template<typename Network>
+void BasicSimulation<Network>::setGenerationCallback(std::function<void(const GenerationView<Network>&)> callback)
+{
+	generation_callback = std::move(callback);
+}
+
+/*Adds a collector, whose output replaces the classic outputs (with the other collectors')*/
+template<typename Network>
+void BasicSimulation<Network>::addCollector(std::unique_ptr<MetricCollector<Network>> collector)
+{
+	if (total_generations > 0)
+		throw std::runtime_error("Simulation: collectors must be added before the simulation starts");
+	collectors.push_back(std::move(collector));
+}
+
+/*Resets all generation-specific counters (sums the kept matches in the Moran process)*/
+template<typename Network>
+void BasicSimulation<Network>::presetCounters()
 {
 	//population counters
 	for (int i=0; i<POPULATION_SIZE; ++i) {
@@ -46,73 +277,489 @@ void Simulation::presetCounters()
 	total_cooperations = 0;
 	total_defections = 0;
 	
+	//recomputed from the matches once per generation, so that rounding errors do not accumulate
+	if (pair_results) {
+		for (int index_a=0; index_a<POPULATION_SIZE; ++index_a) {
+			for (int index_b=0; index_b<POPULATION_SIZE; ++index_b) {
+				nn_game_counts[index_a] += pair_results->games[index_a][index_b];
+				nn_payoff_sums[index_a] += pair_results->payoffs[index_a][index_b];
+				if (index_a < index_b) {
+					total_cooperations += pair_results->cooperations[index_a][index_b];
+					total_defections += pair_results->defections[index_a][index_b];
+				}
+			}
+		}
+	}
+	
 	//output data
 	population_intelligence.emplace_back();
 	population_fitness.emplace_back();
 	cooperation_frequency.emplace_back();
 	strategies_count.emplace_back();
+	fast_forwarded.emplace_back();
+	if (fitness_estimator) {
+		fitness_variance.emplace_back(); //0 unless a match is sampled
+		effective_sample_size.emplace_back();
+	}
 }
 
 /*Plays all individuals from this generation against each other*/
-void Simulation::playGeneration()
+template<typename Network>
+void BasicSimulation<Network>::playGeneration()
 {
+	std::vector<std::pair<int, int>> batched_pairs; //matches played simultaneously (see MatchBatcher)
+	std::vector<std::pair<int, int>> independent_pairs; //matches played on the tournament threads
+	std::vector<std::pair<int, int>> reduced_pairs; //units of antithetic matches played on the tournament threads
+	
 	//Iterate over every possible pair of players from the population
 	for (int index_a=0; index_a<POPULATION_SIZE-1; ++index_a) {
 		for (int index_b=index_a+1; index_b<POPULATION_SIZE; ++index_b) {
-			playEachOther(index_a, index_b);
+			//Pairs without context nodes can be evaluated exactly
+			if (settings.exact_payoffs and MarkovGame::isMarkovian(*nn_population[index_a]) 
+				and MarkovGame::isMarkovian(*nn_population[index_b]))
+				playExpected(index_a, index_b);
+			else if (fitness_estimator)
+				reduced_pairs.emplace_back(index_a, index_b);
+			else if (shard_pool)
+				continue; //played by the workers (see playSharded)
+			else if (MatchBatcher<Network>::supported)
+				batched_pairs.emplace_back(index_a, index_b);
+			else if (settings.tournament_threads > 0)
+				independent_pairs.emplace_back(index_a, index_b);
+			else
+				playEachOther(index_a, index_b);
 		}
 	}
+	
+	if (not batched_pairs.empty())
+		MatchBatcher<Network>::play(nn_population, batched_pairs, game_payoffs, nn_game_counts, nn_payoff_sums, 
+			total_cooperations, total_defections);
+	if (not independent_pairs.empty())
+		playIndependently(independent_pairs);
+	if (not reduced_pairs.empty())
+		playReduced(reduced_pairs);
+	if (shard_pool)
+		playSharded();
 }
 
-/*Plays two individuals against each other for a number of iterations (or "rounds")*/
-void Simulation::playEachOther(int index_a, int index_b)
+/*Plays two individuals against each other, each carrying its state over from its previous matches*/
+template<typename Network>
+void BasicSimulation<Network>::playEachOther(int index_a, int index_b)
 {
-	NeuralNetwork& player_a(*nn_population[index_a]);
-	NeuralNetwork& player_b(*nn_population[index_b]);
+	Network& player_a(*nn_population[index_a]);
+	Network& player_b(*nn_population[index_b]);
 	
-	payoff player_a_payoff, player_b_payoff; //results of each game iteration
-	unsigned long player_a_payoff_sum(0), player_b_payoff_sum(0); //sum of all game payoffs
+	addMatchResult(index_a, index_b, playMatch(game_payoffs, player_a, player_a.getCarryoverState(), player_b, player_b.getCarryoverState()));
+}
+
+/*
+Plays the matches on tournament_threads threads, which take the next block of matches to
+play until none is left. Each match uses new states, each block its own RNG stream (derived from the
+generation and the block's position in pairs), and the results are added in the order of pairs, so
+the counters are the same whatever the number of threads. Networks are only read meanwhile.*/
+template<typename Network>
+void BasicSimulation<Network>::playIndependently(const std::vector<std::pair<int, int>>& pairs)
+{
+	assert(tournament_threads > 0);
+	
+	std::vector<MatchResult> results(pairs.size());
+	unsigned long long first_stream = TOURNAMENT_STREAM_OFFSET * population_fitness.size(); //generation + 1
+	std::size_t block_count = (pairs.size() + TOURNAMENT_BLOCK_MATCHES - 1) / TOURNAMENT_BLOCK_MATCHES;
+	std::atomic<std::size_t> next_block(0);
+	
+	auto play_matches = [&]() {
+		for (std::size_t block=next_block++; block<block_count; block=next_block++) {
+			RNG::setStream(first_stream + block);
+			
+			std::size_t block_end = std::min(pairs.size(), (block + 1) * TOURNAMENT_BLOCK_MATCHES);
+			for (std::size_t match=block*TOURNAMENT_BLOCK_MATCHES; match<block_end; ++match) {
+				const Network& player_a(*nn_population[pairs[match].first]);
+				const Network& player_b(*nn_population[pairs[match].second]);
+				typename Network::State state_a = player_a.createState();
+				typename Network::State state_b = player_b.createState();
+				results[match] = playMatch(game_payoffs, player_a, state_a, player_b, state_b);
+			}
+		}
+	};
+	
+	std::vector<std::thread> threads;
+	for (unsigned thread_index=0; thread_index<tournament_threads; ++thread_index) {
+		threads.emplace_back(play_matches);
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	
+	for (std::size_t match=0; match<pairs.size(); ++match) {
+		addMatchResult(pairs[match].first, pairs[match].second, results[match]);
+	}
+}
+
+/*
+Plays a match from new states for the longer of two numbers of iterations, and returns the results of
+both numbers: the shorter match is the start of the longer one, as both would make the same draws.*/
+template<typename Network>
+static std::array<MatchResult, ESTIMATOR_UNIT_MATCHES> playNestedMatches(const Payoffs& game_payoffs, 
+	const Network& player_a, const Network& player_b, const std::array<int, ESTIMATOR_UNIT_MATCHES>& round_iterations)
+{
+	std::array<MatchResult, ESTIMATOR_UNIT_MATCHES> results;
+	typename Network::State state_a = player_a.createState();
+	typename Network::State state_b = player_b.createState();
+	MatchResult result;
+	payoff player_a_payoff, player_b_payoff;
 	
-	//Play initial iteration (no input)
 	bool player_a_cooperates = player_a();
 	bool player_b_cooperates = player_b();
+	int longest = *std::max_element(round_iterations.begin(), round_iterations.end());
 	
-	//Choose a random number of iterations to play
-	int round_iterations = RNG::getIterationCount();
-	
-	for (int iteration=0; iteration<round_iterations; ++iteration) {
-		//count each player's cooperations
-		if (player_a_cooperates) total_cooperations += 1;
-		else total_defections += 1;
-		if (player_b_cooperates) total_cooperations += 1;
-		else total_defections += 1;
+	for (int iteration=0; iteration<longest; ++iteration) {
+		if (player_a_cooperates) result.cooperations += 1;
+		else result.defections += 1;
+		if (player_b_cooperates) result.cooperations += 1;
+		else result.defections += 1;
 		
-		//gather payoffs from individual's decisions
 		game_payoffs.payoffsFromChoices(player_a_cooperates, player_b_cooperates, player_a_payoff, player_b_payoff);
+		result.player_a_payoff_sum += player_a_payoff;
+		result.player_b_payoff_sum += player_b_payoff;
+		result.round_iterations = iteration + 1;
 		
-		//add payoffs to player's stats
-		player_a_payoff_sum += player_a_payoff;
-		player_b_payoff_sum += player_b_payoff;
+		//matches ending here
+		for (std::size_t match=0; match<ESTIMATOR_UNIT_MATCHES; ++match) {
+			if (round_iterations[match] == result.round_iterations) results[match] = result;
+		}
 		
-		//Play subsequent iterations
-		player_a_cooperates = player_a(player_a_payoff, player_b_payoff);
-		player_b_cooperates = player_b(player_b_payoff, player_a_payoff);
+		player_a_cooperates = player_a.decide(player_a_payoff, player_b_payoff, state_a);
+		player_b_cooperates = player_b.decide(player_b_payoff, player_a_payoff, state_b);
+	}
+	
+	return results;
+}
+
+/*
+Plays settings.pair_matches units per pair on tournament_threads threads. Unit k of every pair draws from
+the same RNG stream (derived from the generation and k): first the tail probability u of its lengths,
+then the decisions, so the pairs of a generation share their random numbers, and only the units of a
+pair are independent. Each unit's results are added to the counters and to the fitness estimator in the
+order of pairs (units 0 to pair_matches-1 of a pair, then the next pair), which then sets the fitness.*/
+template<typename Network>
+void BasicSimulation<Network>::playReduced(const std::vector<std::pair<int, int>>& pairs)
+{
+	assert(tournament_threads > 0);
+	
+	std::size_t units = settings.pair_matches;
+	std::vector<std::array<MatchResult, ESTIMATOR_UNIT_MATCHES>> results(pairs.size() * units);
+	unsigned long long first_stream = TOURNAMENT_STREAM_OFFSET * population_fitness.size(); //generation + 1
+	std::size_t block_count = (results.size() + TOURNAMENT_BLOCK_MATCHES - 1) / TOURNAMENT_BLOCK_MATCHES;
+	std::atomic<std::size_t> next_block(0);
+	
+	auto play_units = [&]() {
+		//each unit's stream is seeded once per thread, then restarted for each pair
+		std::vector<std::mt19937_64> unit_streams;
+		for (std::size_t unit=0; unit<units; ++unit) {
+			RNG::setStream(first_stream + unit);
+			unit_streams.push_back(RNG::getGenerator());
+		}
+		
+		for (std::size_t block=next_block++; block<block_count; block=next_block++) {
+			std::size_t block_end = std::min(results.size(), (block + 1) * TOURNAMENT_BLOCK_MATCHES);
+			for (std::size_t index=block*TOURNAMENT_BLOCK_MATCHES; index<block_end; ++index) {
+				RNG::setGenerator(unit_streams[index % units]);
+				double tail = 1 - RNG::getRandomProbability(); //in ]0, 1]
+				std::array<int, ESTIMATOR_UNIT_MATCHES> round_iterations = {{RNG::getIterationCountAt(tail), 
+					RNG::getIterationCountAt(1 - tail)}};
+				
+				const std::pair<int, int>& pair = pairs[index / units];
+				results[index] = playNestedMatches(game_payoffs, *nn_population[pair.first], *nn_population[pair.second], 
+					round_iterations);
+			}
+		}
+	};
+	
+	std::vector<std::thread> threads;
+	for (unsigned thread_index=0; thread_index<tournament_threads; ++thread_index) {
+		threads.emplace_back(play_units);
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	
+	fitness_estimator->clear();
+	for (std::size_t index=0; index<results.size(); ++index) {
+		AntitheticSample sample_a, sample_b;
+		for (std::size_t match=0; match<ESTIMATOR_UNIT_MATCHES; ++match) {
+			const MatchResult& result = results[index][match];
+			total_cooperations += result.cooperations;
+			total_defections += result.defections;
+			sample_a.payoffs[match] = static_cast<double>(result.player_a_payoff_sum);
+			sample_b.payoffs[match] = static_cast<double>(result.player_b_payoff_sum);
+			sample_a.iterations[match] = sample_b.iterations[match] = result.round_iterations;
+		}
+		fitness_estimator->addSample(pairs[index / units].first, sample_a);
+		fitness_estimator->addSample(pairs[index / units].second, sample_b);
+	}
+	fitness_estimator->estimate(nn_payoff_sums, nn_game_counts);
+	fitness_variance.back()[0] = fitness_estimator->getVariance();
+	effective_sample_size.back()[0] = fitness_estimator->getEffectiveSampleSize();
+}
+
+/*
+Sends every worker the genomes of the individuals of its tiles, then adds up the sums each worker
+sends back, in the order of the workers. The sums are integers (sampled matches), so their total
+does not depend on how the tiles are dealt.*/
+template<typename Network>
+void BasicSimulation<Network>::playSharded()
+{
+	unsigned long long first_stream = TOURNAMENT_STREAM_OFFSET * population_fitness.size(); //generation + 1
+	unsigned shard_count = shard_pool->size();
+	std::vector<char> genome;
+	
+	for (unsigned shard=0; shard<shard_count; ++shard) {
+		std::array<bool, POPULATION_SIZE> needed = {};
+		for (std::size_t tile=shard; tile<shard_tiles.size(); tile+=shard_count) {
+			std::fill(needed.begin() + shard_tiles[tile].row_begin, needed.begin() + shard_tiles[tile].row_end, true);
+			std::fill(needed.begin() + shard_tiles[tile].col_begin, needed.begin() + shard_tiles[tile].col_end, true);
+		}
+		
+		ShardChannel& channel = shard_pool->getChannel(shard);
+		channel.sendValue<std::uint32_t>(SHARD_COMMAND_PLAY);
+		channel.sendValue<std::uint64_t>(first_stream);
+		channel.sendValue<std::uint32_t>(static_cast<std::uint32_t>(std::count(needed.begin(), needed.end(), true)));
+		for (int i=0; i<POPULATION_SIZE; ++i) {
+			if (not needed[i]) continue;
+			genome.resize(nn_population[i]->getGenomeSize());
+			nn_population[i]->writeGenome(genome.data());
+			channel.sendValue<std::int32_t>(i);
+			channel.sendValue<std::uint64_t>(genome.size());
+			channel.send(genome.data(), genome.size());
+		}
 	}
 	
-	//Modify the player's counters accordingly
-	nn_game_counts[index_a] += round_iterations;
-	nn_game_counts[index_b] += round_iterations;
-	nn_payoff_sums[index_a] += player_a_payoff_sum;
-	nn_payoff_sums[index_b] += player_b_payoff_sum;
+	std::array<double, POPULATION_SIZE> game_counts, payoff_sums;
+	for (unsigned shard=0; shard<shard_count; ++shard) {
+		ShardChannel& channel = shard_pool->getChannel(shard);
+		channel.receive(game_counts.data(), sizeof(game_counts));
+		channel.receive(payoff_sums.data(), sizeof(payoff_sums));
+		total_cooperations += channel.receiveValue<double>();
+		total_defections += channel.receiveValue<double>();
+		
+		for (int i=0; i<POPULATION_SIZE; ++i) {
+			nn_game_counts[i] += game_counts[i];
+			nn_payoff_sums[i] += payoff_sums[i];
+		}
+	}
+}
+
+/*
+Runs in a worker process until the stop command: rebuilds the genomes it is sent, plays the pairs of
+its tiles (except those the coordinator evaluates exactly) from new states, each tile on its own RNG
+stream, and sends back the sums of each individual and the generation's cooperations and defections.*/
+template<typename Network>
+void BasicSimulation<Network>::runShardWorker(unsigned shard, ShardChannel& channel)
+{
+	unsigned shard_count = settings.shards;
+	std::vector<std::unique_ptr<Network>> players(POPULATION_SIZE);
+	std::vector<char> genome;
+	
+	while (channel.receiveValue<std::uint32_t>() == SHARD_COMMAND_PLAY) {
+		std::uint64_t first_stream = channel.receiveValue<std::uint64_t>();
+		std::uint32_t genome_count = channel.receiveValue<std::uint32_t>();
+		for (std::uint32_t genome_index=0; genome_index<genome_count; ++genome_index) {
+			std::int32_t i = channel.receiveValue<std::int32_t>();
+			if (i < 0 or i >= POPULATION_SIZE)
+				throw std::runtime_error("Simulation: invalid individual received by a shard");
+			genome.resize(channel.receiveValue<std::uint64_t>());
+			channel.receive(genome.data(), genome.size());
+			players[static_cast<std::size_t>(i)].reset(new Network(genome.data()));
+		}
+		
+		std::array<double, POPULATION_SIZE> game_counts = {}, payoff_sums = {};
+		double cooperations = 0, defections = 0;
+		for (std::size_t tile=shard; tile<shard_tiles.size(); tile+=shard_count) {
+			RNG::setStream(first_stream + tile);
+			
+			const ShardTile& bounds = shard_tiles[tile];
+			for (int index_a=bounds.row_begin; index_a<bounds.row_end; ++index_a) {
+				for (int index_b=std::max(index_a+1, bounds.col_begin); index_b<bounds.col_end; ++index_b) {
+					Network& player_a(*players[static_cast<std::size_t>(index_a)]);
+					Network& player_b(*players[static_cast<std::size_t>(index_b)]);
+					if (settings.exact_payoffs and MarkovGame::isMarkovian(player_a) and MarkovGame::isMarkovian(player_b))
+						continue;
+					
+					typename Network::State state_a = player_a.createState();
+					typename Network::State state_b = player_b.createState();
+					MatchResult result = playMatch(game_payoffs, player_a, state_a, player_b, state_b);
+					
+					game_counts[index_a] += result.round_iterations;
+					game_counts[index_b] += result.round_iterations;
+					payoff_sums[index_a] += static_cast<double>(result.player_a_payoff_sum);
+					payoff_sums[index_b] += static_cast<double>(result.player_b_payoff_sum);
+					cooperations += result.cooperations;
+					defections += result.defections;
+				}
+			}
+		}
+		
+		channel.send(game_counts.data(), sizeof(game_counts));
+		channel.send(payoff_sums.data(), sizeof(payoff_sums));
+		channel.sendValue(cooperations);
+		channel.sendValue(defections);
+	}
+}
+
+/*Modifies the players' counters according to the results of their match*/
+template<typename Network>
+void BasicSimulation<Network>::addMatchResult(int index_a, int index_b, const MatchResult& result)
+{
+	total_cooperations += result.cooperations;
+	total_defections += result.defections;
+	
+	nn_game_counts[index_a] += result.round_iterations;
+	nn_game_counts[index_b] += result.round_iterations;
+	nn_payoff_sums[index_a] += static_cast<double>(result.player_a_payoff_sum);
+	nn_payoff_sums[index_b] += static_cast<double>(result.player_b_payoff_sum);
+}
+
+/*Adds the expected results of a match between two individuals to their counters, without playing it*/
+template<typename Network>
+void BasicSimulation<Network>::playExpected(int index_a, int index_b)
+{
+	MatchExpectation expectation = MarkovGame::expectedMatch(*nn_population[index_a], *nn_population[index_b], game_payoffs);
+	
+	total_cooperations += expectation.cooperations;
+	total_defections += expectation.defections;
+	
+	nn_game_counts[index_a] += expectation.round_iterations;
+	nn_game_counts[index_b] += expectation.round_iterations;
+	nn_payoff_sums[index_a] += expectation.player_a_payoff_sum;
+	nn_payoff_sums[index_b] += expectation.player_b_payoff_sum;
+}
+
+/*Plays every pair of individuals once with new states, keeping the results (first Moran generation)*/
+template<typename Network>
+void BasicSimulation<Network>::playPairs()
+{
+	for (int index_a=0; index_a<POPULATION_SIZE-1; ++index_a) {
+		for (int index_b=index_a+1; index_b<POPULATION_SIZE; ++index_b) {
+			setPairResult(index_a, index_b, playNewMatch(index_a, index_b));
+		}
+	}
+}
+
+/*Plays a match between two individuals from new states, or computes its expectation in exact mode*/
+template<typename Network>
+MatchExpectation BasicSimulation<Network>::playNewMatch(int index_a, int index_b)
+{
+	Network& player_a(*nn_population[index_a]);
+	Network& player_b(*nn_population[index_b]);
+	if (settings.exact_payoffs and MarkovGame::isMarkovian(player_a) and MarkovGame::isMarkovian(player_b))
+		return MarkovGame::expectedMatch(player_a, player_b, game_payoffs);
+	
+	typename Network::State state_a = player_a.createState();
+	typename Network::State state_b = player_b.createState();
+	MatchResult result = playMatch(game_payoffs, player_a, state_a, player_b, state_b);
+	
+	MatchExpectation expectation;
+	expectation.player_a_payoff_sum = static_cast<double>(result.player_a_payoff_sum);
+	expectation.player_b_payoff_sum = static_cast<double>(result.player_b_payoff_sum);
+	expectation.round_iterations = result.round_iterations;
+	expectation.cooperations = result.cooperations;
+	expectation.defections = result.defections;
+	return expectation;
+}
+
+/*Replaces the results of the match between two individuals, in the kept matches and the counters*/
+template<typename Network>
+void BasicSimulation<Network>::setPairResult(int index_a, int index_b, const MatchExpectation& result)
+{
+	PairwiseResults& pairs = *pair_results;
+	
+	//remove the previous match of the pair
+	nn_game_counts[index_a] -= pairs.games[index_a][index_b];
+	nn_game_counts[index_b] -= pairs.games[index_a][index_b];
+	nn_payoff_sums[index_a] -= pairs.payoffs[index_a][index_b];
+	nn_payoff_sums[index_b] -= pairs.payoffs[index_b][index_a];
+	total_cooperations -= pairs.cooperations[index_a][index_b];
+	total_defections -= pairs.defections[index_a][index_b];
+	
+	pairs.games[index_a][index_b] = pairs.games[index_b][index_a] = result.round_iterations;
+	pairs.payoffs[index_a][index_b] = result.player_a_payoff_sum;
+	pairs.payoffs[index_b][index_a] = result.player_b_payoff_sum;
+	pairs.cooperations[index_a][index_b] = pairs.cooperations[index_b][index_a] = result.cooperations;
+	pairs.defections[index_a][index_b] = pairs.defections[index_b][index_a] = result.defections;
+	
+	//add the new one
+	nn_game_counts[index_a] += result.round_iterations;
+	nn_game_counts[index_b] += result.round_iterations;
+	nn_payoff_sums[index_a] += result.player_a_payoff_sum;
+	nn_payoff_sums[index_b] += result.player_b_payoff_sum;
+	total_cooperations += result.cooperations;
+	total_defections += result.defections;
+}
+
+/*
+Runs POPULATION_SIZE birth-death events: the parent is selected with probability proportional to its
+fitness (uniformly if no fitness is positive), and its mutated copy replaces an individual chosen
+uniformly (possibly the parent). Only the newcomer's matches are replayed, but they change every
+individual's fitness, so the tree is rebuilt once per event (O(n)) rather than updated weight by
+weight. The lineage records each individual's ancestor in the previous generation, with the
+mutations accumulated since.*/
+template<typename Network>
+void BasicSimulation<Network>::moranGeneration()
+{
+	std::array<int, POPULATION_SIZE> ancestors; //index of each individual's ancestor at the start of the generation
+	std::array<MutationRecord, POPULATION_SIZE> mutations; //mutations since then
+	std::vector<double> weights(POPULATION_SIZE);
+	for (int i=0; i<POPULATION_SIZE; ++i) {
+		ancestors[i] = i;
+		weights[i] = individualFitness(i);
+	}
+	fitness_tree->assign(weights);
+	
+	for (int event=0; event<POPULATION_SIZE; ++event) {
+		//birth proportional to fitness, death uniform
+		double total_fitness = fitness_tree->total();
+		int parent = (total_fitness > 0) ? static_cast<int>(fitness_tree->find(RNG::getRandomProbability() * total_fitness)) 
+			: RNG::getRandomInt(0, POPULATION_SIZE-1);
+		int replaced = RNG::getRandomInt(0, POPULATION_SIZE-1);
+		
+		if (replaced != parent) *nn_population[replaced] = *nn_population[parent];
+		MutationRecord mutation;
+		mutation_engine.mutatePopulation(&nn_population[replaced], 1, &mutation);
+		
+		ancestors[replaced] = ancestors[parent];
+		mutations[replaced].value_mutations = mutations[parent].value_mutations + mutation.value_mutations;
+		mutations[replaced].node_change = mutations[parent].node_change + mutation.node_change;
+		
+		//the newcomer plays everyone, which changes every individual's fitness
+		for (int other=0; other<POPULATION_SIZE; ++other) {
+			if (other != replaced) setPairResult(replaced, other, playNewMatch(replaced, other));
+		}
+		for (int i=0; i<POPULATION_SIZE; ++i) {
+			weights[i] = individualFitness(i);
+		}
+		fitness_tree->assign(weights);
+	}
+	
+	//record who descended from whom
+	if (lineage) 
+		lineage->addGeneration(nn_population, ancestors.data(), mutations.data(), POPULATION_SIZE);
+}
+
+/*Average payoff per game iteration, minus the cost of the individual's inner nodes*/
+template<typename Network>
+double BasicSimulation<Network>::individualFitness(int index) const
+{
+	return (nn_payoff_sums[index] / nn_game_counts[index]) 
+		- (NODE_FITNESS_PENALTY * nn_population[index]->getInnerNodeCount());
 }
 
 /*Determines the current population's typical strategies and other metrics*/
-void Simulation::assessPopulation()
+template<typename Network>
+void BasicSimulation<Network>::assessPopulation()
 {
 	//references to output arrays corresponding to current generation
 	std::array<int, POPULATION_SIZE>& current_intelligence = population_intelligence.back();
 	std::array<double, POPULATION_SIZE>& current_fitness = population_fitness.back();
-	std::array<int, STRATEGIES_COUNT>& current_strategies = strategies_count.back();
 	
 	for (int i=0; i<POPULATION_SIZE; ++i) {
 		
@@ -120,50 +767,214 @@ void Simulation::assessPopulation()
 		current_intelligence[i] = nn_population[i]->getInnerNodeCount();
 		
 		//fitness
-		current_fitness[i] = (static_cast<double>(nn_payoff_sums[i])/static_cast<double>(nn_game_counts[i])) 
-			- (NODE_FITNESS_PENALTY * current_intelligence[i]);
-			
-		//strategy
-		current_strategies[strats.closestPureStrategy(*(nn_population[i]))] += 1;
+		current_fitness[i] = individualFitness(i);
 	}
 	//average cooperation frequency
-	cooperation_frequency.back()[0] = static_cast<double>(total_cooperations) / static_cast<double>(total_cooperations + total_defections);
+	cooperation_frequency.back()[0] = total_cooperations / (total_cooperations + total_defections);
+	
+	//strategies (classified in the background by the pipeline if enabled, by the collectors if any)
+	if (classic_outputs and not pipeline) classifyPopulation();
+}
+
+/*Counts the closest pure strategy of each individual of the current population*/
+template<typename Network>
+void BasicSimulation<Network>::classifyPopulation()
+{
+	StrategyCounts& current_strategies = strategies_count.back();
+	
+	for (int i=0; i<POPULATION_SIZE; ++i) {
+		current_strategies[strats.closestPureStrategy(*(nn_population[i]))] += 1;
+	}
+}
+
+/*
+Assesses a generation whose tournament was skipped: the structure and strategies are those of the
+current population, while fitness and cooperation are kept from the last generation (not used for selection).*/
+template<typename Network>
+void BasicSimulation<Network>::assessFastForward()
+{
+	std::size_t current = population_fitness.size() - 1;
+	assert(current > 0);
+	
+	for (int i=0; i<POPULATION_SIZE; ++i) {
+		population_intelligence.back()[i] = nn_population[i]->getInnerNodeCount();
+	}
+	population_fitness.back() = population_fitness[current - 1];
+	cooperation_frequency.back() = cooperation_frequency[current - 1];
+	fast_forwarded.back()[0] = 1;
+	
+	if (classic_outputs and not pipeline) classifyPopulation();
+}
+
+/*
+Adds the last generation to the steady state detection. A steady population either stops the
+simulation or is fast-forwarded; fast-forwarding ends when the structure diversifies or after a whole
+window, to evaluate the population again, and either way a new window starts.*/
+template<typename Network>
+void BasicSimulation<Network>::updateSteadyState(double structure_share)
+{
+	if (fast_forwarding) {
+		fast_forward_length++;
+		//either way the population drifted, so the generations before the fast-forward no longer describe it
+		if (structure_share < STEADY_STRUCTURE_SHARE or fast_forward_length >= settings.steady_window) {
+			fast_forwarding = false;
+			steady_detector->reset();
+		}
+		return;
+	}
+	
+	double mean_intelligence = 0;
+	for (int i=0; i<POPULATION_SIZE; ++i) {
+		mean_intelligence += population_intelligence.back()[i];
+	}
+	mean_intelligence /= POPULATION_SIZE;
+	
+	if (steady_detector->update(cooperation_frequency.back()[0], mean_intelligence, structure_share)) {
+		if (settings.steady_action == STEADY_ACTION_STOP) {
+			steady_reason = "steady at generation " + std::to_string(population_fitness.size() - 1) + ": " 
+				+ steady_detector->describe();
+		}
+		else {
+			fast_forwarding = true;
+			fast_forward_length = 0;
+		}
+	}
 }
 
 /*Replaces the current generation by selection based on fitness followed by mutation*/
-void Simulation::nextGeneration()
+template<typename Network>
+void BasicSimulation<Network>::nextGeneration()
 {	
-	//select individuals to reproduce with probability proportional to their fitness
+	//select individuals to reproduce with probability proportional to their fitness (uniformly when fast-forwarding)
 	std::array<int, POPULATION_SIZE> new_population_indexes;
-	RNG::selectPopulation<POPULATION_SIZE>(population_fitness.back(), new_population_indexes);
+	std::array<double, POPULATION_SIZE> uniform_weights;
+	uniform_weights.fill(1);
+	RNG::selectPopulation<POPULATION_SIZE>(fast_forwarding ? uniform_weights : population_fitness.back(), new_population_indexes);
 	
-	//create the new population with the new selection
-	NeuralNetwork* new_population[POPULATION_SIZE];
+	//create the new population with the new selection (reusing the spare networks if the pipeline does not take the old ones)
+	Network* new_population[POPULATION_SIZE];
 	int selected_index;
 	for (int i=0; i<POPULATION_SIZE; ++i) {
 		selected_index = new_population_indexes[i]; //index of selected individual
-		new_population[i] = new NeuralNetwork(*nn_population[selected_index]); //copy the NN
+		if (pipeline or spare_population[i] == nullptr)
+			new_population[i] = new Network(*nn_population[selected_index]); //copy the NN
+		else
+			new_population[i] = &(*spare_population[i] = *nn_population[selected_index]);
 	}
 	
-	//replace the old population and mutate the new individuals
+	//hand the old population over to the pipeline, which classifies then deletes it
+	if (pipeline) {
+		AssessmentJob<Network> job;
+		job.generation = population_fitness.size() - 1;
+		job.population.assign(nn_population, nn_population + POPULATION_SIZE);
+		job.strategies = &strategies_count.back();
+		pipeline->push(std::move(job));
+	}
+	
+	//replace the old population, which becomes the spare networks of the next generation
 	for (int i=0; i<POPULATION_SIZE; ++i) {
-		delete nn_population[i]; //delete previous NeuralNetwork
+		spare_population[i] = pipeline ? nullptr : nn_population[i];
 		nn_population[i] = new_population[i]; //copy pointer to new NeuralNetwork
-		nn_population[i]->mutate(); //mutate new NeuralNetwork
 	}
+	
+	//mutate the new individuals
+	std::array<MutationRecord, POPULATION_SIZE> mutations;
+	mutation_engine.mutatePopulation(nn_population, POPULATION_SIZE, mutations.data());
+	
+	//record who descended from whom
+	if (lineage) 
+		lineage->addGeneration(nn_population, new_population_indexes.data(), mutations.data(), POPULATION_SIZE);
+}
+
+template<typename Network>
+const std::vector<std::array<int, POPULATION_SIZE>>& BasicSimulation<Network>::getPopulationIntelligence() const
+{
+	return population_intelligence;
+}
+
+template<typename Network>
+const std::vector<std::array<double, POPULATION_SIZE>>& BasicSimulation<Network>::getPopulationFitness() const
+{
+	return population_fitness;
+}
+
+template<typename Network>
+const std::vector<std::array<double, 1>>& BasicSimulation<Network>::getCooperationFrequency() const
+{
+	return cooperation_frequency;
+}
+
+template<typename Network>
+const std::vector<StrategyCounts>& BasicSimulation<Network>::getStrategiesCount() const
+{
+	return strategies_count;
+}
+
+template<typename Network>
+const std::vector<std::array<int, 1>>& BasicSimulation<Network>::getFastForwarded() const
+{
+	return fast_forwarded;
+}
+
+template<typename Network>
+const std::vector<std::array<double, 1>>& BasicSimulation<Network>::getFitnessVariance() const
+{
+	return fitness_variance;
+}
+
+template<typename Network>
+const std::vector<std::array<double, 1>>& BasicSimulation<Network>::getEffectiveSampleSize() const
+{
+	return effective_sample_size;
+}
+
+template<typename Network>
+const Strategies& BasicSimulation<Network>::getStrategies() const
+{
+	return strats;
+}
+
+/*Publishes the current generation's stats to the monitor segment*/
+template<typename Network>
+void BasicSimulation<Network>::publishStats(unsigned long total_generations, bool finished)
+{
+	MonitorStats stats = {};
+	stats.generation = population_fitness.size();
+	stats.total_generations = total_generations;
+	stats.finished = finished ? 1 : 0;
+	stats.cooperation_frequency = cooperation_frequency.back()[0];
+	
+	for (int i=0; i<POPULATION_SIZE; ++i) {
+		stats.mean_intelligence += population_intelligence.back()[i];
+		stats.mean_fitness += population_fitness.back()[i];
+	}
+	stats.mean_intelligence /= POPULATION_SIZE;
+	stats.mean_fitness /= POPULATION_SIZE;
+	
+	//strategies of the current generation may still be classified in the background
+	if (pipeline) stats.strategies_generation = pipeline->latestAssessedGeneration();
+	else stats.strategies_generation = classic_outputs ? static_cast<long>(strategies_count.size()) - 1 : -1;
+	stats.strategy_count = strats.getStrategyCount();
+	if (stats.strategies_generation >= 0) {
+		for (int strat_index=0; strat_index<strats.getStrategyCount(); ++strat_index) {
+			stats.strategies[strat_index] = strategies_count[stats.strategies_generation][strat_index];
+		}
+	}
+	
+	monitor->publish(stats);
 }
 
 template<typename T, int N>
-void printMatrix(const std::vector<std::array<T, N>>& matrix, std::string variable_name)
+void printMatrix(const std::vector<std::array<T, N>>& matrix, std::string variable_name, int columns = N)
 {
 	std::string output = "";
 	output += "# name: " + variable_name + "\n";
 	output += "# type: matrix\n";
 	output += "# rows: " + std::to_string(matrix.size()) + "\n";
-	output += "# columns: " + std::to_string(N) + "\n";
+	output += "# columns: " + std::to_string(columns) + "\n";
 	
 	for (unsigned int row=0; row<matrix.size(); ++row) {
-		for (unsigned int col=0; col<N; ++col) {
+		for (int col=0; col<columns; ++col) {
 			output += std::to_string(matrix[row][col]) + " ";
 		}
 		output += "\n";
@@ -182,18 +993,119 @@ void printScalar(int value, std::string variable_name)
 }
 
 /*Writes the simulation's results to the standard output*/
-void Simulation::outputResults()
+template<typename Network>
+void BasicSimulation<Network>::outputResults()
 {
-	//Intelligence
-	printMatrix<int, POPULATION_SIZE>(population_intelligence, std::string("pop_intelligence"));
+	{
+		ProfiledPhase phase(profiler.get(), PROFILE_PHASE_OUTPUT);
+		
+		//Metric collectors
+		if (not classic_outputs) {
+			for (const std::unique_ptr<MetricCollector<Network>>& collector : collectors) {
+				collector->write(std::cout);
+			}
+		}
+		else {
+			//Intelligence
+			printMatrix<int, POPULATION_SIZE>(population_intelligence, std::string("pop_intelligence"));
+			
+			//Fitness
+			printMatrix<double, POPULATION_SIZE>(population_fitness, std::string("pop_fitness"));
+			
+			//Average cooperation
+			printMatrix<double, 1>(cooperation_frequency, std::string("cooperation_freq"));
+			
+			//Strategies
+			std::cout << "# STRATEGIES are [";
+			for (int strat_index=0; strat_index<strats.getStrategyCount(); ++strat_index) {
+				std::cout << (strat_index > 0 ? ", " : "") << strats.getStrategyName(strat_index);
+			}
+			std::cout << "]\n";
+			printMatrix<int, STRATEGIES_MAX>(strategies_count, std::string("strategies_count"), strats.getStrategyCount());
+		}
+		
+		//Steady state
+		if (isStopped()) std::cout << "# Stopped early, " << steady_reason << "\n";
+		if (steady_detector and settings.steady_action == STEADY_ACTION_FAST_FORWARD)
+			printMatrix<int, 1>(fast_forwarded, std::string("fast_forwarded"));
+		
+		//Precision of the variance reduced fitness
+		if (fitness_estimator) {
+			printMatrix<double, 1>(fitness_variance, std::string("fitness_variance"));
+			printMatrix<double, 1>(effective_sample_size, std::string("effective_sample_size"));
+		}
+	}
+		
+	//Hardware counters (measured until the results above are printed)
+	if (profiler) profiler->write(std::cout);
+	if (autotuner) autotuner->write(std::cout);
+}
+
+/*Feeds the simulation's results to the aggregator, without any text output*/
+template<typename Network>
+void BasicSimulation<Network>::aggregateResults(Aggregator& aggregator) const
+{
+	aggregator.beginReplicate();
+	
+	for (std::size_t generation=0; generation<population_fitness.size(); ++generation) {
+		aggregator.addPopulation(generation, population_intelligence[generation].data(), 
+			population_fitness[generation].data(), POPULATION_SIZE);
+		aggregator.addCooperation(generation, cooperation_frequency[generation][0]);
+		aggregator.addStrategies(generation, strategies_count[generation].data(), strats.getStrategyCount());
+	}
+}
+
+
+/*Plays two players against each other for a number of iterations (or "rounds"), updating their states*/
+template<typename Network>
+MatchResult playMatch(const Payoffs& game_payoffs, const Network& player_a, typename Network::State& state_a, 
+	const Network& player_b, typename Network::State& state_b)
+{
+	MatchResult result;
+	payoff player_a_payoff, player_b_payoff; //results of each game iteration
+	
+	//Play initial iteration (no input)
+	bool player_a_cooperates = player_a();
+	bool player_b_cooperates = player_b();
 	
-	//Fitness
-	printMatrix<double, POPULATION_SIZE>(population_fitness, std::string("pop_fitness"));
+	//Choose a random number of iterations to play
+	result.round_iterations = RNG::getIterationCount();
 	
-	//Average cooperation
-	printMatrix<double, 1>(cooperation_frequency, std::string("cooperation_freq"));
+	for (int iteration=0; iteration<result.round_iterations; ++iteration) {
+		//count each player's cooperations
+		if (player_a_cooperates) result.cooperations += 1;
+		else result.defections += 1;
+		if (player_b_cooperates) result.cooperations += 1;
+		else result.defections += 1;
+		
+		//gather payoffs from individual's decisions
+		game_payoffs.payoffsFromChoices(player_a_cooperates, player_b_cooperates, player_a_payoff, player_b_payoff);
+		
+		//add payoffs to player's stats
+		result.player_a_payoff_sum += player_a_payoff;
+		result.player_b_payoff_sum += player_b_payoff;
+		
+		//Play subsequent iterations
+		player_a_cooperates = player_a.decide(player_a_payoff, player_b_payoff, state_a);
+		player_b_cooperates = player_b.decide(player_b_payoff, player_a_payoff, state_b);
+	}
 	
-	//Strategies
-	std::cout << "# STRATEGIES are [always defect, always cooperate, tit for tat, tit for two tats, pavlov-like]\n";
-	printMatrix<int, STRATEGIES_COUNT>(strategies_count, std::string("strategies_count"));
+	return result;
 }
+
+
+/**---------- Available precisions ----------**/
+
+template class BasicSimulation<NeuralNetwork>;
+template class BasicSimulation<FloatNeuralNetwork>;
+template class BasicSimulation<FixedNeuralNetwork>;
+template class BasicSimulation<DenseNetwork>;
+
+template MatchResult playMatch<NeuralNetwork>(const Payoffs& game_payoffs, const NeuralNetwork& player_a, 
+	NeuralNetwork::State& state_a, const NeuralNetwork& player_b, NeuralNetwork::State& state_b);
+template MatchResult playMatch<FloatNeuralNetwork>(const Payoffs& game_payoffs, const FloatNeuralNetwork& player_a, 
+	FloatNeuralNetwork::State& state_a, const FloatNeuralNetwork& player_b, FloatNeuralNetwork::State& state_b);
+template MatchResult playMatch<FixedNeuralNetwork>(const Payoffs& game_payoffs, const FixedNeuralNetwork& player_a, 
+	FixedNeuralNetwork::State& state_a, const FixedNeuralNetwork& player_b, FixedNeuralNetwork::State& state_b);
+template MatchResult playMatch<DenseNetwork>(const Payoffs& game_payoffs, const DenseNetwork& player_a, 
+	DenseNetwork::State& state_a, const DenseNetwork& player_b, DenseNetwork::State& state_b);
@@ -0,0 +1,254 @@
+#include "SimulationTest.hpp"
+
+
+void testSimulation()
+{
+	std::cout << "Testing Simulation...";
+	
+	const Payoffs payoffs = Payoffs::getPayoffsForGameType("IPD");
+	
+	///Reference run
+	RNG::setSeed(SIMULATION_TEST_SEED);
+	Simulation reference(payoffs);
+	reference.run(SIMULATION_TEST_GENERATIONS);
+	
+	///Stepping gives the same results, with a callback after every generation
+	RNG::setSeed(SIMULATION_TEST_SEED);
+	Simulation stepped(payoffs);
+	unsigned long callbacks = 0;
+	stepped.setGenerationCallback([&](const GenerationView<NeuralNetwork>& view) {
+		assert(view.generation == callbacks);
+		assert(view.population_size == POPULATION_SIZE);
+		assert(view.strategies != nullptr);
+		
+		//the view shows the generation's own data and genomes
+		int strategy_total = 0;
+		for (int strat_index=0; strat_index<view.strategy_count; ++strat_index) {
+			strategy_total += view.strategies[strat_index];
+		}
+		assert(strategy_total == POPULATION_SIZE);
+		for (int i=0; i<POPULATION_SIZE; ++i) {
+			assert(view.intelligence[i] == view.population[i]->getInnerNodeCount());
+			assert(view.fitness[i] == reference.getPopulationFitness()[view.generation][i]);
+		}
+		assert(view.cooperation_frequency == reference.getCooperationFrequency()[view.generation][0]);
+		callbacks++;
+	});
+	
+	stepped.start(SIMULATION_TEST_GENERATIONS);
+	while (stepped.getGeneration() < SIMULATION_TEST_GENERATIONS) {
+		stepped.step();
+	}
+	stepped.finish();
+	
+	assert(callbacks == SIMULATION_TEST_GENERATIONS);
+	assert(stepped.getPopulationIntelligence() == reference.getPopulationIntelligence());
+	assert(stepped.getPopulationFitness() == reference.getPopulationFitness());
+	assert(stepped.getStrategiesCount() == reference.getStrategiesCount());
+	
+	///Stepping past the number of generations is an error
+	bool rejected = false;
+	try {
+		stepped.step();
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	assert(rejected);
+	
+	///Moran process: reproducible, with every individual assessed after each generation's events
+	SimulationSettings moran_settings;
+	moran_settings.moran = true;
+	RNG::setSeed(SIMULATION_TEST_SEED);
+	Simulation moran(payoffs, moran_settings);
+	moran.setGenerationCallback([&](const GenerationView<NeuralNetwork>& view) {
+		assert(view.cooperation_frequency >= 0 and view.cooperation_frequency <= 1);
+		for (int i=0; i<POPULATION_SIZE; ++i) {
+			assert(view.intelligence[i] == view.population[i]->getInnerNodeCount());
+			assert(std::isfinite(view.fitness[i]));
+		}
+	});
+	moran.run(SIMULATION_TEST_GENERATIONS);
+	
+	RNG::setSeed(SIMULATION_TEST_SEED);
+	Simulation moran_again(payoffs, moran_settings);
+	moran_again.run(SIMULATION_TEST_GENERATIONS);
+	assert(moran_again.getPopulationFitness() == moran.getPopulationFitness());
+	assert(moran.getPopulationFitness() != reference.getPopulationFitness());
+	
+	//the steady states of whole generations do not apply
+	moran_settings.steady_window = SIMULATION_TEST_GENERATIONS;
+	Simulation moran_steady(payoffs, moran_settings);
+	rejected = false;
+	try {
+		moran_steady.start(SIMULATION_TEST_GENERATIONS);
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	assert(rejected);
+	
+	///Fast-forward: every evaluation of the population needs a new window of evaluated generations
+	SimulationSettings steady_settings;
+	steady_settings.steady_window = SIMULATION_TEST_STEADY_WINDOW;
+	steady_settings.steady_action = STEADY_ACTION_FAST_FORWARD;
+	RNG::setSeed(SIMULATION_TEST_STEADY_SEED);
+	Simulation fast_forward(payoffs, steady_settings);
+	fast_forward.run(SIMULATION_TEST_STEADY_GENERATIONS);
+	
+	unsigned fast_forwards = 0, evaluated = 0;
+	for (const std::array<int, 1>& skipped : fast_forward.getFastForwarded()) {
+		if (skipped[0] == 1) {
+			//the generations before a fast-forward (even a previous one) do not make a population steady
+			if (evaluated > 0) {
+				assert(evaluated >= SIMULATION_TEST_STEADY_WINDOW);
+				fast_forwards++;
+			}
+			evaluated = 0;
+		}
+		else {
+			evaluated++;
+		}
+	}
+	assert(fast_forwards > 1); //the population is evaluated again after a fast-forward
+	
+	///Shards: the results do not depend on the number of workers nor on the transport
+	SimulationSettings shard_settings;
+	shard_settings.shards = 1;
+	RNG::setSeed(SIMULATION_TEST_SEED);
+	Simulation one_shard(payoffs, shard_settings);
+	one_shard.run(SIMULATION_TEST_GENERATIONS);
+	
+	shard_settings.shards = SIMULATION_TEST_SHARDS;
+	RNG::setSeed(SIMULATION_TEST_SEED);
+	Simulation socket_shards(payoffs, shard_settings);
+	socket_shards.run(SIMULATION_TEST_GENERATIONS);
+	assert(socket_shards.getPopulationFitness() == one_shard.getPopulationFitness());
+	
+	shard_settings.shard_transport = "shm";
+	RNG::setSeed(SIMULATION_TEST_SEED);
+	Simulation shm_shards(payoffs, shard_settings);
+	shm_shards.run(SIMULATION_TEST_GENERATIONS);
+	assert(shm_shards.getPopulationFitness() == one_shard.getPopulationFitness());
+	
+	///Autotuning the tournament threads does not change the results, and caches its choice
+	std::remove(SIMULATION_TEST_AUTOTUNE_CACHE);
+	SimulationSettings one_thread_settings, autotune_settings;
+	one_thread_settings.tournament_threads = 1;
+	autotune_settings.tournament_threads = SIMULATION_TEST_AUTOTUNE_THREADS;
+	autotune_settings.autotune = true;
+	autotune_settings.autotune_cache = SIMULATION_TEST_AUTOTUNE_CACHE;
+	const unsigned autotune_generations = 3 * AUTOTUNE_ROUNDS; //every candidate is timed
+	
+	RNG::setSeed(SIMULATION_TEST_SEED);
+	Simulation one_thread(payoffs, one_thread_settings);
+	one_thread.run(autotune_generations);
+	RNG::setSeed(SIMULATION_TEST_SEED);
+	Simulation autotuned(payoffs, autotune_settings);
+	autotuned.run(autotune_generations);
+	assert(autotuned.getPopulationFitness() == one_thread.getPopulationFitness());
+	
+	std::ifstream cache(SIMULATION_TEST_AUTOTUNE_CACHE);
+	std::string cache_key;
+	unsigned cached_threads = 0;
+	cache >> cache_key >> cached_threads;
+	assert(cached_threads == 1 or cached_threads == 2 or cached_threads == SIMULATION_TEST_AUTOTUNE_THREADS);
+	assert(cache_key.find(",nodes=") != std::string::npos); //the size of the networks sets the cost of a match
+	std::remove(SIMULATION_TEST_AUTOTUNE_CACHE);
+	
+	//shards do not play on tournament threads
+	autotune_settings.shards = SIMULATION_TEST_SHARDS;
+	Simulation autotuned_shards(payoffs, autotune_settings);
+	rejected = false;
+	try {
+		autotuned_shards.start(SIMULATION_TEST_GENERATIONS);
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	assert(rejected);
+	
+	//workers replace the tournament threads
+	shard_settings.tournament_threads = 2;
+	Simulation threaded_shards(payoffs, shard_settings);
+	rejected = false;
+	try {
+		threaded_shards.start(SIMULATION_TEST_GENERATIONS);
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	assert(rejected);
+	
+	///Variance reduction: the estimates and their precision do not depend on the number of threads
+	SimulationSettings reduced_settings;
+	reduced_settings.variance_reduction = true;
+	reduced_settings.pair_matches = SIMULATION_TEST_PAIR_MATCHES;
+	RNG::setSeed(SIMULATION_TEST_SEED);
+	Simulation reduced(payoffs, reduced_settings);
+	reduced.run(SIMULATION_TEST_GENERATIONS);
+	
+	reduced_settings.tournament_threads = SIMULATION_TEST_REDUCED_THREADS;
+	RNG::setSeed(SIMULATION_TEST_SEED);
+	Simulation reduced_threads(payoffs, reduced_settings);
+	reduced_threads.run(SIMULATION_TEST_GENERATIONS);
+	assert(reduced_threads.getPopulationFitness() == reduced.getPopulationFitness());
+	assert(reduced_threads.getFitnessVariance() == reduced.getFitnessVariance());
+	assert(reduced.getFitnessVariance().size() == SIMULATION_TEST_GENERATIONS);
+	assert(reduced.getEffectiveSampleSize().size() == SIMULATION_TEST_GENERATIONS);
+	for (unsigned generation=0; generation<SIMULATION_TEST_GENERATIONS; ++generation) {
+		assert(reduced.getFitnessVariance()[generation][0] >= 0);
+		assert(reduced.getEffectiveSampleSize()[generation][0] >= 0);
+	}
+	assert(reduced.getEffectiveSampleSize()[0][0] > 0); //random networks make random decisions
+	assert(one_thread.getFitnessVariance().empty());
+	
+	//the reported variance is that of the estimates of the same population across the tournaments' seeds
+	reduced_settings.tournament_threads = 0;
+	reduced_settings.pair_matches = SIMULATION_TEST_VARIANCE_UNITS;
+	std::vector<RunningStats> estimates(POPULATION_SIZE);
+	RunningStats reported_variance;
+	for (unsigned replicate=0; replicate<SIMULATION_TEST_VARIANCE_REPLICATES; ++replicate) {
+		RNG::setSeed(SIMULATION_TEST_SEED);
+		Simulation replicated(payoffs, reduced_settings);
+		RNG::setSeed(SIMULATION_TEST_SEED + 1 + replicate); //the units' streams derive from the seed
+		replicated.start(1);
+		replicated.step();
+		for (int i=0; i<POPULATION_SIZE; ++i) {
+			estimates[i].add(replicated.getPopulationFitness()[0][i]);
+		}
+		reported_variance.add(replicated.getFitnessVariance()[0][0]);
+	}
+	RunningStats empirical_variance;
+	for (int i=0; i<POPULATION_SIZE; ++i) {
+		empirical_variance.add(estimates[i].variance());
+	}
+	assert(std::fabs(reported_variance.mean() / empirical_variance.mean() - 1) < SIMULATION_TEST_VARIANCE_TOLERANCE);
+	
+	//several units per pair need variance reduction, which replaces the Moran process' matches
+	SimulationSettings units_settings;
+	units_settings.pair_matches = SIMULATION_TEST_PAIR_MATCHES;
+	Simulation units_only(payoffs, units_settings);
+	rejected = false;
+	try {
+		units_only.start(SIMULATION_TEST_GENERATIONS);
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	assert(rejected);
+	
+	reduced_settings.tournament_threads = 0;
+	reduced_settings.moran = true;
+	Simulation reduced_moran(payoffs, reduced_settings);
+	rejected = false;
+	try {
+		reduced_moran.start(SIMULATION_TEST_GENERATIONS);
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	assert(rejected);
+	
+	std::cout << " done!" << std::endl;
+}
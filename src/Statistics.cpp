@@ -0,0 +1,303 @@
+#include "Statistics.hpp"
+
+
+double Statistics::mean(const std::vector<double>& sample)
+{
+	assert(not sample.empty());
+	
+	double sum = 0;
+	for (double value : sample) sum += value;
+	return sum / static_cast<double>(sample.size());
+}
+
+double Statistics::variance(const std::vector<double>& sample)
+{
+	if (sample.size() < 2) return 0;
+	
+	double sample_mean = mean(sample);
+	double squares = 0;
+	for (double value : sample) squares += (value - sample_mean) * (value - sample_mean);
+	return squares / static_cast<double>(sample.size() - 1);
+}
+
+/*Walks through both sorted samples and tracks the difference of their empirical distributions*/
+double Statistics::ksStatistic(std::vector<double> sample_a, std::vector<double> sample_b)
+{
+	assert(not sample_a.empty() and not sample_b.empty());
+	std::sort(sample_a.begin(), sample_a.end());
+	std::sort(sample_b.begin(), sample_b.end());
+	
+	double size_a = static_cast<double>(sample_a.size());
+	double size_b = static_cast<double>(sample_b.size());
+	std::size_t index_a = 0, index_b = 0;
+	double distance = 0;
+	
+	while (index_a < sample_a.size() and index_b < sample_b.size()) {
+		//advance past every occurrence of the smallest current value (ties move together)
+		double value = std::min(sample_a[index_a], sample_b[index_b]);
+		while (index_a < sample_a.size() and sample_a[index_a] == value) index_a++;
+		while (index_b < sample_b.size() and sample_b[index_b] == value) index_b++;
+		
+		double difference = std::fabs(static_cast<double>(index_a) / size_a - static_cast<double>(index_b) / size_b);
+		distance = std::max(distance, difference);
+	}
+	
+	return distance;
+}
+
+/*Uses the Kolmogorov distribution with the usual small-sample correction of the statistic*/
+double Statistics::ksPValue(const std::vector<double>& sample_a, const std::vector<double>& sample_b)
+{
+	double distance = ksStatistic(sample_a, sample_b);
+	double size_a = static_cast<double>(sample_a.size());
+	double size_b = static_cast<double>(sample_b.size());
+	double effective_size = std::sqrt(size_a * size_b / (size_a + size_b));
+	double lambda = (effective_size + 0.12 + 0.11 / effective_size) * distance;
+	
+	if (lambda < 1e-3) return 1; //the series converges too slowly, samples are identical anyway
+	
+	double p_value = 0, sign = 1;
+	for (int term=1; term<=KS_SERIES_TERMS; ++term) {
+		p_value += sign * 2 * std::exp(-2 * term * term * lambda * lambda);
+		sign = -sign;
+	}
+	
+	return std::min(1.0, std::max(0.0, p_value));
+}
+
+/*Compares the observed counts with the counts expected if both rows shared the same distribution*/
+double Statistics::chiSquaredStatistic(const std::vector<double>& counts_a, const std::vector<double>& counts_b, int& degrees)
+{
+	assert(counts_a.size() == counts_b.size());
+	
+	double total_a = 0, total_b = 0;
+	for (std::size_t category=0; category<counts_a.size(); ++category) {
+		total_a += counts_a[category];
+		total_b += counts_b[category];
+	}
+	assert(total_a > 0 and total_b > 0);
+	double total = total_a + total_b;
+	
+	double statistic = 0;
+	int categories = 0;
+	for (std::size_t category=0; category<counts_a.size(); ++category) {
+		double category_total = counts_a[category] + counts_b[category];
+		if (category_total == 0) continue;
+		
+		double expected_a = total_a * category_total / total;
+		double expected_b = total_b * category_total / total;
+		statistic += (counts_a[category] - expected_a) * (counts_a[category] - expected_a) / expected_a;
+		statistic += (counts_b[category] - expected_b) * (counts_b[category] - expected_b) / expected_b;
+		categories++;
+	}
+	
+	degrees = categories - 1;
+	return statistic;
+}
+
+double Statistics::chiSquaredPValue(double statistic, int degrees)
+{
+	if (degrees <= 0) return 1; //a single category cannot differ
+	return upperIncompleteGamma(degrees / 2.0, statistic / 2.0);
+}
+
+double Statistics::chiSquaredPValue(const std::vector<double>& counts_a, const std::vector<double>& counts_b)
+{
+	int degrees;
+	double statistic = chiSquaredStatistic(counts_a, counts_b, degrees);
+	return chiSquaredPValue(statistic, degrees);
+}
+
+/*
+Uses the series of the lower function below x = a + 1 and the continued fraction of the upper
+function above (modified Lentz's method), where each converges quickly.*/
+double Statistics::upperIncompleteGamma(double a, double x)
+{
+	assert(a > 0 and x >= 0);
+	if (x == 0) return 1;
+	
+	double log_prefactor = a * std::log(x) - x - std::lgamma(a);
+	
+	if (x < a + 1) {
+		double term = 1 / a, sum = term;
+		for (int n=1; n<GAMMA_MAX_ITERATIONS and std::fabs(term) > std::fabs(sum) * GAMMA_EPSILON; ++n) {
+			term *= x / (a + n);
+			sum += term;
+		}
+		return std::max(0.0, 1 - sum * std::exp(log_prefactor));
+	}
+	
+	const double tiny = 1e-300; //replaces zero denominators
+	double b = x + 1 - a, c = 1 / tiny, d = 1 / b, fraction = d;
+	for (int n=1; n<GAMMA_MAX_ITERATIONS; ++n) {
+		double an = -n * (n - a);
+		b += 2;
+		d = an * d + b;
+		if (std::fabs(d) < tiny) d = tiny;
+		c = b + an / c;
+		if (std::fabs(c) < tiny) c = tiny;
+		d = 1 / d;
+		double delta = d * c;
+		fraction *= delta;
+		if (std::fabs(delta - 1) < GAMMA_EPSILON) break;
+	}
+	return std::min(1.0, fraction * std::exp(log_prefactor));
+}
+
+
+/**---------- RunningStats ----------**/
+
+void RunningStats::add(double value)
+{
+	count++;
+	double delta = value - running_mean;
+	running_mean += delta / static_cast<double>(count);
+	squares += delta * (value - running_mean);
+}
+
+unsigned long RunningStats::getCount() const
+{
+	return count;
+}
+
+double RunningStats::mean() const
+{
+	return running_mean;
+}
+
+double RunningStats::variance() const
+{
+	return (count < 2) ? 0 : squares / static_cast<double>(count - 1);
+}
+
+
+/**---------- RunningCovariance ----------**/
+
+void RunningCovariance::add(double x, double y)
+{
+	count++;
+	double delta_x = x - mean_x;
+	mean_x += delta_x / static_cast<double>(count);
+	mean_y += (y - mean_y) / static_cast<double>(count);
+	co_moment += delta_x * (y - mean_y);
+}
+
+unsigned long RunningCovariance::getCount() const
+{
+	return count;
+}
+
+double RunningCovariance::meanX() const
+{
+	return mean_x;
+}
+
+double RunningCovariance::meanY() const
+{
+	return mean_y;
+}
+
+double RunningCovariance::covariance() const
+{
+	return (count < 2) ? 0 : co_moment / static_cast<double>(count - 1);
+}
+
+
+/**---------- P2Quantile ----------**/
+
+P2Quantile::P2Quantile(double quantile_probability):
+	probability(quantile_probability),
+	heights(),
+	positions(),
+	desired(),
+	increments()
+{
+	assert(probability >= 0 and probability <= 1);
+}
+
+void P2Quantile::add(double value)
+{
+	//The first values initialize the markers
+	if (count < P2_MARKERS) {
+		heights[count++] = value;
+		if (count == P2_MARKERS) {
+			std::sort(heights.begin(), heights.end());
+			positions = {{1, 2, 3, 4, 5}};
+			desired = {{1, 1 + 2*probability, 1 + 4*probability, 3 + 2*probability, 5}};
+			increments = {{0, probability/2, probability, (1 + probability)/2, 1}};
+		}
+		return;
+	}
+	count++;
+	
+	//Find the cell containing the value, extending the extreme markers if needed
+	int cell;
+	if (value < heights[0]) {
+		heights[0] = value;
+		cell = 0;
+	}
+	else if (value >= heights[P2_MARKERS-1]) {
+		heights[P2_MARKERS-1] = value;
+		cell = P2_MARKERS - 2;
+	}
+	else {
+		cell = 0;
+		while (value >= heights[cell+1]) cell++;
+	}
+	
+	//Shift the positions of the markers above the value
+	for (int marker=cell+1; marker<P2_MARKERS; ++marker) positions[marker] += 1;
+	for (int marker=0; marker<P2_MARKERS; ++marker) desired[marker] += increments[marker];
+	
+	//Move the middle markers towards their desired positions
+	for (int marker=1; marker<P2_MARKERS-1; ++marker) {
+		double offset = desired[marker] - positions[marker];
+		if ((offset >= 1 and positions[marker+1] - positions[marker] > 1) 
+			or (offset <= -1 and positions[marker-1] - positions[marker] < -1)) {
+			double direction = (offset >= 0) ? 1 : -1;
+			double height = parabolic(marker, direction);
+			
+			//fall back to linear interpolation if the parabola breaks the ordering of heights
+			if (heights[marker-1] < height and height < heights[marker+1])
+				heights[marker] = height;
+			else
+				heights[marker] = linear(marker, direction);
+			positions[marker] += direction;
+		}
+	}
+}
+
+/*Piecewise-parabolic prediction of a marker's height after moving it by direction (+1 or -1)*/
+double P2Quantile::parabolic(int marker, double direction) const
+{
+	double below = positions[marker] - positions[marker-1];
+	double above = positions[marker+1] - positions[marker];
+	double span = positions[marker+1] - positions[marker-1];
+	
+	return heights[marker] + direction / span * (
+		(below + direction) * (heights[marker+1] - heights[marker]) / above
+		+ (above - direction) * (heights[marker] - heights[marker-1]) / below);
+}
+
+double P2Quantile::linear(int marker, double direction) const
+{
+	int neighbour = marker + static_cast<int>(direction);
+	return heights[marker] + direction * (heights[neighbour] - heights[marker]) / (positions[neighbour] - positions[marker]);
+}
+
+unsigned long P2Quantile::getCount() const
+{
+	return count;
+}
+
+/*Middle marker estimate, or nearest-rank quantile of the first values*/
+double P2Quantile::quantile() const
+{
+	if (count == 0) return 0;
+	if (count >= P2_MARKERS) return heights[2];
+	
+	std::array<double, P2_MARKERS> first_values = heights;
+	std::sort(first_values.begin(), first_values.begin() + count);
+	std::size_t rank = static_cast<std::size_t>(std::lround(probability * static_cast<double>(count - 1)));
+	return first_values[rank];
+}
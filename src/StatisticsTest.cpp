@@ -0,0 +1,68 @@
+#include "StatisticsTest.hpp"
+
+
+void testStatistics()
+{
+	std::cout << "Testing Statistics...";
+	
+	///Mean and variance
+	std::vector<double> sample = {1, 2, 3, 4};
+	assert(Statistics::mean(sample) == 2.5);
+	assert(std::fabs(Statistics::variance(sample) - 5.0/3.0) < 1e-12);
+	
+	///KS statistic of disjoint and identical samples
+	std::vector<double> low = {1, 2, 3}, high = {4, 5, 6};
+	assert(Statistics::ksStatistic(low, high) == 1);
+	assert(Statistics::ksStatistic(low, low) == 0);
+	assert(Statistics::ksPValue(low, low) == 1);
+	
+	///KS test on samples from the same and from different distributions
+	std::vector<double> sample_a, sample_b, sample_shifted;
+	for (int i=0; i<STATISTICS_TEST_SAMPLE_SIZE; ++i) {
+		sample_a.push_back(RNG::getRandomNumval());
+		sample_b.push_back(RNG::getRandomNumval());
+		sample_shifted.push_back(RNG::getRandomNumval() + 0.5);
+	}
+	assert(Statistics::ksPValue(sample_a, sample_b) > 1e-4); //fails once in 10000 runs
+	assert(Statistics::ksPValue(sample_a, sample_shifted) < 1e-4);
+	
+	///Chi-squared distribution and homogeneity test
+	assert(std::fabs(Statistics::chiSquaredPValue(3.841459, 1) - 0.05) < 1e-6);
+	assert(std::fabs(Statistics::chiSquaredPValue(18.307038, 10) - 0.05) < 1e-6);
+	assert(std::fabs(Statistics::chiSquaredPValue(2.0, 2) - std::exp(-1.0)) < 1e-12);
+	std::vector<double> counts = {10, 20, 0, 30}, scaled_counts = {20, 40, 0, 60}, other_counts = {40, 10, 0, 10};
+	int degrees;
+	assert(Statistics::chiSquaredStatistic(counts, scaled_counts, degrees) == 0 and degrees == 2);
+	assert(Statistics::chiSquaredPValue(counts, scaled_counts) == 1);
+	assert(Statistics::chiSquaredPValue(counts, other_counts) < 1e-6);
+	
+	///Streaming estimators match their batch counterparts
+	RunningStats running;
+	RunningCovariance covariance, self_covariance;
+	P2Quantile median(0.5), decile(0.1);
+	for (std::size_t i=0; i<sample_a.size(); ++i) {
+		running.add(sample_a[i]);
+		covariance.add(sample_a[i], sample_shifted[i]);
+		self_covariance.add(sample_a[i], 2 * sample_a[i]);
+		median.add(sample_a[i]);
+		decile.add(sample_a[i]);
+	}
+	assert(running.getCount() == sample_a.size());
+	assert(std::fabs(running.mean() - Statistics::mean(sample_a)) < 1e-9);
+	assert(std::fabs(running.variance() - Statistics::variance(sample_a)) < 1e-9);
+	assert(std::fabs(self_covariance.covariance() - 2 * Statistics::variance(sample_a)) < 1e-9);
+	assert(std::fabs(covariance.covariance()) < 0.2); //independent samples of variance 1
+	
+	std::sort(sample_a.begin(), sample_a.end());
+	assert(std::fabs(median.quantile() - sample_a[sample_a.size() / 2]) < 0.2);
+	assert(std::fabs(decile.quantile() - sample_a[sample_a.size() / 10]) < 0.2);
+	
+	///Quantiles of small samples are exact
+	P2Quantile small_median(0.5);
+	small_median.add(3);
+	small_median.add(1);
+	small_median.add(2);
+	assert(small_median.quantile() == 2);
+	
+	std::cout << " done!" << std::endl;
+}
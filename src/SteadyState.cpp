@@ -0,0 +1,89 @@
+#include "SteadyState.hpp"
+#include "DenseNetwork.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+
+SteadyStateDetector::SteadyStateDetector(unsigned window_size):
+	window(window_size)
+{
+	assert(window > 1);
+}
+
+/*Returns the share of the most common pair of cognitive and context node counts*/
+template<typename Network>
+double SteadyStateDetector::structureShare(Network* const* population, int population_size)
+{
+	std::map<std::pair<int, int>, int> structures;
+	int most_common = 0;
+	for (int i=0; i<population_size; ++i) {
+		int& count = structures[std::make_pair(population[i]->getCognitiveNodeCount(), population[i]->getContextNodeCount())];
+		most_common = std::max(most_common, ++count);
+	}
+	return static_cast<double>(most_common) / population_size;
+}
+
+/*Slides the window by one generation*/
+bool SteadyStateDetector::update(double cooperation_frequency, double mean_intelligence, double structure_share)
+{
+	cooperation_window.push_back(cooperation_frequency);
+	intelligence_window.push_back(mean_intelligence);
+	structure_window.push_back(structure_share);
+	
+	if (cooperation_window.size() > window) {
+		cooperation_window.pop_front();
+		intelligence_window.pop_front();
+		structure_window.pop_front();
+	}
+	return isSteady();
+}
+
+/*Difference between the means of the second and first halves of the window*/
+double SteadyStateDetector::drift(const std::deque<double>& values)
+{
+	std::size_t half = values.size() / 2;
+	double first_half = std::accumulate(values.begin(), values.begin() + static_cast<long>(half), 0.0) / static_cast<double>(half);
+	double second_half = std::accumulate(values.end() - static_cast<long>(half), values.end(), 0.0) / static_cast<double>(half);
+	return std::fabs(second_half - first_half);
+}
+
+double SteadyStateDetector::mean(const std::deque<double>& values)
+{
+	return std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+}
+
+/*True once the window is full and every metric stayed within its limits*/
+bool SteadyStateDetector::isSteady() const
+{
+	return cooperation_window.size() == window
+		and mean(structure_window) >= STEADY_STRUCTURE_SHARE
+		and drift(cooperation_window) <= STEADY_COOPERATION_TOLERANCE
+		and drift(intelligence_window) <= STEADY_INTELLIGENCE_TOLERANCE;
+}
+
+void SteadyStateDetector::reset()
+{
+	cooperation_window.clear();
+	intelligence_window.clear();
+	structure_window.clear();
+}
+
+std::string SteadyStateDetector::describe() const
+{
+	if (not isSteady()) return "";
+	
+	return "over " + std::to_string(window) + " generations, cooperation frequency drifted by " 
+		+ std::to_string(drift(cooperation_window)) + ", mean intelligence by " 
+		+ std::to_string(drift(intelligence_window)) + ", and the most common structure held " 
+		+ std::to_string(mean(structure_window)) + " of the population";
+}
+
+
+/**---------- Available precisions ----------**/
+
+template double SteadyStateDetector::structureShare<NeuralNetwork>(NeuralNetwork* const* population, int population_size);
+template double SteadyStateDetector::structureShare<FloatNeuralNetwork>(FloatNeuralNetwork* const* population, int population_size);
+template double SteadyStateDetector::structureShare<FixedNeuralNetwork>(FixedNeuralNetwork* const* population, int population_size);
+template double SteadyStateDetector::structureShare<DenseNetwork>(DenseNetwork* const* population, int population_size);
@@ -0,0 +1,63 @@
+#include "SteadyStateTest.hpp"
+
+
+void testSteadyState()
+{
+	std::cout << "Testing SteadyState...";
+	
+	///Steady once the window is full of stable generations
+	SteadyStateDetector detector(STEADY_TEST_WINDOW);
+	for (int generation=0; generation<STEADY_TEST_WINDOW-1; ++generation) {
+		assert(not detector.update(0.9, 1.0, 1.0));
+	}
+	assert(detector.update(0.9, 1.0, 1.0));
+	assert(not detector.describe().empty());
+	
+	///Noise around a stable mean is still steady
+	for (int generation=0; generation<STEADY_TEST_WINDOW; ++generation) {
+		assert(detector.update((generation % 2 == 0) ? 0.85 : 0.95, 1.0, 1.0));
+	}
+	
+	///A drifting cooperation frequency or intelligence is not steady
+	for (int generation=0; generation<STEADY_TEST_WINDOW; ++generation) {
+		detector.update(0.5 + 0.02 * generation, 1.0, 1.0);
+	}
+	assert(not detector.isSteady());
+	for (int generation=0; generation<STEADY_TEST_WINDOW; ++generation) {
+		detector.update(0.9, 0.1 * generation, 1.0);
+	}
+	assert(not detector.isSteady());
+	assert(detector.describe().empty());
+	
+	///A diverse structure is not steady
+	for (int generation=0; generation<STEADY_TEST_WINDOW; ++generation) {
+		detector.update(0.9, 1.0, 0.5);
+	}
+	assert(not detector.isSteady());
+	
+	///Reset forgets the window
+	for (int generation=0; generation<STEADY_TEST_WINDOW; ++generation) {
+		detector.update(0.9, 1.0, 1.0);
+	}
+	assert(detector.isSteady());
+	detector.reset();
+	assert(not detector.update(0.9, 1.0, 1.0));
+	
+	///Share of the most common structure
+	NeuralNetwork* population[STEADY_TEST_POPULATION];
+	for (int i=0; i<STEADY_TEST_POPULATION; ++i) {
+		population[i] = new NeuralNetwork();
+		while (population[i]->getInnerNodeCount() > 0) population[i]->removeNode();
+	}
+	assert(SteadyStateDetector::structureShare(population, STEADY_TEST_POPULATION) == 1.0);
+	for (int i=0; i<3; ++i) {
+		population[i]->addNode();
+	}
+	assert(SteadyStateDetector::structureShare(population, STEADY_TEST_POPULATION) >= 0.7);
+	assert(SteadyStateDetector::structureShare(population, STEADY_TEST_POPULATION) < 1.0);
+	for (int i=0; i<STEADY_TEST_POPULATION; ++i) {
+		delete population[i];
+	}
+	
+	std::cout << " done!" << std::endl;
+}
@@ -1,121 +1,350 @@
 #include "Strategies.hpp"
+#include "DenseNetwork.hpp"
+#include "MarkovGame.hpp"
 
 
 /*Constructor*/
-Strategies::Strategies(const Payoffs& payoffs) :
-	game_payoffs(payoffs)
+Strategies::Strategies(const Payoffs& payoffs, const std::vector<StrategyMachine>& strategies, bool exact) :
+	game_payoffs(payoffs),
+	exact_classification(exact),
+	machines(strategies)
 {
-	initStrategies();
+	assert(not machines.empty() and machines.size() <= STRATEGIES_MAX);
+	
+	initOpponent();
+	for (const StrategyMachine& machine : machines) {
+		initStrategy(machine);
+	}
 }
 
-/*
-Initializes the average cooperation per assessment that correspond to each pure strategy.
-Each assessment is made of 20 moves (a move is a decision -cooperate or defect- in a game iteration)
-The network's moves will be compared to these moves to determine which is their closest pure strategy.*/
-void Strategies::initStrategies()
+/**---------- Registries ----------**/
+
+/*The strategies of the original experiment, at their STRATEGIES_* index*/
+std::vector<StrategyMachine> Strategies::classicStrategies()
+{
+	//states are {cooperation probability}, transitions are {after defection, after cooperation}
+	return {
+		{"always defect", 0, {0}, {{{0, 0}}}},
+		{"always cooperate", 0, {1}, {{{0, 0}}}},
+		//cooperate, defect
+		{"tit for tat", 0, {1, 0}, {{{1, 0}}, {{1, 0}}}},
+		//cooperate, cooperate after one defection, defect
+		{"tit for two tats", 0, {1, 1, 0}, {{{1, 0}}, {{2, 0}}, {{2, 0}}}},
+		//cooperate, defect: stay after mutual choices, switch otherwise
+		{"pavlov-like", 0, {1, 0}, {{{1, 0}}, {{0, 1}}}}
+	};
+}
+
+/*Classic strategies followed by other well-known ones*/
+std::vector<StrategyMachine> Strategies::extendedStrategies()
+{
+	std::vector<StrategyMachine> strategies = classicStrategies();
+	
+	//cooperate, defect forever
+	strategies.push_back({"grim trigger", 0, {1, 0}, {{{1, 0}}, {{1, 1}}}});
+	//tit for tat starting with a defection
+	strategies.push_back({"suspicious tit for tat", 1, {1, 0}, {{{1, 0}}, {{1, 0}}}});
+	//cooperate, forgive a defection with some probability
+	strategies.push_back({"generous tit for tat", 0, {1, STRATEGIES_GENEROSITY}, {{{1, 0}}, {{1, 0}}}});
+	//cooperate, defect twice after a defection
+	strategies.push_back({"two tits for tat", 0, {1, 0, 0}, {{{2, 0}}, {{2, 0}}, {{2, 1}}}});
+	//cooperate, defect while one of the last two opponent moves is a defection
+	strategies.push_back({"hard tit for tat", 0, {1, 0, 0}, {{{1, 0}}, {{1, 2}}, {{1, 0}}}});
+	//cooperate and defect in turn
+	strategies.push_back({"alternator", 0, {1, 0}, {{{1, 1}}, {{0, 0}}}});
+	//cooperate or defect at random
+	strategies.push_back({"random", 0, {0.5}, {{{0, 0}}}});
+	
+	return strategies;
+}
+
+int Strategies::getStrategyCount() const
+{
+	return static_cast<int>(machines.size());
+}
+
+const std::string& Strategies::getStrategyName(int strat_index) const
+{
+	return machines.at(static_cast<std::size_t>(strat_index)).name;
+}
+
+const MoveSequence& Strategies::getStrategyMoves(int strat_index) const
+{
+	return strats_moves.at(static_cast<std::size_t>(strat_index));
+}
+
+const ExpectedMoves& Strategies::getStrategyExpectedMoves(int strat_index) const
+{
+	return strats_expected.at(static_cast<std::size_t>(strat_index));
+}
+
+bool Strategies::isExact() const
+{
+	return exact_classification;
+}
+
+
+/**---------- Initialization ----------**/
+
+/*The virtual opponent cooperates randomly, with a probability that increases with each assessment*/
+void Strategies::initOpponent()
 {
 	double coop_prob = 0; //Cooperation probability of virtual opponent
-	bool strat_cooperates; //Decision of strategy against virtual opponent
 	
 	for (int assessment_index=0; assessment_index<ASSESSMENT_COUNT; ++assessment_index){
-		//Initialize cooperation counts
-		for (int strat_index=0; strat_index<STRATEGIES_COUNT; ++strat_index) {
-			strats_avg_coop[strat_index][assessment_index] = 0;
-		}
-		
-		//Initialize previous choices for virtual opponent
-		for (int prev_choice_index=0; prev_choice_index<ASSESSMENT_PREV_CHOICES; ++prev_choice_index) {
-			opponent_choices[assessment_index][prev_choice_index] = RNG::getTrueWithProbability(coop_prob);
+		for (int iteration=0; iteration<ASSESSMENT_SIZE; ++iteration) {
+			opponent_choices[assessment_index][iteration] = RNG::getTrueWithProbability(coop_prob);
+			assessment_masks[assessment_index].set(static_cast<std::size_t>(assessment_index * ASSESSMENT_SIZE + iteration));
 		}
 		
-		//Initialize previous choice for pavlov strategy
-		bool prev_pavlov_choice = RNG::getTrueWithProbability(coop_prob); 
+		coop_prob += ASSESSMENT_PROB_STEP; //increase virtual opponent's cooperation probability
+	}
+}
+
+/*
+Plays the strategy's state machine against the virtual opponent and stores its moves.
+Each assessment is made of 20 moves (a move is a decision -cooperate or defect- in a game iteration)
+The network's moves will be compared to these moves to determine which is their closest pure strategy.
+The next state only depends on the opponent's move, so the states are known even for a stochastic
+strategy: its cooperation probability at each move is stored instead of a sampled move.*/
+void Strategies::initStrategy(const StrategyMachine& machine)
+{
+	assert(machine.cooperation.size() == machine.transitions.size());
+	
+	MoveSequence moves;
+	ExpectedMoves expected;
+	std::array<double, ASSESSMENT_COUNT> avg_coop;
+	bool stochastic = false;
+	
+	for (int assessment_index=0; assessment_index<ASSESSMENT_COUNT; ++assessment_index) {
+		int state = machine.initial_state;
+		double cooperation_sum = 0;
 		
-		for (int iteration=ASSESSMENT_PREV_CHOICES; iteration<ASSESSMENT_SIZE + ASSESSMENT_PREV_CHOICES; ++iteration) {
-			//The "virtual opponent" used to assess the network chooses to cooperate randomly
-			//(with probability coop_prob)
-			opponent_choices[assessment_index][iteration] = RNG::getTrueWithProbability(coop_prob);
-			
-			//Tit-for-tat imitates the opponent's previous decision (first choice is random)
-			strat_cooperates = opponent_choices[assessment_index][iteration-1];
-			if (strat_cooperates) strats_avg_coop[STRATEGIES_TIT_FOR_TAT][assessment_index] += 1;
+		for (int iteration=0; iteration<ASSESSMENT_SIZE; ++iteration) {
+			std::size_t move = static_cast<std::size_t>(assessment_index * ASSESSMENT_SIZE + iteration);
+			double probability = machine.cooperation[static_cast<std::size_t>(state)];
+			expected[move] = probability;
+			moves.set(move, probability >= 0.5);
+			stochastic = stochastic or (probability > 0 and probability < 1);
+			cooperation_sum += probability;
 			
-			//Tit-for-two-tats responds to two sequential defections with a defection, otherwise cooperates
-			strat_cooperates = opponent_choices[assessment_index][iteration-1] || opponent_choices[assessment_index][iteration-2];
-			if (strat_cooperates) strats_avg_coop[STRATEGIES_TIT_FOR_TWO_TATS][assessment_index] += 1;
-			
-			//Pavlov-like cooperates when two players previously made the same choice, defects otherwise
-			strat_cooperates = (opponent_choices[assessment_index][iteration-1] == prev_pavlov_choice);
-			if (strat_cooperates) strats_avg_coop[STRATEGIES_PAVLOV_LIKE][assessment_index] += 1;
-			prev_pavlov_choice = strat_cooperates;
+			state = machine.transitions[static_cast<std::size_t>(state)][opponent_choices[assessment_index][iteration] ? 1 : 0];
 		}
 		
-		//Transform cooperation counts into averages
-		strats_avg_coop[STRATEGIES_ALWAYS_DEFECT][assessment_index] = 0;
-		strats_avg_coop[STRATEGIES_ALWAYS_COOPERATE][assessment_index] = 1;
-		strats_avg_coop[STRATEGIES_TIT_FOR_TAT][assessment_index] /= ASSESSMENT_SIZE;
-		strats_avg_coop[STRATEGIES_TIT_FOR_TWO_TATS][assessment_index] /= ASSESSMENT_SIZE;
-		strats_avg_coop[STRATEGIES_PAVLOV_LIKE][assessment_index] /= ASSESSMENT_SIZE;
-		
-		coop_prob += ASSESSMENT_PROB_STEP; //increase virtual opponent's cooperation probability
+		avg_coop[assessment_index] = cooperation_sum / ASSESSMENT_SIZE;
 	}
+	
+	strats_moves.push_back(moves);
+	strats_expected.push_back(expected);
+	strats_stochastic.push_back(stochastic);
+	strats_avg_coop.push_back(avg_coop);
 }
 
-/*Makes the NeuralNetwork play against its virual opponent and returns the its closest pure strategy.*/
-int Strategies::closestPureStrategy(NeuralNetwork& player)
+
+/**---------- Classification ----------**/
+
+/*Makes the NeuralNetwork play against its virtual opponent and returns its moves.*/
+template<typename Network>
+MoveSequence Strategies::playAssessments(Network& player) const
+{
+	return playAssessments(static_cast<const Network&>(player), player.getCarryoverState());
+}
+
+/*Makes the NeuralNetwork play against its virtual opponent with the given state and returns its moves.*/
+template<typename Network>
+MoveSequence Strategies::playAssessments(const Network& player, typename Network::State& state) const
 {
 	payoff player_payoff, opponent_payoff; //results of each game iteration
-	
-	bool player_cooperates, opponent_cooperates;
+	MoveSequence player_moves;
 	
 	for (int assessment_index=0; assessment_index<ASSESSMENT_COUNT; ++assessment_index) {
-		//Initialize cooperation counts
-		player_avg_coop[assessment_index] = 0;
-		
 		//Play initial iteration (no input)
-		player_cooperates = player();
-		opponent_cooperates = opponent_choices[assessment_index][ASSESSMENT_PREV_CHOICES - 1];
+		bool player_cooperates = player();
 		
-		for (int iteration=ASSESSMENT_PREV_CHOICES; iteration<ASSESSMENT_SIZE + ASSESSMENT_PREV_CHOICES; ++iteration) {
-			//Increase the player's cooperation count
-			if (player_cooperates) player_avg_coop[assessment_index] += 1;
-			
-			//Gather payoffs from individual's decisions
-			game_payoffs.payoffsFromChoices(player_cooperates, opponent_cooperates, player_payoff, opponent_payoff);
+		for (int iteration=0; iteration<ASSESSMENT_SIZE; ++iteration) {
+			bool opponent_cooperates = opponent_choices[assessment_index][iteration];
+			player_moves.set(static_cast<std::size_t>(assessment_index * ASSESSMENT_SIZE + iteration), player_cooperates);
 			
 			//Play subsequent iterations
-			player_cooperates = player(player_payoff, opponent_payoff);
-			opponent_cooperates = opponent_choices[assessment_index][iteration];
+			if (iteration + 1 < ASSESSMENT_SIZE) {
+				game_payoffs.payoffsFromChoices(player_cooperates, opponent_cooperates, player_payoff, opponent_payoff);
+				player_cooperates = player.decide(player_payoff, opponent_payoff, state);
+			}
 		}
-		player_avg_coop[assessment_index] /= ASSESSMENT_SIZE; //transform cooperation count into average
 	}
 	
-	return compareChoices();
+	return player_moves;
+}
+
+/*Makes the NeuralNetwork play against its virual opponent and returns the its closest pure strategy.*/
+template<typename Network>
+int Strategies::closestPureStrategy(Network& player) const
+{
+	return closestPureStrategy(static_cast<const Network&>(player), player.getCarryoverState());
+}
+
+/*Returns the closest pure strategy of the NeuralNetwork playing with the given state.*/
+template<typename Network>
+int Strategies::closestPureStrategy(const Network& player, typename Network::State& state) const
+{
+	if (exact_classification and MarkovGame::isMarkovian(player))
+		return compareExpectedChoices(expectAssessments(player));
+	return compareChoices(playAssessments(player, state));
+}
+
+/*
+Returns the probability that a NeuralNetwork without context nodes cooperates at each move against
+its virtual opponent. The network's decision only depends on the previous outcome, so the probability
+of cooperating at the next move follows from the probability of cooperating at the current one and the
+opponent's known choice. Evaluates the network once per outcome, without drawing any random value.*/
+template<typename Network>
+ExpectedMoves Strategies::expectAssessments(const Network& player) const
+{
+	assert(MarkovGame::isMarkovian(player));
+	
+	//cooperation probability after each outcome, indexed by [player cooperated][opponent cooperated]
+	double next_cooperation[2][2];
+	typename Network::State state = player.createState(); //no context value is read or written
+	for (int player_cooperated=0; player_cooperated<2; ++player_cooperated) {
+		for (int opponent_cooperated=0; opponent_cooperated<2; ++opponent_cooperated) {
+			payoff player_payoff, opponent_payoff;
+			game_payoffs.payoffsFromChoices(player_cooperated == 1, opponent_cooperated == 1, player_payoff, opponent_payoff);
+			next_cooperation[player_cooperated][opponent_cooperated] = 
+				static_cast<double>(player.getCooperationProbability(player_payoff, opponent_payoff, state));
+		}
+	}
+	
+	ExpectedMoves player_moves;
+	for (int assessment_index=0; assessment_index<ASSESSMENT_COUNT; ++assessment_index) {
+		//Initial iteration (no input)
+		double cooperation = player() ? 1 : 0;
+		
+		for (int iteration=0; iteration<ASSESSMENT_SIZE; ++iteration) {
+			int opponent_cooperates = opponent_choices[assessment_index][iteration] ? 1 : 0;
+			player_moves[static_cast<std::size_t>(assessment_index * ASSESSMENT_SIZE + iteration)] = cooperation;
+			
+			//Subsequent iterations, after cooperating or defecting
+			cooperation = cooperation * next_cooperation[1][opponent_cooperates] 
+				+ (1 - cooperation) * next_cooperation[0][opponent_cooperates];
+		}
+	}
+	
+	return player_moves;
 }
 
 /*
 Compares the NeuralNetwork's sequence of choices to the pure strategie's.
-Returns the name of the network's closest pure strategy in terms of the least sum of squares.*/
-int Strategies::compareChoices()
+The distance to a strategy combines the fraction of different moves (hamming distance) and the
+mean squared difference of the cooperation rates per assessment. Returns the closest strategy
+(the first registered one in case of ties). The hamming distance to a stochastic strategy is the
+expected one (the probability of each move differing).*/
+int Strategies::compareChoices(const MoveSequence& player_moves) const
 {
-	double current_score; //score of similarity between player and current "pure strategy"
+	//player's average cooperation per assessment
+	std::array<double, ASSESSMENT_COUNT> player_avg_coop;
+	for (int assessment_index=0; assessment_index<ASSESSMENT_COUNT; ++assessment_index) {
+		player_avg_coop[assessment_index] = static_cast<double>((player_moves & assessment_masks[assessment_index]).count()) / ASSESSMENT_SIZE;
+	}
+	
 	double best_score = -1; //score for closest pure strategy found so far
 	int best_strat_index = -1; //index of closest pure strategy found so far
 	
-	for (int strat_index=0; strat_index<STRATEGIES_COUNT; strat_index++) {
-		//current pure strategy being compared to player's strategy
-		std::array<double, ASSESSMENT_COUNT>& current_strat = strats_avg_coop[strat_index];
-		current_score = 0;
+	for (std::size_t strat_index=0; strat_index<strats_moves.size(); strat_index++) {
+		double hamming;
+		if (strats_stochastic[strat_index]) {
+			double differences = 0;
+			for (std::size_t move=0; move<player_moves.size(); ++move) {
+				differences += player_moves[move] ? 1 - strats_expected[strat_index][move] : strats_expected[strat_index][move];
+			}
+			hamming = differences / static_cast<double>(player_moves.size());
+		} else {
+			hamming = static_cast<double>((player_moves ^ strats_moves[strat_index]).count()) / static_cast<double>(player_moves.size());
+		}
 		
-		for (int assessment_index=0; assessment_index<ASSESSMENT_COUNT; ++assessment_index) {
-			current_score += pow(current_strat[assessment_index] - player_avg_coop[assessment_index], 2);
+		double current_score = strategyDistance(strat_index, hamming, player_avg_coop);
+		if (current_score < best_score or best_score < 0) {
+			best_score = current_score;
+			best_strat_index = static_cast<int>(strat_index);
 		}
+	}
+	
+	return best_strat_index;
+}
+
+/*
+Compares the NeuralNetwork's expected choices to the pure strategie's, with the expected hamming
+distance (the probability of each move differing, the player's and the strategy's moves being
+independent) and the expected cooperation rates.*/
+int Strategies::compareExpectedChoices(const ExpectedMoves& player_moves) const
+{
+	//player's expected average cooperation per assessment
+	std::array<double, ASSESSMENT_COUNT> player_avg_coop;
+	for (int assessment_index=0; assessment_index<ASSESSMENT_COUNT; ++assessment_index) {
+		double cooperation_sum = 0;
+		for (int iteration=0; iteration<ASSESSMENT_SIZE; ++iteration) {
+			cooperation_sum += player_moves[static_cast<std::size_t>(assessment_index * ASSESSMENT_SIZE + iteration)];
+		}
+		player_avg_coop[assessment_index] = cooperation_sum / ASSESSMENT_SIZE;
+	}
+	
+	double best_score = -1; //score for closest pure strategy found so far
+	int best_strat_index = -1; //index of closest pure strategy found so far
+	
+	for (std::size_t strat_index=0; strat_index<strats_moves.size(); strat_index++) {
+		double differences = 0;
+		for (std::size_t move=0; move<player_moves.size(); ++move) {
+			double strat_cooperation = strats_expected[strat_index][move];
+			differences += player_moves[move] * (1 - strat_cooperation) + (1 - player_moves[move]) * strat_cooperation;
+		}
+		double hamming = differences / static_cast<double>(player_moves.size());
 		
+		double current_score = strategyDistance(strat_index, hamming, player_avg_coop);
 		if (current_score < best_score or best_score < 0) {
 			best_score = current_score;
-			best_strat_index = strat_index;
+			best_strat_index = static_cast<int>(strat_index);
 		}
 	}
 	
 	return best_strat_index;
-}
\ No newline at end of file
+}
+
+/*Weighted sum of the hamming distance and the mean squared difference of the cooperation rates*/
+double Strategies::strategyDistance(std::size_t strat_index, double hamming, 
+	const std::array<double, ASSESSMENT_COUNT>& player_avg_coop) const
+{
+	double rate_difference = 0;
+	for (int assessment_index=0; assessment_index<ASSESSMENT_COUNT; ++assessment_index) {
+		double difference = strats_avg_coop[strat_index][assessment_index] - player_avg_coop[assessment_index];
+		rate_difference += difference * difference;
+	}
+	
+	return STRATEGIES_HAMMING_WEIGHT * hamming + STRATEGIES_RATE_WEIGHT * rate_difference / ASSESSMENT_COUNT;
+}
+
+
+/**---------- Available precisions ----------**/
+
+template int Strategies::closestPureStrategy<NeuralNetwork>(NeuralNetwork& player) const;
+template int Strategies::closestPureStrategy<FloatNeuralNetwork>(FloatNeuralNetwork& player) const;
+template int Strategies::closestPureStrategy<FixedNeuralNetwork>(FixedNeuralNetwork& player) const;
+template int Strategies::closestPureStrategy<DenseNetwork>(DenseNetwork& player) const;
+
+template int Strategies::closestPureStrategy<NeuralNetwork>(const NeuralNetwork& player, NeuralNetwork::State& state) const;
+template int Strategies::closestPureStrategy<FloatNeuralNetwork>(const FloatNeuralNetwork& player, FloatNeuralNetwork::State& state) const;
+template int Strategies::closestPureStrategy<FixedNeuralNetwork>(const FixedNeuralNetwork& player, FixedNeuralNetwork::State& state) const;
+template int Strategies::closestPureStrategy<DenseNetwork>(const DenseNetwork& player, DenseNetwork::State& state) const;
+
+template MoveSequence Strategies::playAssessments<NeuralNetwork>(NeuralNetwork& player) const;
+template MoveSequence Strategies::playAssessments<FloatNeuralNetwork>(FloatNeuralNetwork& player) const;
+template MoveSequence Strategies::playAssessments<FixedNeuralNetwork>(FixedNeuralNetwork& player) const;
+template MoveSequence Strategies::playAssessments<DenseNetwork>(DenseNetwork& player) const;
+
+template MoveSequence Strategies::playAssessments<NeuralNetwork>(const NeuralNetwork& player, NeuralNetwork::State& state) const;
+template MoveSequence Strategies::playAssessments<FloatNeuralNetwork>(const FloatNeuralNetwork& player, FloatNeuralNetwork::State& state) const;
+template MoveSequence Strategies::playAssessments<FixedNeuralNetwork>(const FixedNeuralNetwork& player, FixedNeuralNetwork::State& state) const;
+template MoveSequence Strategies::playAssessments<DenseNetwork>(const DenseNetwork& player, DenseNetwork::State& state) const;
+
+template ExpectedMoves Strategies::expectAssessments<NeuralNetwork>(const NeuralNetwork& player) const;
+template ExpectedMoves Strategies::expectAssessments<FloatNeuralNetwork>(const FloatNeuralNetwork& player) const;
+template ExpectedMoves Strategies::expectAssessments<FixedNeuralNetwork>(const FixedNeuralNetwork& player) const;
+template ExpectedMoves Strategies::expectAssessments<DenseNetwork>(const DenseNetwork& player) const;
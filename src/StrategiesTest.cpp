@@ -22,5 +22,94 @@ void testStrategies()
 		
 	}
 	
+	///Classic strategies keep their index
+	assert(strat.getStrategyCount() == STRATEGIES_CLASSIC_COUNT);
+	assert(strat.getStrategyName(STRATEGIES_TIT_FOR_TAT) == "tit for tat");
+	assert(strat.getStrategyMoves(STRATEGIES_ALWAYS_COOPERATE).all());
+	assert(strat.getStrategyMoves(STRATEGIES_ALWAYS_DEFECT).none());
+	
+	///Extended registry: moves of related state machines
+	Strategies extended(Payoffs::getPayoffsForGameType("IPD"), Strategies::extendedStrategies());
+	assert(extended.getStrategyCount() > STRATEGIES_CLASSIC_COUNT and extended.getStrategyCount() <= STRATEGIES_MAX);
+	int grim = -1, suspicious = -1, generous = -1, hard = -1;
+	for (int strat_index=0; strat_index<extended.getStrategyCount(); ++strat_index) {
+		if (extended.getStrategyName(strat_index) == "grim trigger") grim = strat_index;
+		if (extended.getStrategyName(strat_index) == "suspicious tit for tat") suspicious = strat_index;
+		if (extended.getStrategyName(strat_index) == "generous tit for tat") generous = strat_index;
+		if (extended.getStrategyName(strat_index) == "hard tit for tat") hard = strat_index;
+	}
+	assert(grim >= 0 and suspicious >= 0 and generous >= 0 and hard >= 0);
+	
+	const MoveSequence& tit_for_tat = extended.getStrategyMoves(STRATEGIES_TIT_FOR_TAT);
+	//suspicious tit for tat only differs by the first move of each assessment
+	MoveSequence first_moves;
+	for (int assessment_index=0; assessment_index<ASSESSMENT_COUNT; ++assessment_index) {
+		first_moves.set(static_cast<std::size_t>(assessment_index * ASSESSMENT_SIZE));
+	}
+	assert((tit_for_tat ^ extended.getStrategyMoves(suspicious)) == first_moves);
+	//grim trigger and hard tit for tat never cooperate when tit for tat defects, generous tit for tat does not defect more
+	assert((extended.getStrategyMoves(grim) & ~tit_for_tat).none());
+	assert((extended.getStrategyMoves(hard) & ~tit_for_tat).none());
+	assert((tit_for_tat & ~extended.getStrategyMoves(generous)).none());
+	
+	///Stochastic strategies: cooperation probabilities instead of sampled moves
+	const ExpectedMoves& generous_moves = extended.getStrategyExpectedMoves(generous);
+	const ExpectedMoves& random_moves = extended.getStrategyExpectedMoves(extended.getStrategyCount() - 1);
+	assert(extended.getStrategyName(extended.getStrategyCount() - 1) == "random");
+	for (std::size_t move=0; move<generous_moves.size(); ++move) {
+		assert(generous_moves[move] == (tit_for_tat[move] ? 1 : STRATEGIES_GENEROSITY));
+		assert(random_moves[move] == 0.5);
+		assert(extended.getStrategyExpectedMoves(STRATEGIES_TIT_FOR_TAT)[move] == (tit_for_tat[move] ? 1 : 0));
+	}
+	//the registry draws the same random values (the virtual opponent's) with or without stochastic strategies
+	unsigned registry_seed = static_cast<unsigned>(RNG::getRandomInt(0, std::numeric_limits<int>::max()));
+	RNG::setSeed(registry_seed);
+	Strategies seeded_classic(Payoffs::getPayoffsForGameType("IPD"));
+	double classic_next_value = RNG::getRandomNumval();
+	RNG::setSeed(registry_seed);
+	Strategies seeded_extended(Payoffs::getPayoffsForGameType("IPD"), Strategies::extendedStrategies());
+	assert(RNG::getRandomNumval() == classic_next_value);
+	for (int strat_index=0; strat_index<STRATEGIES_CLASSIC_COUNT; ++strat_index) {
+		assert(seeded_extended.getStrategyMoves(strat_index) == seeded_classic.getStrategyMoves(strat_index));
+	}
+	
+	///Exact classification: expected moves of networks without context nodes
+	Strategies exact(Payoffs::getPayoffsForGameType("IPD"), Strategies::classicStrategies(), true);
+	assert(exact.isExact() and not strat.isExact());
+	int exact_networks = 0;
+	while (exact_networks < STRATEGIES_TEST_EXACT_NETWORKS) {
+		NeuralNetwork nn = NeuralNetwork();
+		if (not MarkovGame::isMarkovian(nn)) continue;
+		exact_networks++;
+		
+		ExpectedMoves expected = exact.expectAssessments(nn);
+		for (int assessment_index=0; assessment_index<ASSESSMENT_COUNT; ++assessment_index) {
+			assert(expected[static_cast<std::size_t>(assessment_index * ASSESSMENT_SIZE)] == (nn() ? 1 : 0));
+		}
+		
+		//the mean of sampled moves converges to the expected moves
+		std::array<double, ASSESSMENT_COUNT * ASSESSMENT_SIZE> sampled = {};
+		for (int play=0; play<STRATEGIES_TEST_EXACT_PLAYS; ++play) {
+			NeuralNetwork::State state = nn.createState();
+			MoveSequence moves = exact.playAssessments(nn, state);
+			for (std::size_t move=0; move<moves.size(); ++move) {
+				sampled[move] += moves[move] ? 1.0 / STRATEGIES_TEST_EXACT_PLAYS : 0;
+			}
+		}
+		for (std::size_t move=0; move<sampled.size(); ++move) {
+			assert(expected[move] >= 0 and expected[move] <= 1);
+			assert(std::fabs(sampled[move] - expected[move]) < STRATEGIES_TEST_EXACT_TOLERANCE);
+		}
+		
+		//the classification is deterministic and draws no random value
+		unsigned seed = static_cast<unsigned>(RNG::getRandomInt(0, std::numeric_limits<int>::max()));
+		RNG::setSeed(seed);
+		int first = exact.closestPureStrategy(nn);
+		double next_value = RNG::getRandomNumval();
+		RNG::setSeed(seed);
+		assert(exact.closestPureStrategy(nn) == first);
+		assert(RNG::getRandomNumval() == next_value);
+	}
+	
 	std::cout << " done!" << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "Verification.hpp"
+
+
+/*Runs a simulation without printing its results*/
+template<typename Network>
+Trajectory Verification::runTrajectory(const Payoffs& payoffs, const SimulationSettings& settings, 
+	unsigned generations, unsigned seed)
+{
+	RNG::setSeed(seed);
+	BasicSimulation<Network> sim(payoffs, settings);
+	sim.run(generations);
+	
+	Trajectory trajectory;
+	for (const std::array<double, 1>& cooperation : sim.getCooperationFrequency()) {
+		trajectory.cooperation.push_back(cooperation[0]);
+	}
+	for (const std::array<int, POPULATION_SIZE>& intelligence : sim.getPopulationIntelligence()) {
+		double total = 0;
+		for (int nodes : intelligence) total += nodes;
+		trajectory.intelligence.push_back(total / POPULATION_SIZE);
+	}
+	trajectory.strategies = sim.getStrategiesCount();
+	
+	return trajectory;
+}
+
+template<typename Network>
+std::vector<Trajectory> Verification::runReplicates(const Payoffs& payoffs, const SimulationSettings& settings,
+	unsigned generations, unsigned replicates, unsigned first_seed)
+{
+	std::vector<Trajectory> trajectories;
+	for (unsigned replicate=0; replicate<replicates; ++replicate) {
+		trajectories.push_back(runTrajectory<Network>(payoffs, settings, generations, first_seed + replicate));
+	}
+	return trajectories;
+}
+
+/*Both tests must pass: the KS test detects differences in shape, the difference bound
+(mean difference plus VERIFICATION_Z standard errors) detects a shift larger than the margin.*/
+ComparisonResult Verification::compare(const std::string& metric, const std::vector<double>& reference,
+	const std::vector<double>& candidate, double margin)
+{
+	ComparisonResult result;
+	result.metric = metric;
+	result.test = "KS";
+	result.margin = margin;
+	result.reference_mean = Statistics::mean(reference);
+	result.candidate_mean = Statistics::mean(candidate);
+	result.p_value = Statistics::ksPValue(reference, candidate);
+	
+	double standard_error = std::sqrt(Statistics::variance(reference) / static_cast<double>(reference.size())
+		+ Statistics::variance(candidate) / static_cast<double>(candidate.size()));
+	result.difference_bound = std::fabs(result.candidate_mean - result.reference_mean) + VERIFICATION_Z * standard_error;
+	
+	result.equivalent = result.p_value >= VERIFICATION_ALPHA and result.difference_bound <= margin;
+	return result;
+}
+
+/*
+Strategy counts of successive generations (and of individuals of a generation) are strongly
+correlated, so they are not independent observations. Each replicate contributes a single one:
+its dominant strategy, and the test compares how often each strategy dominates.*/
+ComparisonResult Verification::compareStrategies(const std::vector<Trajectory>& reference,
+	const std::vector<Trajectory>& candidate)
+{
+	std::vector<double> reference_counts(STRATEGIES_MAX, 0), candidate_counts(STRATEGIES_MAX, 0);
+	for (const Trajectory& trajectory : reference) {
+		reference_counts[static_cast<std::size_t>(dominantStrategy(trajectory))] += 1;
+	}
+	for (const Trajectory& trajectory : candidate) {
+		candidate_counts[static_cast<std::size_t>(dominantStrategy(trajectory))] += 1;
+	}
+	
+	ComparisonResult result;
+	result.metric = "dominant strategy";
+	result.test = "chi-squared";
+	result.p_value = Statistics::chiSquaredPValue(reference_counts, candidate_counts);
+	result.equivalent = result.p_value >= VERIFICATION_ALPHA;
+	return result;
+}
+
+std::vector<ComparisonResult> Verification::compareTrajectories(const std::vector<Trajectory>& reference,
+	const std::vector<Trajectory>& candidate)
+{
+	//summarize each replicate by the time average of its metrics
+	std::vector<double> reference_cooperation, candidate_cooperation;
+	std::vector<double> reference_intelligence, candidate_intelligence;
+	for (const Trajectory& trajectory : reference) {
+		reference_cooperation.push_back(Statistics::mean(trajectory.cooperation));
+		reference_intelligence.push_back(Statistics::mean(trajectory.intelligence));
+	}
+	for (const Trajectory& trajectory : candidate) {
+		candidate_cooperation.push_back(Statistics::mean(trajectory.cooperation));
+		candidate_intelligence.push_back(Statistics::mean(trajectory.intelligence));
+	}
+	
+	std::vector<ComparisonResult> results;
+	results.push_back(compare("cooperation", reference_cooperation, candidate_cooperation, VERIFICATION_COOPERATION_MARGIN));
+	results.push_back(compare("intelligence", reference_intelligence, candidate_intelligence, VERIFICATION_INTELLIGENCE_MARGIN));
+	results.push_back(compareStrategies(reference, candidate));
+	return results;
+}
+
+int Verification::dominantStrategy(const Trajectory& trajectory)
+{
+	StrategyCounts totals = {};
+	for (const StrategyCounts& counts : trajectory.strategies) {
+		for (std::size_t strat_index=0; strat_index<counts.size(); ++strat_index) {
+			totals[strat_index] += counts[strat_index];
+		}
+	}
+	return static_cast<int>(std::max_element(totals.begin(), totals.end()) - totals.begin());
+}
+
+/*Values are compared exactly: identical seeds and semantics must give identical results*/
+long Verification::firstDifference(const Trajectory& reference, const Trajectory& candidate)
+{
+	std::size_t generations = std::min(reference.cooperation.size(), candidate.cooperation.size());
+	for (std::size_t generation=0; generation<generations; ++generation) {
+		if (reference.cooperation[generation] != candidate.cooperation[generation]
+			or reference.intelligence[generation] != candidate.intelligence[generation]
+			or reference.strategies[generation] != candidate.strategies[generation])
+			return static_cast<long>(generation);
+	}
+	
+	if (reference.cooperation.size() != candidate.cooperation.size()) 
+		return static_cast<long>(generations);
+	return -1;
+}
+
+bool Verification::printComparison(const std::string& title, const std::vector<ComparisonResult>& results)
+{
+	bool all_equivalent = true;
+	
+	std::cout << "# " << title << std::endl;
+	for (const ComparisonResult& result : results) {
+		std::cout << "#   " << result.metric << ": ";
+		if (result.test == "KS") {
+			std::cout << "reference " << result.reference_mean 
+				<< ", candidate " << result.candidate_mean
+				<< ", |difference| <= " << result.difference_bound << " (margin " << result.margin << "), ";
+		}
+		std::cout << result.test << " p-value " << result.p_value
+			<< (result.equivalent ? " -> equivalent" : " -> DIFFERENT") << std::endl;
+		all_equivalent = all_equivalent and result.equivalent;
+	}
+	
+	return all_equivalent;
+}
+
+bool Verification::printIdentity(const std::string& title, const std::vector<Trajectory>& reference,
+	const std::vector<Trajectory>& candidate)
+{
+	assert(reference.size() == candidate.size());
+	
+	for (std::size_t replicate=0; replicate<reference.size(); ++replicate) {
+		long generation = firstDifference(reference[replicate], candidate[replicate]);
+		if (generation >= 0) {
+			std::cout << "# " << title << ": replicate " << replicate << " differs from generation " 
+				<< generation << " -> DIFFERENT" << std::endl;
+			return false;
+		}
+	}
+	
+	std::cout << "# " << title << ": " << reference.size() << " replicates -> identical" << std::endl;
+	return true;
+}
+
+
+/**---------- Available precisions ----------**/
+
+template Trajectory Verification::runTrajectory<NeuralNetwork>(const Payoffs& payoffs, const SimulationSettings& settings, 
+	unsigned generations, unsigned seed);
+template Trajectory Verification::runTrajectory<FloatNeuralNetwork>(const Payoffs& payoffs, const SimulationSettings& settings, 
+	unsigned generations, unsigned seed);
+template Trajectory Verification::runTrajectory<FixedNeuralNetwork>(const Payoffs& payoffs, const SimulationSettings& settings, 
+	unsigned generations, unsigned seed);
+template Trajectory Verification::runTrajectory<DenseNetwork>(const Payoffs& payoffs, const SimulationSettings& settings, 
+	unsigned generations, unsigned seed);
+
+template std::vector<Trajectory> Verification::runReplicates<NeuralNetwork>(const Payoffs& payoffs, 
+	const SimulationSettings& settings, unsigned generations, unsigned replicates, unsigned first_seed);
+template std::vector<Trajectory> Verification::runReplicates<FloatNeuralNetwork>(const Payoffs& payoffs, 
+	const SimulationSettings& settings, unsigned generations, unsigned replicates, unsigned first_seed);
+template std::vector<Trajectory> Verification::runReplicates<FixedNeuralNetwork>(const Payoffs& payoffs, 
+	const SimulationSettings& settings, unsigned generations, unsigned replicates, unsigned first_seed);
+template std::vector<Trajectory> Verification::runReplicates<DenseNetwork>(const Payoffs& payoffs, 
+	const SimulationSettings& settings, unsigned generations, unsigned replicates, unsigned first_seed);
@@ -1,21 +1,67 @@
 #include <iostream>
 #include <cstring>
-#include <ctime>
+#include <cstdio>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+#include <unistd.h>
 
 #include "Simulation.hpp"
+#include "Verification.hpp"
+#include "CrossEvaluation.hpp"
+#include "MutationScan.hpp"
 #include "RngTest.hpp"
 #include "StrategiesTest.hpp"
 #include "PayoffsTest.hpp"
 #include "NeuralNetworkTest.hpp"
+#include "MarkovGameTest.hpp"
+#include "AssessmentPipelineTest.hpp"
+#include "LineageTest.hpp"
+#include "MonitorTest.hpp"
+#include "StatisticsTest.hpp"
+#include "AggregatorTest.hpp"
+#include "MutationTest.hpp"
+#include "GenomeArchiveTest.hpp"
+#include "DenseNetworkTest.hpp"
+#include "SimulationTest.hpp"
+#include "SteadyStateTest.hpp"
+#include "ProfilerTest.hpp"
+#include "MetricsTest.hpp"
+#include "FitnessTreeTest.hpp"
+#include "ShardTest.hpp"
+#include "CrossEvaluationTest.hpp"
+#include "MutationScanTest.hpp"
+#include "AutotunerTest.hpp"
+#include "FitnessEstimatorTest.hpp"
+
+/*Precisions of the network values*/
+#define PRECISION_DOUBLE 0
+#define PRECISION_FLOAT 1
+#define PRECISION_FIXED 2
+#define PRECISION_DENSE 3 //DenseNetwork (float values, large networks)
 
 void runTests(unsigned test_rounds);
-void runSimulation(unsigned sim_rounds, std::string game_type);
+template<typename Network>
+void runSimulation(unsigned sim_rounds, std::string game_type, const SimulationSettings& settings, unsigned replicates);
+bool parseOption(const std::string& option, SimulationSettings& settings, int& precision, unsigned& replicates);
+int aggregateOutputs(int file_count, char** file_names);
+int inspectArchive(std::string archive_file, int argc, char** argv);
+int crossEvaluate(std::string archive_file, std::string game_type, int argc, char** argv);
+int scanMutants(std::string archive_file, std::string game_type, unsigned long generation, unsigned individual, int argc, char** argv);
+int checkEquivalence(unsigned sim_rounds, std::string game_type, unsigned replicates, unsigned first_seed);
+int verifyEngines(unsigned sim_rounds, std::string game_type, unsigned replicates, unsigned first_seed);
+int watchSimulation(std::string monitor_name, unsigned interval_ms);
 
 unsigned strtou(const char* unsigned_str) {
 	char* end;
 	return static_cast<unsigned>(strtoul(unsigned_str, &end, 10));
 }
 
+unsigned long long strtou64(const char* unsigned_str) {
+	char* end;
+	return strtoull(unsigned_str, &end, 10);
+}
+
 int main(int argc, char** argv)
 {
 	//no arguments
@@ -35,12 +81,113 @@ int main(int argc, char** argv)
 		runTests(test_rounds);
 	}
 	//run application
-	else if (std::string(argv[1]) == "run" and argc <= 5) {
-		//set the RNG seed from argument if provided
-		if (argc == 5) RNG::setSeed(strtou(argv[4]));
+	else if (std::string(argv[1]) == "run" and argc >= 4) {
+		SimulationSettings settings;
+		int precision = PRECISION_DOUBLE;
+		unsigned replicates = 0; //no aggregation
+		
+		for (int arg_index=4; arg_index<argc; ++arg_index) {
+			std::string arg(argv[arg_index]);
+			
+			//options start with "--"
+			if (arg.compare(0, 2, "--") == 0) {
+				if (not parseOption(arg, settings, precision, replicates)) {
+					std::cerr << "Error: unknown option " << arg << std::endl;
+					return 1;
+				}
+			}
+			//set the RNG seed from argument if provided
+			else if (arg_index == 4) {
+				RNG::setSeed(strtou(argv[arg_index]));
+			}
+			else {
+				std::cerr << "Error: unknown options" << std::endl;
+				return 1;
+			}
+		}
 		
 		//run the simulation
-		runSimulation(strtou(argv[2]), std::string(argv[3]));		
+		try {
+			if (precision == PRECISION_FLOAT)
+				runSimulation<FloatNeuralNetwork>(strtou(argv[2]), std::string(argv[3]), settings, replicates);
+			else if (precision == PRECISION_FIXED)
+				runSimulation<FixedNeuralNetwork>(strtou(argv[2]), std::string(argv[3]), settings, replicates);
+			else if (precision == PRECISION_DENSE)
+				runSimulation<DenseNetwork>(strtou(argv[2]), std::string(argv[3]), settings, replicates);
+			else
+				runSimulation<NeuralNetwork>(strtou(argv[2]), std::string(argv[3]), settings, replicates);
+		}
+		catch (const std::exception& error) {
+			std::cerr << "Error: " << error.what() << std::endl;
+			return 1;
+		}
+	}
+	//watch a running simulation
+	else if (std::string(argv[1]) == "watch" and (argc == 3 or argc == 4)) {
+		//refresh interval in milliseconds
+		unsigned interval_ms = (argc == 4) ? strtou(argv[3]) : 1000;
+		
+		return watchSimulation(std::string(argv[2]), interval_ms);
+	}
+	//summarize the outputs of several simulations
+	else if (std::string(argv[1]) == "aggregate" and argc >= 3) {
+		return aggregateOutputs(argc - 2, argv + 2);
+	}
+	//list the contents of a genome archive
+	else if (std::string(argv[1]) == "archive" and argc >= 3 and argc <= 5) {
+		try {
+			return inspectArchive(std::string(argv[2]), argc - 3, argv + 3);
+		}
+		catch (const std::exception& error) {
+			std::cerr << "Error: " << error.what() << std::endl;
+			return 1;
+		}
+	}
+	//play archived generations against each other
+	else if (std::string(argv[1]) == "cross" and argc >= 6) {
+		try {
+			return crossEvaluate(std::string(argv[2]), std::string(argv[3]), argc - 4, argv + 4);
+		}
+		catch (const std::exception& error) {
+			std::cerr << "Error: " << error.what() << std::endl;
+			return 1;
+		}
+	}
+	//fitness effects of the mutants of an archived individual
+	else if (std::string(argv[1]) == "scan" and argc >= 6) {
+		try {
+			return scanMutants(std::string(argv[2]), std::string(argv[3]), strtou(argv[4]), strtou(argv[5]), argc - 6, argv + 6);
+		}
+		catch (const std::exception& error) {
+			std::cerr << "Error: " << error.what() << std::endl;
+			return 1;
+		}
+	}
+	//compare the trajectories of every precision
+	else if (std::string(argv[1]) == "equivalence" and (argc == 5 or argc == 6)) {
+		//seed of the first replicate
+		unsigned first_seed = (argc == 6) ? strtou(argv[5]) : 1;
+		
+		try {
+			return checkEquivalence(strtou(argv[2]), std::string(argv[3]), strtou(argv[4]), first_seed);
+		}
+		catch (const std::exception& error) {
+			std::cerr << "Error: " << error.what() << std::endl;
+			return 1;
+		}
+	}
+	//compare the optional engines with the reference simulation
+	else if (std::string(argv[1]) == "verify" and (argc == 5 or argc == 6)) {
+		//seed of the first replicate
+		unsigned first_seed = (argc == 6) ? strtou(argv[5]) : 1;
+		
+		try {
+			return verifyEngines(strtou(argv[2]), std::string(argv[3]), strtou(argv[4]), first_seed);
+		}
+		catch (const std::exception& error) {
+			std::cerr << "Error: " << error.what() << std::endl;
+			return 1;
+		}
 	}
 	//unknown arguments
 	else {
@@ -61,19 +208,148 @@ void runTests(unsigned test_rounds)
 		testPayoffs();
 		testStrategies();
 		testNeuralNetwork();
+		testMarkovGame();
+		testAssessmentPipeline();
+		testLineage();
+		testMonitor();
+		testStatistics();
+		testAggregator();
+		testMutation();
+		testGenomeArchive();
+		testDenseNetwork();
+		testSimulation();
+		testSteadyState();
+		testProfiler();
+		testMetrics();
+		testFitnessTree();
+		testShard();
+		testCrossEvaluation();
+		testMutationScan();
+		testAutotuner();
+		testFitnessEstimator();
 	}
 	
 	std::cout << "All tests passed!" << std::endl;
 }
 
-void runSimulation(unsigned sim_rounds, std::string game_type)
+/*Sets the simulation mode corresponding to the option, returns false if the option is unknown*/
+bool parseOption(const std::string& option, SimulationSettings& settings, int& precision, unsigned& replicates)
 {
+	//options are either "--name" or "--name=value"
+	std::size_t separator = option.find('=');
+	std::string name = option.substr(0, separator);
+	std::string value = (separator == std::string::npos) ? "" : option.substr(separator + 1);
+	
+	if (name == "--exact" and value.empty()) 
+		settings.exact_payoffs = true;
+	else if (name == "--pipeline" and not value.empty())
+		settings.pipeline_workers = strtou(value.c_str());
+	else if (name == "--threads" and strtou(value.c_str()) > 0)
+		settings.tournament_threads = strtou(value.c_str());
+	else if (name == "--threads" and value == "auto") {
+		settings.tournament_threads = std::max(std::thread::hardware_concurrency(), 1u);
+		settings.autotune = true;
+	}
+	else if (name == "--autotune-cache" and not value.empty())
+		settings.autotune_cache = value;
+	else if (name == "--shards" and strtou(value.c_str()) > 0)
+		settings.shards = strtou(value.c_str());
+	else if (name == "--shard-transport" and (value == "socket" or value == "shm"))
+		settings.shard_transport = value;
+	else if (name == "--steady-window" and strtou(value.c_str()) > 1)
+		settings.steady_window = strtou(value.c_str());
+	else if (name == "--steady" and (value == "stop" or value == "fast-forward"))
+		settings.steady_action = (value == "stop") ? STEADY_ACTION_STOP : STEADY_ACTION_FAST_FORWARD;
+	else if (name == "--metrics" and not value.empty())
+		settings.metrics = value;
+	else if (name == "--moran" and value.empty())
+		settings.moran = true;
+	else if (name == "--variance-reduction" and value.empty())
+		settings.variance_reduction = true;
+	else if (name == "--pair-matches" and strtou(value.c_str()) > 0)
+		settings.pair_matches = strtou(value.c_str());
+	else if (name == "--profile" and value.empty())
+		settings.profile = true;
+	else if (name == "--lineage" and not value.empty())
+		settings.lineage_file = value;
+	else if (name == "--lineage-interval" and not value.empty())
+		settings.lineage_interval = strtou(value.c_str());
+	else if (name == "--monitor" and not value.empty())
+		settings.monitor_name = value;
+	else if (name == "--precision" and value == "double")
+		precision = PRECISION_DOUBLE;
+	else if (name == "--precision" and value == "float")
+		precision = PRECISION_FLOAT;
+	else if (name == "--precision" and value == "fixed")
+		precision = PRECISION_FIXED;
+	else if (name == "--precision" and value == "dense")
+		precision = PRECISION_DENSE;
+	else if (name == "--dense-nodes" and not value.empty() and strtou(value.c_str()) <= DENSE_MAX_NODES)
+		DenseNetwork::setInitialNodeCount(static_cast<int>(strtou(value.c_str())));
+	else if (name == "--archive" and not value.empty())
+		settings.archive_file = value;
+	else if (name == "--archive-every" and strtou(value.c_str()) > 0)
+		settings.archive_interval = strtou(value.c_str());
+	else if (name == "--strategies" and (value == "classic" or value == "extended"))
+		settings.extended_strategies = (value == "extended");
+	else if (name == "--exact-strategies" and value.empty())
+		settings.exact_strategies = true;
+	else if (name == "--mutation" and not value.empty())
+		return settings.mutation_rates.parse(value);
+	else if (name == "--replicates" and not value.empty())
+		replicates = strtou(value.c_str());
+	else 
+		return false;
+	
+	return true;
+}
+
+template<typename Network>
+void runSimulation(unsigned sim_rounds, std::string game_type, const SimulationSettings& settings, unsigned replicates)
+{
+	//replicates are summarized from the classic outputs
+	if (replicates > 0 and not settings.metrics.empty())
+		throw std::runtime_error("metrics cannot be summarized over replicates");
+	
 	//get payoffs to use during simulation
 	const Payoffs sim_payoffs = Payoffs::getPayoffsForGameType(game_type);
 	
 	//output simulation details
 	std::cout << "# Game: " << game_type << std::endl;
 	std::cout << "# Rounds: " << sim_rounds << std::endl;
+	std::cout << "# Precision: " << Network::precisionName() << std::endl;
+	if (settings.exact_payoffs) std::cout << "# Payoffs: exact expectation for pairs without context nodes" << std::endl;
+	if (settings.moran) std::cout << "# Evolution: Moran process (" << POPULATION_SIZE << " birth-death events per generation)" << std::endl;
+	if (settings.variance_reduction) 
+		std::cout << "# Fitness: variance reduced (common random numbers, antithetic lengths, " << settings.pair_matches 
+			<< " units per pair" << (settings.pair_matches > 2 ? ", control variate" : "") 
+			<< (settings.pair_matches < 2 ? ", no variance with a single unit" : "") << ")" << std::endl;
+	if (settings.pipeline_workers > 0) std::cout << "# Pipeline workers: " << settings.pipeline_workers << std::endl;
+	if (settings.tournament_threads > 0 and settings.autotune) 
+		std::cout << "# Tournament threads: autotuned up to " << settings.tournament_threads << " (independent matches, cached in " 
+			<< (settings.autotune_cache.empty() ? Autotuner::defaultCacheFile() : settings.autotune_cache) << ")" << std::endl;
+	else if (settings.tournament_threads > 0) 
+		std::cout << "# Tournament threads: " << settings.tournament_threads << " (independent matches)" << std::endl;
+	if (settings.shards > 0) 
+		std::cout << "# Shards: " << settings.shards << " worker processes (" << settings.shard_transport << ")" << std::endl;
+	if (settings.steady_window > 0) 
+		std::cout << "# Steady state: " << (settings.steady_action == STEADY_ACTION_STOP ? "stop" : "fast-forward") 
+			<< " after " << settings.steady_window << " steady generations" << std::endl;
+	if (not settings.metrics.empty()) std::cout << "# Metrics: " << settings.metrics << std::endl;
+	if (settings.profile) std::cout << "# Profile: hardware counters per phase" << std::endl;
+	if (not settings.lineage_file.empty()) std::cout << "# Lineage file: " << settings.lineage_file << std::endl;
+	if (not settings.monitor_name.empty()) std::cout << "# Monitor: " << settings.monitor_name << std::endl;
+	if (not settings.archive_file.empty()) 
+		std::cout << "# Archive: " << settings.archive_file << " (every " << settings.archive_interval << " generations)" << std::endl;
+	for (int parameter_class=0; parameter_class<PARAMETER_CLASS_COUNT; ++parameter_class) {
+		if (settings.mutation_rates.rates[parameter_class] != MutationRates().rates[parameter_class])
+			std::cout << "# Mutation rate (" << MutationRates::className(parameter_class) << "): " 
+				<< settings.mutation_rates.rates[parameter_class] << std::endl;
+	}
+	if (settings.extended_strategies) std::cout << "# Strategies: extended registry" << std::endl;
+	if (settings.exact_strategies) 
+		std::cout << "# Strategies: exact expectation for networks without context nodes" << std::endl;
+	if (replicates > 0) std::cout << "# Replicates: " << replicates << " (consecutive seeds, summary only)" << std::endl;
 	
 	//output the RNG seed and its randomness for future reference
 	std::cout << "# RNG seed: " << RNG::getSeed();
@@ -82,12 +358,406 @@ void runSimulation(unsigned sim_rounds, std::string game_type)
 	else
 		std::cout << " (provided)" << std::endl << std::endl;
 	
-	//run and time the simulation
-	time_t sim_start = clock();
+	//run and time the simulation (wall clock, the simulation may use several threads)
+	std::chrono::steady_clock::time_point sim_start = std::chrono::steady_clock::now();
+	
+	if (replicates == 0) {
+		BasicSimulation<Network> sim(sim_payoffs, settings);
+		sim.run(sim_rounds);
+		sim.outputResults();
+	}
+	//each replicate is added to the summary as soon as it ends, then discarded
+	else {
+		Aggregator aggregator;
+		unsigned long long first_seed = RNG::getSeed();
+		for (unsigned replicate=0; replicate<replicates; ++replicate) {
+			RNG::setSeed(first_seed + replicate);
+			BasicSimulation<Network> sim(sim_payoffs, settings);
+			sim.run(sim_rounds);
+			sim.aggregateResults(aggregator);
+		}
+		aggregator.write(std::cout);
+	}
+	
+	std::chrono::duration<double> sim_time = std::chrono::steady_clock::now() - sim_start;
+	std::cout << "# Simulation time: " << sim_time.count() << std::endl;
+}
+
+/*Summarizes the outputs of several simulations in one pass, one file at a time*/
+int aggregateOutputs(int file_count, char** file_names)
+{
+	Aggregator aggregator;
+	
+	try {
+		for (int file_index=0; file_index<file_count; ++file_index) {
+			aggregator.readFile(std::string(file_names[file_index]));
+		}
+	}
+	catch (const std::exception& error) {
+		std::cerr << "Error: " << error.what() << std::endl;
+		return 1;
+	}
+	
+	aggregator.write(std::cout);
+	return 0;
+}
+
+/*Prints one line per individual of an archived generation*/
+template<typename Network>
+void printArchivedGeneration(const GenomeArchiveReader& reader, std::size_t snapshot, long individual)
+{
+	unsigned first = (individual >= 0) ? static_cast<unsigned>(individual) : 0;
+	unsigned last = (individual >= 0) ? first + 1 : reader.getIndividualCount(snapshot);
+	
+	std::cout << "# individual, cognitive nodes, context nodes, hash" << std::endl;
+	for (unsigned index=first; index<last; ++index) {
+		Network* network = reader.loadIndividual<Network>(snapshot, index);
+		std::cout << index << " " << network->getCognitiveNodeCount() << " " << network->getContextNodeCount() 
+			<< " " << std::hex << network->hash() << std::dec << std::endl;
+		delete network;
+	}
+}
+
+/*Lists the archived generations, or the individuals of a generation (optionally a single one)*/
+int inspectArchive(std::string archive_file, int argc, char** argv)
+{
+	GenomeArchiveReader reader(archive_file);
+	const ArchiveHeader& header = reader.getHeader();
+	
+	std::cout << "# Archive: " << archive_file << (reader.isComplete() ? "" : " (no index, interrupted run)") << std::endl;
+	std::cout << "# Precision: " << header.precision << std::endl;
+	std::cout << "# RNG seed: " << header.seed << std::endl;
+	std::cout << "# Snapshots: " << reader.getSnapshotCount() << " (every " << header.interval << " generations)" << std::endl;
+	
+	if (argc == 0) {
+		std::cout << "# generation, individuals" << std::endl;
+		for (std::size_t snapshot=0; snapshot<reader.getSnapshotCount(); ++snapshot) {
+			std::cout << reader.getGeneration(snapshot) << " " << reader.getIndividualCount(snapshot) << std::endl;
+		}
+		return 0;
+	}
+	
+	long snapshot = reader.findSnapshot(strtou(argv[0]));
+	if (snapshot < 0) {
+		std::cerr << "Error: generation " << argv[0] << " is not archived" << std::endl;
+		return 1;
+	}
+	long individual = (argc == 2) ? static_cast<long>(strtou(argv[1])) : -1;
+	
+	std::string precision(header.precision);
+	if (precision == FloatNeuralNetwork::precisionName())
+		printArchivedGeneration<FloatNeuralNetwork>(reader, static_cast<std::size_t>(snapshot), individual);
+	else if (precision == FixedNeuralNetwork::precisionName())
+		printArchivedGeneration<FixedNeuralNetwork>(reader, static_cast<std::size_t>(snapshot), individual);
+	else if (precision == DenseNetwork::precisionName())
+		printArchivedGeneration<DenseNetwork>(reader, static_cast<std::size_t>(snapshot), individual);
+	else
+		printArchivedGeneration<NeuralNetwork>(reader, static_cast<std::size_t>(snapshot), individual);
+	return 0;
+}
+
+/*Plays every pair of archived generations (and each generation against itself), writes the payoff matrices*/
+template<typename Network>
+void writeCrossEvaluation(const GenomeArchiveReader& reader, const Payoffs& game_payoffs, 
+	const std::vector<unsigned long>& generations, const PairingPlan& plan, unsigned threads)
+{
+	CrossEvaluation<Network> evaluation(game_payoffs, threads);
+	for (unsigned long generation : generations) {
+		evaluation.addArchivedGeneration(reader, generation);
+	}
+	evaluation.evaluate(plan);
+	evaluation.write(std::cout);
+}
+
+/*
+Plays the individuals of several archived generations against each other, with the options 
+--sample=pairs (random pairs per pair of generations), --matches=count (per pair), --threads=count 
+and --seed=seed (the archive's seed by default).*/
+int crossEvaluate(std::string archive_file, std::string game_type, int argc, char** argv)
+{
+	const Payoffs game_payoffs = Payoffs::getPayoffsForGameType(game_type);
+	GenomeArchiveReader reader(archive_file);
+	const ArchiveHeader& header = reader.getHeader();
+	
+	std::vector<unsigned long> generations;
+	PairingPlan plan;
+	unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+	unsigned long long seed = header.seed;
+	
+	for (int arg_index=0; arg_index<argc; ++arg_index) {
+		std::string arg(argv[arg_index]);
+		std::size_t separator = arg.find('=');
+		std::string name = arg.substr(0, separator);
+		std::string value = (separator == std::string::npos) ? "" : arg.substr(separator + 1);
+		
+		if (arg.compare(0, 2, "--") != 0)
+			generations.push_back(strtou(argv[arg_index]));
+		else if (name == "--sample" and strtou(value.c_str()) > 0)
+			plan.sampled_pairs = strtou(value.c_str());
+		else if (name == "--matches" and strtou(value.c_str()) > 0)
+			plan.matches = strtou(value.c_str());
+		else if (name == "--threads" and strtou(value.c_str()) > 0)
+			threads = strtou(value.c_str());
+		else if (name == "--seed" and not value.empty())
+			seed = strtou64(value.c_str());
+		else {
+			std::cerr << "Error: unknown option " << arg << std::endl;
+			return 1;
+		}
+	}
+	if (generations.size() < 2) {
+		std::cerr << "Error: at least two generations are needed" << std::endl;
+		return 1;
+	}
+	RNG::setSeed(seed);
+	
+	std::cout << "# Archive: " << archive_file << std::endl;
+	std::cout << "# Game: " << game_type << std::endl;
+	std::cout << "# Pairs: ";
+	if (plan.sampled_pairs > 0) std::cout << plan.sampled_pairs << " random pairs per pair of generations";
+	else std::cout << "every pair";
+	std::cout << std::endl;
+	std::cout << "# Matches per pair: " << plan.matches << std::endl;
+	std::cout << "# Threads: " << threads << std::endl;
+	std::cout << "# RNG seed: " << seed << std::endl;
+	
+	std::string precision(header.precision);
+	if (precision == FloatNeuralNetwork::precisionName())
+		writeCrossEvaluation<FloatNeuralNetwork>(reader, game_payoffs, generations, plan, threads);
+	else if (precision == FixedNeuralNetwork::precisionName())
+		writeCrossEvaluation<FixedNeuralNetwork>(reader, game_payoffs, generations, plan, threads);
+	else if (precision == DenseNetwork::precisionName())
+		writeCrossEvaluation<DenseNetwork>(reader, game_payoffs, generations, plan, threads);
+	else
+		writeCrossEvaluation<NeuralNetwork>(reader, game_payoffs, generations, plan, threads);
+	return 0;
+}
+
+/*Scans the mutants of an archived individual against the rest of its generation, writes their fitness effects*/
+template<typename Network>
+void writeMutationScan(const GenomeArchiveReader& reader, const Payoffs& game_payoffs, std::size_t snapshot, 
+	unsigned individual, unsigned mutants_per_type, const MutationRates& rates, const PairingPlan& plan, unsigned threads)
+{
+	std::unique_ptr<Network> focal(reader.loadIndividual<Network>(snapshot, individual));
+	std::vector<std::unique_ptr<Network>> residents; //the rest of its generation
+	for (unsigned resident=0; resident<reader.getIndividualCount(snapshot); ++resident) {
+		if (resident != individual) residents.emplace_back(reader.loadIndividual<Network>(snapshot, resident));
+	}
+	
+	MutationScan<Network> scan(game_payoffs, threads, rates);
+	scan.scan(*focal, std::move(residents), mutants_per_type, plan);
+	scan.write(std::cout);
+}
+
+/*
+Plays mutants of an archived individual against the rest of its generation, with the options 
+--mutants=count (per mutation type), --mutation=class:rate,... (rates of the whole mutations, as with run),
+--matches=count (per pair), --threads=count and --seed=seed (the archive's seed by default).*/
+int scanMutants(std::string archive_file, std::string game_type, unsigned long generation, unsigned individual, int argc, char** argv)
+{
+	const Payoffs game_payoffs = Payoffs::getPayoffsForGameType(game_type);
+	GenomeArchiveReader reader(archive_file);
+	const ArchiveHeader& header = reader.getHeader();
+	
+	unsigned mutants_per_type = SCAN_DEFAULT_MUTANTS;
+	MutationRates rates;
+	PairingPlan plan;
+	unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+	unsigned long long seed = header.seed;
+	
+	for (int arg_index=0; arg_index<argc; ++arg_index) {
+		std::string arg(argv[arg_index]);
+		std::size_t separator = arg.find('=');
+		std::string name = arg.substr(0, separator);
+		std::string value = (separator == std::string::npos) ? "" : arg.substr(separator + 1);
+		
+		if (name == "--mutants" and strtou(value.c_str()) > 0)
+			mutants_per_type = strtou(value.c_str());
+		else if (name == "--mutation" and not value.empty()) {
+			if (not rates.parse(value)) {
+				std::cerr << "Error: invalid mutation rates " << value << std::endl;
+				return 1;
+			}
+		}
+		else if (name == "--matches" and strtou(value.c_str()) > 0)
+			plan.matches = strtou(value.c_str());
+		else if (name == "--threads" and strtou(value.c_str()) > 0)
+			threads = strtou(value.c_str());
+		else if (name == "--seed" and not value.empty())
+			seed = strtou64(value.c_str());
+		else {
+			std::cerr << "Error: unknown option " << arg << std::endl;
+			return 1;
+		}
+	}
+	
+	long snapshot = reader.findSnapshot(generation);
+	if (snapshot < 0) {
+		std::cerr << "Error: generation " << generation << " is not archived" << std::endl;
+		return 1;
+	}
+	if (individual >= reader.getIndividualCount(static_cast<std::size_t>(snapshot))) {
+		std::cerr << "Error: generation " << generation << " has no individual " << individual << std::endl;
+		return 1;
+	}
+	RNG::setSeed(seed);
+	
+	std::cout << "# Archive: " << archive_file << std::endl;
+	std::cout << "# Game: " << game_type << std::endl;
+	std::cout << "# Focal individual: " << individual << " of generation " << generation << std::endl;
+	std::cout << "# Mutants per type: " << mutants_per_type << std::endl;
+	for (int parameter_class=0; parameter_class<PARAMETER_CLASS_COUNT; ++parameter_class) {
+		if (rates.rates[parameter_class] != MutationRates().rates[parameter_class])
+			std::cout << "# Mutation rate (" << MutationRates::className(parameter_class) << "): " 
+				<< rates.rates[parameter_class] << std::endl;
+	}
+	std::cout << "# Matches per pair: " << plan.matches << std::endl;
+	std::cout << "# Threads: " << threads << std::endl;
+	std::cout << "# RNG seed: " << seed << std::endl;
+	
+	std::string precision(header.precision);
+	std::size_t snapshot_index = static_cast<std::size_t>(snapshot);
+	if (precision == FloatNeuralNetwork::precisionName())
+		writeMutationScan<FloatNeuralNetwork>(reader, game_payoffs, snapshot_index, individual, mutants_per_type, rates, plan, threads);
+	else if (precision == FixedNeuralNetwork::precisionName())
+		writeMutationScan<FixedNeuralNetwork>(reader, game_payoffs, snapshot_index, individual, mutants_per_type, rates, plan, threads);
+	else if (precision == DenseNetwork::precisionName())
+		writeMutationScan<DenseNetwork>(reader, game_payoffs, snapshot_index, individual, mutants_per_type, rates, plan, threads);
+	else
+		writeMutationScan<NeuralNetwork>(reader, game_payoffs, snapshot_index, individual, mutants_per_type, rates, plan, threads);
+	return 0;
+}
+
+/*Runs replicates of the simulation in every precision and checks that the reduced precisions
+produce trajectories statistically equivalent to double precision. Returns 0 if they do.*/
+int checkEquivalence(unsigned sim_rounds, std::string game_type, unsigned replicates, unsigned first_seed)
+{
+	const Payoffs sim_payoffs = Payoffs::getPayoffsForGameType(game_type);
+	const SimulationSettings settings;
+	
+	std::cout << "# Game: " << game_type << std::endl;
+	std::cout << "# Rounds: " << sim_rounds << std::endl;
+	std::cout << "# Replicates: " << replicates << " (seeds " << first_seed << " to " << first_seed + replicates - 1 << ")" << std::endl;
+	
+	std::vector<Trajectory> reference = Verification::runReplicates<NeuralNetwork>(sim_payoffs, settings, sim_rounds, replicates, first_seed);
+	std::vector<Trajectory> float_runs = Verification::runReplicates<FloatNeuralNetwork>(sim_payoffs, settings, sim_rounds, replicates, first_seed);
+	std::vector<Trajectory> fixed_runs = Verification::runReplicates<FixedNeuralNetwork>(sim_payoffs, settings, sim_rounds, replicates, first_seed);
+	
+	bool float_equivalent = Verification::printComparison("float vs double", Verification::compareTrajectories(reference, float_runs));
+	bool fixed_equivalent = Verification::printComparison("fixed vs double", Verification::compareTrajectories(reference, fixed_runs));
+	
+	return (float_equivalent and fixed_equivalent) ? 0 : 1;
+}
+
+/*
+Differential check of the optional engines against the reference simulation (double precision,
+sequential classification, sampled payoffs), with the same seeds.
+Options that must not change the results are checked for identity: repeating a run, the number of
+pipeline workers, tournament threads (with or without variance reduction) or shards, and recording the lineage and archive. Options that change
+the random streams or the arithmetic are checked for statistical equivalence. Returns 0 if every check passes.*/
+int verifyEngines(unsigned sim_rounds, std::string game_type, unsigned replicates, unsigned first_seed)
+{
+	const Payoffs sim_payoffs = Payoffs::getPayoffsForGameType(game_type);
+	const SimulationSettings reference_settings;
+	
+	std::cout << "# Game: " << game_type << std::endl;
+	std::cout << "# Rounds: " << sim_rounds << std::endl;
+	std::cout << "# Replicates: " << replicates << " (seeds " << first_seed << " to " << first_seed + replicates - 1 << ")" << std::endl;
+	
+	std::vector<Trajectory> reference = Verification::runReplicates<NeuralNetwork>(sim_payoffs, reference_settings, sim_rounds, replicates, first_seed);
+	bool passed = true;
+	
+	///Exact checks
+	std::vector<Trajectory> repeated = Verification::runReplicates<NeuralNetwork>(sim_payoffs, reference_settings, sim_rounds, replicates, first_seed);
+	passed = Verification::printIdentity("repeated run", reference, repeated) and passed;
+	
+	SimulationSettings recorded_settings;
+	recorded_settings.lineage_file = VERIFICATION_LINEAGE_PREFIX + std::to_string(getpid()) + ".txt";
+	recorded_settings.archive_file = VERIFICATION_ARCHIVE_PREFIX + std::to_string(getpid()) + ".bin";
+	std::vector<Trajectory> recorded = Verification::runReplicates<NeuralNetwork>(sim_payoffs, recorded_settings, sim_rounds, replicates, first_seed);
+	std::remove(recorded_settings.lineage_file.c_str());
+	std::remove(recorded_settings.archive_file.c_str());
+	passed = Verification::printIdentity("lineage and archive recording", reference, recorded) and passed;
+	
+	SimulationSettings pipeline_settings, workers_settings;
+	pipeline_settings.pipeline_workers = 1;
+	workers_settings.pipeline_workers = VERIFICATION_PIPELINE_WORKERS;
+	std::vector<Trajectory> pipeline = Verification::runReplicates<NeuralNetwork>(sim_payoffs, pipeline_settings, sim_rounds, replicates, first_seed);
+	std::vector<Trajectory> workers = Verification::runReplicates<NeuralNetwork>(sim_payoffs, workers_settings, sim_rounds, replicates, first_seed);
+	passed = Verification::printIdentity("pipeline with " + std::to_string(VERIFICATION_PIPELINE_WORKERS) + " workers vs 1", pipeline, workers) and passed;
 	
-	Simulation sim(sim_payoffs);
-	sim.run(sim_rounds);
+	SimulationSettings independent_settings, threads_settings;
+	independent_settings.tournament_threads = 1;
+	threads_settings.tournament_threads = VERIFICATION_TOURNAMENT_THREADS;
+	std::vector<Trajectory> independent = Verification::runReplicates<NeuralNetwork>(sim_payoffs, independent_settings, sim_rounds, replicates, first_seed);
+	std::vector<Trajectory> threads = Verification::runReplicates<NeuralNetwork>(sim_payoffs, threads_settings, sim_rounds, replicates, first_seed);
+	passed = Verification::printIdentity("tournament with " + std::to_string(VERIFICATION_TOURNAMENT_THREADS) + " threads vs 1", independent, threads) and passed;
+	
+	SimulationSettings shard_settings, shards_settings;
+	shard_settings.shards = 1;
+	shards_settings.shards = VERIFICATION_SHARDS;
+	shards_settings.shard_transport = "shm";
+	std::vector<Trajectory> shard = Verification::runReplicates<NeuralNetwork>(sim_payoffs, shard_settings, sim_rounds, replicates, first_seed);
+	std::vector<Trajectory> shards = Verification::runReplicates<NeuralNetwork>(sim_payoffs, shards_settings, sim_rounds, replicates, first_seed);
+	passed = Verification::printIdentity("tournament with " + std::to_string(VERIFICATION_SHARDS) + " shards vs 1", shard, shards) and passed;
+	
+	SimulationSettings reduced_settings, reduced_threads_settings;
+	reduced_settings.variance_reduction = reduced_threads_settings.variance_reduction = true;
+	reduced_settings.pair_matches = reduced_threads_settings.pair_matches = VERIFICATION_PAIR_MATCHES;
+	reduced_threads_settings.tournament_threads = VERIFICATION_TOURNAMENT_THREADS;
+	std::vector<Trajectory> reduced = Verification::runReplicates<NeuralNetwork>(sim_payoffs, reduced_settings, sim_rounds, replicates, first_seed);
+	std::vector<Trajectory> reduced_threads = Verification::runReplicates<NeuralNetwork>(sim_payoffs, reduced_threads_settings, sim_rounds, replicates, first_seed);
+	passed = Verification::printIdentity("variance reduction with " + std::to_string(VERIFICATION_TOURNAMENT_THREADS) + " threads vs 1", 
+		reduced, reduced_threads) and passed;
+	
+	///Statistical checks
+	passed = Verification::printComparison("pipeline vs sequential classification", Verification::compareTrajectories(reference, pipeline)) and passed;
+	
+	passed = Verification::printComparison("independent vs carryover matches", Verification::compareTrajectories(reference, independent)) and passed;
+	
+	SimulationSettings exact_settings;
+	exact_settings.exact_payoffs = true;
+	std::vector<Trajectory> exact = Verification::runReplicates<NeuralNetwork>(sim_payoffs, exact_settings, sim_rounds, replicates, first_seed);
+	passed = Verification::printComparison("exact vs sampled payoffs", Verification::compareTrajectories(reference, exact)) and passed;
+	
+	std::vector<Trajectory> float_runs = Verification::runReplicates<FloatNeuralNetwork>(sim_payoffs, reference_settings, sim_rounds, replicates, first_seed);
+	passed = Verification::printComparison("float vs double", Verification::compareTrajectories(reference, float_runs)) and passed;
+	
+	std::vector<Trajectory> fixed_runs = Verification::runReplicates<FixedNeuralNetwork>(sim_payoffs, reference_settings, sim_rounds, replicates, first_seed);
+	passed = Verification::printComparison("fixed vs double", Verification::compareTrajectories(reference, fixed_runs)) and passed;
+	
+	std::vector<Trajectory> dense_runs = Verification::runReplicates<DenseNetwork>(sim_payoffs, reference_settings, sim_rounds, replicates, first_seed);
+	passed = Verification::printComparison("dense batched matches vs reference", Verification::compareTrajectories(reference, dense_runs)) and passed;
+	
+	std::cout << "# Verification " << (passed ? "passed" : "FAILED") << std::endl;
+	return passed ? 0 : 1;
+}
+
+/*Prints the live stats of a running simulation until it finishes or disappears*/
+int watchSimulation(std::string monitor_name, unsigned interval_ms)
+{
+	MonitorReader reader(monitor_name);
+	MonitorStats stats;
+	
+	while (reader.read(stats)) {
+		std::cout << "generation " << stats.generation << "/" << stats.total_generations
+			<< " | cooperation " << stats.cooperation_frequency
+			<< " | intelligence " << stats.mean_intelligence
+			<< " | fitness " << stats.mean_fitness
+			<< " | " << stats.generations_per_second << " gen/s";
+		
+		if (stats.strategies_generation >= 0) {
+			std::cout << " | strategies (gen " << stats.strategies_generation << ")";
+			for (int strat_index=0; strat_index<stats.strategy_count; ++strat_index) {
+				std::cout << " " << stats.strategies[strat_index];
+			}
+		}
+		std::cout << std::endl;
+		
+		if (stats.finished) return 0;
+		std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+	}
 	
-	time_t sim_end = clock();
-	std::cout << "# Simulation time: " << static_cast<double>(sim_end - sim_start)/CLOCKS_PER_SEC << std::endl;
+	std::cerr << "Error: no running simulation named " << monitor_name << std::endl;
+	return 1;
 }